@@ -0,0 +1,124 @@
+#include <stdlib.h>
+#include <new>
+#include <chrono>
+#include "ActorMetrics.h"
+
+std::mutex ActorMetrics::_mutex;
+std::vector<std::string> ActorMetrics::_names;
+std::vector<ActorMetrics::MetricType> ActorMetrics::_types;
+std::vector<ThreadMetricBlock*> ActorMetrics::_blocks;
+uint64_t ActorMetrics::_retired[gc_actorMetricMaxCount];
+uint64_t ActorMetrics::_lastRateTotal[gc_actorMetricMaxCount];
+int64_t ActorMetrics::_lastCollectMsec = 0;
+std::atomic<int64_t> ActorMetrics::_gauges[gc_actorMetricMaxCount];
+thread_local ThreadMetricBlock* ActorMetrics::_threadBlock = NULL;
+
+struct ThreadMetricBlockHolder
+{
+	ThreadMetricBlock* block;
+
+	ThreadMetricBlockHolder(): block(NULL) {}
+	~ThreadMetricBlockHolder()
+	{
+		if (block)
+			ActorMetrics::retireThreadBlock(block);
+	}
+};
+
+static thread_local ThreadMetricBlockHolder gc_threadBlockHolder;
+
+static int64_t steadyMsec()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int ActorMetrics::registerMetric(const std::string& name, MetricType type)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	for (size_t i = 0; i < _names.size(); i++)
+		if (_names[i] == name)
+			return (_types[i] == type) ? (int)i : -1;
+
+	if (_names.size() >= (size_t)gc_actorMetricMaxCount)
+		return -1;
+
+	_names.push_back(name);
+	_types.push_back(type);
+	return (int)(_names.size() - 1);
+}
+
+ThreadMetricBlock* ActorMetrics::createThreadBlock()
+{
+	void* memory = NULL;
+	if (posix_memalign(&memory, alignof(ThreadMetricBlock), sizeof(ThreadMetricBlock)) != 0)
+		throw std::bad_alloc();
+
+	ThreadMetricBlock* block = new (memory) ThreadMetricBlock();
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		_blocks.push_back(block);
+	}
+
+	_threadBlock = block;
+	gc_threadBlockHolder.block = block;
+	return block;
+}
+
+void ActorMetrics::retireThreadBlock(ThreadMetricBlock* block)
+{
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		for (size_t i = 0; i < _blocks.size(); i++)
+		{
+			if (_blocks[i] == block)
+			{
+				_blocks[i] = _blocks.back();
+				_blocks.pop_back();
+				break;
+			}
+		}
+
+		for (int i = 0; i < gc_actorMetricMaxCount; i++)
+			_retired[i] += block->values[i].load(std::memory_order_relaxed);
+	}
+
+	_threadBlock = NULL;
+	block->~ThreadMetricBlock();
+	free(block);
+}
+
+bool ActorMetrics::empty()
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	return _names.empty();
+}
+
+void ActorMetrics::collect(ActorMetricsSnapshot& snapshot)
+{
+	int64_t now = steadyMsec();
+
+	std::unique_lock<std::mutex> lck(_mutex);
+	double intervalSec = _lastCollectMsec ? (now - _lastCollectMsec) / 1000.0 : 0.0;
+	_lastCollectMsec = now;
+
+	for (size_t i = 0; i < _names.size(); i++)
+	{
+		if (_types[i] == Gauge)
+		{
+			snapshot.gauges[_names[i]] = _gauges[i].load(std::memory_order_relaxed);
+			continue;
+		}
+
+		uint64_t total = _retired[i];
+		for (ThreadMetricBlock* block: _blocks)
+			total += block->values[i].load(std::memory_order_relaxed);
+
+		if (_types[i] == Counter)
+			snapshot.counters[_names[i]] = total;
+		else
+		{
+			snapshot.rates[_names[i]] = (intervalSec > 0) ? (total - _lastRateTotal[i]) / intervalSec : 0.0;
+			_lastRateTotal[i] = total;
+		}
+	}
+}
@@ -0,0 +1,114 @@
+#ifndef Actor_Metrics_h
+#define Actor_Metrics_h
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <map>
+
+/*
+	Actor metrics: counters, gauges and rates.
+
+		MetricCounter sent = ActorMetrics::counter("sent");		//-- register once, e.g. in ExecutiveActor::globalInit().
+		sent.inc();			//-- hot path: one relaxed load and store on current thread's own cache lines.
+
+	Counters and rates are recorded into per-thread blocks, and aggregated by the actor's background thread.
+	Rate is a counter which reported as per second increment.
+	Gauge is a global value, last set wins.
+*/
+
+const int gc_actorMetricMaxCount = 256;
+
+struct alignas(64) ThreadMetricBlock
+{
+	std::atomic<uint64_t> values[gc_actorMetricMaxCount];
+
+	ThreadMetricBlock()
+	{
+		for (int i = 0; i < gc_actorMetricMaxCount; i++)
+			values[i].store(0, std::memory_order_relaxed);
+	}
+};
+
+struct ActorMetricsSnapshot
+{
+	std::map<std::string, uint64_t> counters;
+	std::map<std::string, int64_t> gauges;
+	std::map<std::string, double> rates;
+};
+
+class ActorMetrics
+{
+public:
+	enum MetricType
+	{
+		Counter,
+		Gauge,
+		Rate,
+	};
+
+private:
+	static std::mutex _mutex;
+	static std::vector<std::string> _names;
+	static std::vector<MetricType> _types;
+	static std::vector<ThreadMetricBlock*> _blocks;
+	static uint64_t _retired[gc_actorMetricMaxCount];		//-- values from exited threads.
+	static uint64_t _lastRateTotal[gc_actorMetricMaxCount];
+	static int64_t _lastCollectMsec;
+	static std::atomic<int64_t> _gauges[gc_actorMetricMaxCount];
+
+	static thread_local ThreadMetricBlock* _threadBlock;
+
+	static int registerMetric(const std::string& name, MetricType type);
+	static ThreadMetricBlock* createThreadBlock();
+
+public:
+	static inline ThreadMetricBlock* threadBlock()
+	{
+		return _threadBlock ? _threadBlock : createThreadBlock();
+	}
+	static void retireThreadBlock(ThreadMetricBlock* block);
+
+	//-- return -1 if metric name conflicts with other type or no more metric slots.
+	static int counter(const std::string& name) { return registerMetric(name, Counter); }
+	static int gauge(const std::string& name) { return registerMetric(name, Gauge); }
+	static int rate(const std::string& name) { return registerMetric(name, Rate); }
+
+	static inline void add(int metricId, uint64_t value)
+	{
+		std::atomic<uint64_t>& slot = threadBlock()->values[metricId];
+		slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+	static inline void set(int metricId, int64_t value)
+	{
+		_gauges[metricId].store(value, std::memory_order_relaxed);
+	}
+
+	static bool empty();
+	static void collect(ActorMetricsSnapshot& snapshot);
+};
+
+class MetricCounter
+{
+	int _id;
+
+public:
+	MetricCounter(int id): _id(id) {}
+	inline void inc() { if (_id >= 0) ActorMetrics::add(_id, 1); }
+	inline void add(uint64_t value) { if (_id >= 0) ActorMetrics::add(_id, value); }
+};
+
+class MetricGauge
+{
+	int _id;
+
+public:
+	MetricGauge(int id): _id(id) {}
+	inline void set(int64_t value) { if (_id >= 0) ActorMetrics::set(_id, value); }
+};
+
+typedef MetricCounter MetricRate;
+
+#endif
@@ -5,6 +5,8 @@
 #include "CommandLineUtil.h"
 #include "TCPClient.h"
 #include "IQuestProcessor.h"
+#include "ActorMetrics.h"
+#include "TelemetryChannel.h"
 #include "ExecutiveActor.h"
 
 using namespace std;
@@ -54,10 +56,17 @@ class Actor
 	bool _taskChanged;
 	std::map<int, std::vector<std::string>> _taskMap;
 
+	std::atomic<bool> _running;
+	int _metricsIntervalSec;
+	std::thread _metricsThread;
+	TelemetryChannel _telemetry;
+
 	bool registerActor();
+	void metricsCycle();
+	void pushMetrics();
 
 public:
-	Actor(): _taskChanged(false) {}
+	Actor(): _taskChanged(false), _running(false), _metricsIntervalSec(0) {}
 
 	bool init()
 	{
@@ -80,6 +89,15 @@ public:
 
 		_actor.setRegion(_region);
 		_client->setQuestProcessor(std::make_shared<ActorQuestProcessor>(&_actor));
+
+		int flushMsec = (int)CommandLineParser::getInt("telemetryFlushMsec", 200);
+		_telemetry.start(_client, _region, flushMsec, 256 * 1024);
+
+		_running = true;
+		_metricsIntervalSec = (int)CommandLineParser::getInt("metricsInterval", 5);
+		if (_metricsIntervalSec > 0)
+			_metricsThread = std::thread(&Actor::metricsCycle, this);
+
 		return true;
 	}
 
@@ -113,6 +131,11 @@ public:
 
 	~Actor()
 	{
+		_running = false;
+		if (_metricsThread.joinable())
+			_metricsThread.join();
+
+		_telemetry.stop();
 		_client = nullptr;
 	}
 
@@ -141,6 +164,11 @@ public:
 	{
 		return _client->sendQuest(quest, std::move(task), timeout);
 	}
+
+	void report(int taskId, bool result, const std::string& payload)
+	{
+		_telemetry.append(taskId, result, payload);
+	}
 };
 
 bool Actor::registerActor()
@@ -164,6 +192,51 @@ bool Actor::registerActor()
 	});
 }
 
+void Actor::metricsCycle()
+{
+	int ticket = 0;
+	while (_running)
+	{
+		sleep(1);
+		ticket += 1;
+
+		if (ticket >= _metricsIntervalSec)
+		{
+			ticket = 0;
+			pushMetrics();
+		}
+	}
+}
+
+void Actor::pushMetrics()
+{
+	if (ActorMetrics::empty())
+		return;
+
+	std::set<int> taskIds;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		for (auto& pp: _taskMap)
+			taskIds.insert(pp.first);
+	}
+
+	ActorMetricsSnapshot snapshot;
+	ActorMetrics::collect(snapshot);
+
+	if (taskIds.empty())
+		return;
+
+	FPWriter pw(4);
+	pw.param("type", "actorMetrics");
+	pw.param("counters", snapshot.counters);
+	pw.param("gauges", snapshot.gauges);
+	pw.param("rates", snapshot.rates);
+	std::string payload = pw.raw();
+
+	for (int taskId: taskIds)
+		_telemetry.append(taskId, false, payload);
+}
+
 Actor gc_Actor;
 
 void ControlCenter::beginTask(int taskId, const std::string& method, const std::string& desc)
@@ -175,6 +248,15 @@ void ControlCenter::finishTask(int taskId)
 	gc_Actor.finishTask(taskId);
 }
 
+void ControlCenter::reportStatus(int taskId, const std::string& payload)
+{
+	gc_Actor.report(taskId, false, payload);
+}
+void ControlCenter::reportResult(int taskId, const std::string& payload)
+{
+	gc_Actor.report(taskId, true, payload);
+}
+
 FPAnswerPtr ControlCenter::sendQuest(FPQuestPtr quest, int timeout)
 {
 	return gc_Actor.sendQuest(quest, timeout);
@@ -191,8 +273,8 @@ bool ControlCenter::sendQuest(FPQuestPtr quest, std::function<void (FPAnswerPtr
 int showUsage(const char* appName)
 {
 	cout<<"Usage:"<<endl;
-	cout<<"\t"<<appName<<" endpoint"<<ExecutiveActor::customParamsUsage()<<endl;
-	cout<<"\t"<<appName<<" host port"<<ExecutiveActor::customParamsUsage()<<endl;
+	cout<<"\t"<<appName<<" endpoint [--metricsInterval seconds] [--telemetryFlushMsec msec]"<<ExecutiveActor::customParamsUsage()<<endl;
+	cout<<"\t"<<appName<<" host port [--metricsInterval seconds] [--telemetryFlushMsec msec]"<<ExecutiveActor::customParamsUsage()<<endl;
 	return -1;
 }
 
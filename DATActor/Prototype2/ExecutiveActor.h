@@ -7,6 +7,8 @@ using namespace fpnn;
 
 /*
 	Class ControlCenter is assistant class. Just use it directly.
+	For hot send loops, build quests by QuestTemplate (QuestTemplate.h) or QuestCorpus (QuestCorpus.h).
+	For counters and gauges, use ActorMetrics (ActorMetrics.h). They are pushed to all running tasks as status records.
 */
 class ControlCenter
 {
@@ -14,6 +16,10 @@ public:
 	static void beginTask(int taskId, const std::string& method, const std::string& desc);
 	static void finishTask(int taskId);
 
+	//-- Batched actorStatus/actorResult. Prefer them to sending actorStatus/actorResult quests directly.
+	static void reportStatus(int taskId, const std::string& payload);
+	static void reportResult(int taskId, const std::string& payload);
+
 	static FPAnswerPtr sendQuest(FPQuestPtr quest, int timeout = 0);
 	static bool sendQuest(FPQuestPtr quest, AnswerCallback* callback, int timeout = 0);
 	static bool sendQuest(FPQuestPtr quest, std::function<void (FPAnswerPtr answer, int errorCode)> task, int timeout = 0);
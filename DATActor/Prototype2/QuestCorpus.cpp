@@ -0,0 +1,224 @@
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <iostream>
+#include <algorithm>
+#include "QuestCorpus.h"
+
+using namespace std;
+using namespace QuestCorpusFormat;
+
+void CorpusPatch::setInt(int slotIdx, int64_t value)
+{
+	_values.push_back(SlotValue());
+	_values.back().slotIdx = slotIdx;
+	_values.back().intValue = value;
+}
+
+void CorpusPatch::setDouble(int slotIdx, double value)
+{
+	_values.push_back(SlotValue());
+	_values.back().slotIdx = slotIdx;
+	_values.back().doubleValue = value;
+}
+
+void CorpusPatch::setString(int slotIdx, const std::string& value)
+{
+	_values.push_back(SlotValue());
+	_values.back().slotIdx = slotIdx;
+	_values.back().stringValue = value;
+}
+
+static uint64_t threadRandom()
+{
+	static thread_local uint64_t seed = 0;
+	if (seed == 0)
+		seed = ((uint64_t)time(NULL) << 20) ^ (uint64_t)&seed ^ (uint64_t)pthread_self();
+
+	//-- xorshift64*
+	seed ^= seed >> 12;
+	seed ^= seed << 25;
+	seed ^= seed >> 27;
+	return seed * 2685821657736338717ULL;
+}
+
+bool QuestCorpus::load(const std::string& path)
+{
+	unload();
+
+	_fd = open(path.c_str(), O_RDONLY);
+	if (_fd == -1)
+	{
+		cout<<"[Error] Open quest corpus "<<path<<" failed."<<endl;
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(_fd, &st) != 0 || (size_t)st.st_size < sizeof(CorpusFileHeader))
+	{
+		cout<<"[Error] Quest corpus "<<path<<" is invalid."<<endl;
+		unload();
+		return false;
+	}
+
+	_fileSize = (size_t)st.st_size;
+	void* addr = mmap(NULL, _fileSize, PROT_READ, MAP_SHARED, _fd, 0);
+	if (addr == MAP_FAILED)
+	{
+		cout<<"[Error] Map quest corpus "<<path<<" failed."<<endl;
+		unload();
+		return false;
+	}
+
+	_base = (const char*)addr;
+	_header = (const CorpusFileHeader*)_base;
+
+	if (!verify())
+	{
+		cout<<"[Error] Quest corpus "<<path<<" is broken or version mismatched."<<endl;
+		unload();
+		return false;
+	}
+
+	madvise(addr, _fileSize, MADV_WILLNEED);
+
+	_records = (const CorpusRecordIndex*)(_base + _header->recordIndexOffset);
+	_slots = (const CorpusSlot*)(_base + _header->slotOffset);
+
+	const CorpusSlotName* slotNames = (const CorpusSlotName*)(_base + _header->slotNameOffset);
+	for (uint32_t i = 0; i < _header->slotNameCount; i++)
+		_slotNames.push_back(std::string(_base + slotNames[i].offset, slotNames[i].length));
+
+	uint64_t weightSum = 0;
+	for (uint32_t i = 0; i < _header->recordCount; i++)
+	{
+		_methods.push_back(std::string(_base + _records[i].methodOffset, _records[i].methodLength));
+
+		weightSum += _records[i].weight;
+		_weightBoundary.push_back(weightSum);
+	}
+
+	return true;
+}
+
+bool QuestCorpus::verify()
+{
+	if (memcmp(_header->magic, magic, sizeof(magic)) != 0 || _header->version != version)
+		return false;
+
+	if (_header->recordCount == 0)
+		return false;
+
+	if (_header->recordIndexOffset + (uint64_t)_header->recordCount * sizeof(CorpusRecordIndex) > _fileSize
+		|| _header->slotOffset + (uint64_t)_header->slotCount * sizeof(CorpusSlot) > _fileSize
+		|| _header->slotNameOffset + (uint64_t)_header->slotNameCount * sizeof(CorpusSlotName) > _fileSize)
+		return false;
+
+	const CorpusRecordIndex* records = (const CorpusRecordIndex*)(_base + _header->recordIndexOffset);
+	const CorpusSlot* slots = (const CorpusSlot*)(_base + _header->slotOffset);
+	for (uint32_t i = 0; i < _header->recordCount; i++)
+	{
+		const CorpusRecordIndex& record = records[i];
+		if (record.payloadOffset + record.payloadLength > _fileSize
+			|| record.methodOffset + record.methodLength > _fileSize
+			|| (uint64_t)record.slotBegin + record.slotCount > _header->slotCount)
+			return false;
+
+		for (uint32_t k = record.slotBegin; k < record.slotBegin + record.slotCount; k++)
+			if (slots[k].payloadPos + slotEncodedLength(slots[k].type, slots[k].width) > record.payloadLength
+				|| slots[k].nameIdx >= _header->slotNameCount)
+				return false;
+	}
+
+	const CorpusSlotName* slotNames = (const CorpusSlotName*)(_base + _header->slotNameOffset);
+	for (uint32_t i = 0; i < _header->slotNameCount; i++)
+		if (slotNames[i].offset + slotNames[i].length > _fileSize)
+			return false;
+
+	return true;
+}
+
+void QuestCorpus::unload()
+{
+	if (_base)
+		munmap((void*)_base, _fileSize);
+
+	if (_fd != -1)
+		close(_fd);
+
+	_fd = -1;
+	_fileSize = 0;
+	_base = NULL;
+	_header = NULL;
+	_records = NULL;
+	_slots = NULL;
+	_methods.clear();
+	_slotNames.clear();
+	_weightBoundary.clear();
+}
+
+int QuestCorpus::slotIndex(const std::string& name) const
+{
+	for (size_t i = 0; i < _slotNames.size(); i++)
+		if (_slotNames[i] == name)
+			return (int)i;
+
+	return -1;
+}
+
+size_t QuestCorpus::select(SelectMode mode)
+{
+	size_t recordCount = count();
+	if (recordCount == 0)
+		return 0;
+
+	if (mode == RoundRobin)
+		return (size_t)(_roundRobin++ % recordCount);
+
+	if (mode == Random || _weightBoundary.back() == 0)
+		return (size_t)(threadRandom() % recordCount);
+
+	uint64_t point = threadRandom() % _weightBoundary.back();
+	return (size_t)(std::upper_bound(_weightBoundary.begin(), _weightBoundary.end(), point) - _weightBoundary.begin());
+}
+
+void QuestCorpus::applyPatch(size_t idx, char* payload, const CorpusPatch& patch) const
+{
+	const CorpusRecordIndex& record = _records[idx];
+	for (auto& value: patch._values)
+	{
+		for (uint32_t k = record.slotBegin; k < record.slotBegin + record.slotCount; k++)
+		{
+			const CorpusSlot& slot = _slots[k];
+			if (slot.nameIdx != value.slotIdx)
+				continue;
+
+			if (slot.type == IntSlot)
+				encodeIntSlot(payload + slot.payloadPos, value.intValue);
+			else if (slot.type == DoubleSlot)
+				encodeDoubleSlot(payload + slot.payloadPos, value.doubleValue);
+			else
+				encodeStringSlot(payload + slot.payloadPos, slot.width, value.stringValue.data(), value.stringValue.length());
+			break;
+		}
+	}
+}
+
+FPQuestPtr QuestCorpus::quest(size_t idx, bool oneway) const
+{
+	const CorpusRecordIndex& record = _records[idx];
+	std::string payload(_base + record.payloadOffset, record.payloadLength);
+	return std::make_shared<FPQuest>(_methods[idx], payload, oneway);
+}
+
+FPQuestPtr QuestCorpus::quest(size_t idx, const CorpusPatch& patch, bool oneway) const
+{
+	const CorpusRecordIndex& record = _records[idx];
+	std::string payload(_base + record.payloadOffset, record.payloadLength);
+	applyPatch(idx, &payload[0], patch);
+	return std::make_shared<FPQuest>(_methods[idx], payload, oneway);
+}
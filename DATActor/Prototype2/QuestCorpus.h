@@ -0,0 +1,82 @@
+#ifndef Quest_Corpus_h
+#define Quest_Corpus_h
+
+#include <atomic>
+#include "FPMessage.h"
+#include "../../DATQuestCorpus.h"
+
+using namespace fpnn;
+
+/*
+	Slot values for one send. Slot index is fetched by QuestCorpus::slotIndex() once, then reused.
+*/
+class CorpusPatch
+{
+	friend class QuestCorpus;
+
+	struct SlotValue
+	{
+		int slotIdx;
+		int64_t intValue;
+		double doubleValue;
+		std::string stringValue;
+	};
+	std::vector<SlotValue> _values;
+
+public:
+	void clear() { _values.clear(); }
+	void setInt(int slotIdx, int64_t value);
+	void setDouble(int slotIdx, double value);
+	void setString(int slotIdx, const std::string& value);
+};
+
+/*
+	Memory-mapped pre-encoded quests. Build corpus file by DATCorpusBuilder, distribute it as an actor.
+	After load(), all methods are thread-safe.
+	When not loaded (load() failed or not called), count() is 0 and next() returns nullptr.
+*/
+class QuestCorpus
+{
+public:
+	enum SelectMode
+	{
+		RoundRobin,
+		Random,
+		Weighted,
+	};
+
+private:
+	int _fd;
+	size_t _fileSize;
+	const char* _base;
+	const QuestCorpusFormat::CorpusFileHeader* _header;
+	const QuestCorpusFormat::CorpusRecordIndex* _records;
+	const QuestCorpusFormat::CorpusSlot* _slots;
+	std::vector<std::string> _methods;
+	std::vector<std::string> _slotNames;
+	std::vector<uint64_t> _weightBoundary;		//-- prefix sums of record weights.
+	std::atomic<uint64_t> _roundRobin;
+
+	bool verify();
+	void unload();
+	void applyPatch(size_t idx, char* payload, const CorpusPatch& patch) const;
+
+public:
+	QuestCorpus(): _fd(-1), _fileSize(0), _base(NULL), _header(NULL), _records(NULL), _slots(NULL), _roundRobin(0) {}
+	~QuestCorpus() { unload(); }
+
+	bool load(const std::string& path);
+	size_t count() const { return _header ? _header->recordCount : 0; }
+	int slotIndex(const std::string& name) const;		//-- return -1 if slot not exist.
+
+	//-- Only for a loaded corpus. Returns 0 when not loaded.
+	size_t select(SelectMode mode);
+	const std::string& method(size_t idx) const { return _methods[idx]; }
+	FPQuestPtr quest(size_t idx, bool oneway = false) const;
+	FPQuestPtr quest(size_t idx, const CorpusPatch& patch, bool oneway = false) const;
+
+	FPQuestPtr next(SelectMode mode, bool oneway = false) { return count() ? quest(select(mode), oneway) : nullptr; }
+	FPQuestPtr next(SelectMode mode, const CorpusPatch& patch, bool oneway = false) { return count() ? quest(select(mode), patch, oneway) : nullptr; }
+};
+
+#endif
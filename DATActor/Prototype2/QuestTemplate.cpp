@@ -0,0 +1,101 @@
+#include "QuestTemplate.h"
+
+using namespace QuestCorpusFormat;
+
+QuestTemplate::QuestTemplate(size_t paramCount, const std::string& method, bool oneway):
+	_method(method), _oneway(oneway), _packer(_sbuf)
+{
+	_packer.pack_map((uint32_t)paramCount);
+}
+
+QuestTemplate& QuestTemplate::paramBinary(const std::string& name, const void* data, size_t length)
+{
+	_packer.pack(name);
+	_packer.pack_bin((uint32_t)length);
+	_packer.pack_bin_body((const char*)data, (uint32_t)length);
+	return *this;
+}
+
+int QuestTemplate::addSlot(const std::string& name, uint8_t type, uint8_t width, const char* value, int64_t intValue, double doubleValue)
+{
+	_packer.pack(name);
+
+	char buf[2 + 255];
+	if (type == IntSlot)
+		encodeIntSlot(buf, intValue);
+	else if (type == DoubleSlot)
+		encodeDoubleSlot(buf, doubleValue);
+	else
+		encodeStringSlot(buf, width, value, strlen(value));
+
+	CorpusSlot slot;
+	slot.payloadPos = (uint32_t)_sbuf.size();
+	slot.nameIdx = (uint16_t)_slots.size();
+	slot.type = type;
+	slot.width = width;
+	_slots.push_back(slot);
+
+	_sbuf.write(buf, slotEncodedLength(type, width));
+	return (int)slot.nameIdx;
+}
+
+int QuestTemplate::intSlot(const std::string& name, int64_t defaultValue)
+{
+	return addSlot(name, IntSlot, 0, NULL, defaultValue, 0.0);
+}
+
+int QuestTemplate::doubleSlot(const std::string& name, double defaultValue)
+{
+	return addSlot(name, DoubleSlot, 0, NULL, 0, defaultValue);
+}
+
+int QuestTemplate::stringSlot(const std::string& name, uint8_t width, const std::string& defaultValue)
+{
+	return addSlot(name, StringSlot, width, defaultValue.c_str(), 0, 0.0);
+}
+
+QuestTemplate::Filler::Filler(const QuestTemplate& tpl): _template(tpl),
+	_payload(tpl._sbuf.data(), tpl._sbuf.size())
+{
+}
+
+QuestTemplate::Filler& QuestTemplate::Filler::setInt(int slotId, int64_t value)
+{
+	const CorpusSlot& slot = _template._slots[slotId];
+	if (slot.type == IntSlot)
+		encodeIntSlot(&_payload[slot.payloadPos], value);
+	else if (slot.type == DoubleSlot)
+		encodeDoubleSlot(&_payload[slot.payloadPos], (double)value);
+
+	return *this;
+}
+
+QuestTemplate::Filler& QuestTemplate::Filler::setDouble(int slotId, double value)
+{
+	const CorpusSlot& slot = _template._slots[slotId];
+	if (slot.type == DoubleSlot)
+		encodeDoubleSlot(&_payload[slot.payloadPos], value);
+	else if (slot.type == IntSlot)
+		encodeIntSlot(&_payload[slot.payloadPos], (int64_t)value);
+
+	return *this;
+}
+
+QuestTemplate::Filler& QuestTemplate::Filler::setString(int slotId, const char* value, size_t length)
+{
+	const CorpusSlot& slot = _template._slots[slotId];
+	if (slot.type == StringSlot)
+		encodeStringSlot(&_payload[slot.payloadPos], slot.width, value, length);
+
+	return *this;
+}
+
+QuestTemplate::Filler& QuestTemplate::Filler::setString(int slotId, const std::string& value)
+{
+	return setString(slotId, value.data(), value.length());
+}
+
+FPQuestPtr QuestTemplate::Filler::take()
+{
+	return std::make_shared<FPQuest>(_template._method, _payload, _template._oneway);
+}
@@ -0,0 +1,73 @@
+#ifndef Quest_Template_h
+#define Quest_Template_h
+
+#include "msgpack.hpp"
+#include "FPMessage.h"
+#include "../../DATQuestCorpus.h"
+
+using namespace fpnn;
+
+/*
+	Quest encoded once, sent many times.
+
+	Fixed params are encoded when the template is built. Slot params are encoded in fixed width,
+	and patched directly in the msgpack buffer per send:
+
+		QuestTemplate tpl(3, "query");
+		tpl.param("table", "users");
+		int uidSlot = tpl.intSlot("uid");
+		int nameSlot = tpl.stringSlot("name", 16);
+
+		FPQuestPtr quest = tpl.fill().setInt(uidSlot, uid).setString(nameSlot, name).take();
+		ControlCenter::sendQuest(quest, callback);		//-- or any TCPClient::sendQuest().
+
+	Template building is not thread-safe. After built, fill() can be called from any threads.
+*/
+class QuestTemplate
+{
+	std::string _method;
+	bool _oneway;
+	msgpack::sbuffer _sbuf;
+	msgpack::packer<msgpack::sbuffer> _packer;
+	std::vector<QuestCorpusFormat::CorpusSlot> _slots;
+
+	int addSlot(const std::string& name, uint8_t type, uint8_t width, const char* value, int64_t intValue, double doubleValue);
+
+public:
+	class Filler
+	{
+		const QuestTemplate& _template;
+		std::string _payload;
+
+	public:
+		Filler(const QuestTemplate& tpl);
+
+		Filler& setInt(int slotId, int64_t value);
+		Filler& setDouble(int slotId, double value);
+		Filler& setString(int slotId, const std::string& value);
+		Filler& setString(int slotId, const char* value, size_t length);
+
+		FPQuestPtr take();
+	};
+
+	QuestTemplate(size_t paramCount, const std::string& method, bool oneway = false);
+
+	template<typename VALUE>
+	QuestTemplate& param(const std::string& name, const VALUE& value)
+	{
+		_packer.pack(name);
+		_packer.pack(value);
+		return *this;
+	}
+	QuestTemplate& paramBinary(const std::string& name, const void* data, size_t length);
+
+	//-- Return slot id.
+	int intSlot(const std::string& name, int64_t defaultValue = 0);
+	int doubleSlot(const std::string& name, double defaultValue = 0.0);
+	int stringSlot(const std::string& name, uint8_t width, const std::string& defaultValue = std::string());
+
+	Filler fill() const { return Filler(*this); }
+	FPQuestPtr take() const { return Filler(*this).take(); }		//-- quest with default slot values.
+};
+
+#endif
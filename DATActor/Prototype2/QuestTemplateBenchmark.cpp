@@ -0,0 +1,126 @@
+#include <iostream>
+#include <chrono>
+#include "FPWriter.h"
+#include "QuestTemplate.h"
+#include "QuestCorpus.h"
+
+using namespace std;
+using namespace fpnn;
+
+/*
+	Compare per-request quest building cost:
+		FPQWriter:      encode all params per request.
+		QuestTemplate:  copy pre-encoded payload, patch slots.
+		QuestCorpus:    (optional) copy pre-encoded payload from mapped corpus, patch slots.
+*/
+
+const std::string gc_tableName("user_profile");
+const std::string gc_fields("uid,name,level,score,lastLogin");
+
+int64_t nowNsec()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void showResult(const char* title, int count, int64_t costNsec, size_t payloadSize)
+{
+	cout<<title<<": "<<count<<" quests, "<<(costNsec / 1000000)<<" ms, "<<((double)costNsec / count)<<" ns/quest, payload "<<payloadSize<<" bytes"<<endl;
+}
+
+int64_t benchmarkQWriter(int count, size_t& payloadSize)
+{
+	int64_t begin = nowNsec();
+	for (int i = 0; i < count; i++)
+	{
+		FPQWriter qw(6, "query");
+		qw.param("table", gc_tableName);
+		qw.param("fields", gc_fields);
+		qw.param("limit", 20);
+		qw.param("uid", (int64_t)i);
+		qw.param("ts", (int64_t)(begin + i));
+		qw.param("session", "0123456789abcdef");
+
+		FPQuestPtr quest = qw.take();
+		payloadSize = quest->payload().size();
+	}
+	return nowNsec() - begin;
+}
+
+int64_t benchmarkTemplate(int count, size_t& payloadSize)
+{
+	QuestTemplate tpl(6, "query");
+	tpl.param("table", gc_tableName);
+	tpl.param("fields", gc_fields);
+	tpl.param("limit", 20);
+	int uidSlot = tpl.intSlot("uid");
+	int tsSlot = tpl.intSlot("ts");
+	int sessionSlot = tpl.stringSlot("session", 16);
+
+	const std::string session("0123456789abcdef");
+
+	int64_t begin = nowNsec();
+	for (int i = 0; i < count; i++)
+	{
+		FPQuestPtr quest = tpl.fill().setInt(uidSlot, i).setInt(tsSlot, begin + i).setString(sessionSlot, session).take();
+		payloadSize = quest->payload().size();
+	}
+	return nowNsec() - begin;
+}
+
+int64_t benchmarkCorpus(const char* path, int count, size_t& payloadSize)
+{
+	QuestCorpus corpus;
+	if (!corpus.load(path))
+		return -1;
+
+	int uidSlot = corpus.slotIndex("uid");
+	int tsSlot = corpus.slotIndex("ts");
+
+	CorpusPatch patch;
+	int64_t begin = nowNsec();
+	for (int i = 0; i < count; i++)
+	{
+		patch.clear();
+		patch.setInt(uidSlot, i);
+		patch.setInt(tsSlot, begin + i);
+
+		FPQuestPtr quest = corpus.next(QuestCorpus::RoundRobin, patch);
+		payloadSize = quest->payload().size();
+	}
+	return nowNsec() - begin;
+}
+
+int main(int argc, const char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		cout<<"Usage: "<<argv[0]<<" count [corpus-file]"<<endl;
+		return 0;
+	}
+
+	int count = atoi(argv[1]);
+	if (count <= 0)
+		count = 1000000;
+
+	size_t payloadSize = 0;
+
+	int64_t cost = benchmarkQWriter(count, payloadSize);
+	showResult("FPQWriter    ", count, cost, payloadSize);
+	int64_t baseCost = cost;
+
+	cost = benchmarkTemplate(count, payloadSize);
+	showResult("QuestTemplate", count, cost, payloadSize);
+	cout<<"QuestTemplate speed up: "<<((double)baseCost / cost)<<"x"<<endl;
+
+	if (argc == 3)
+	{
+		cost = benchmarkCorpus(argv[2], count, payloadSize);
+		if (cost > 0)
+		{
+			showResult("QuestCorpus  ", count, cost, payloadSize);
+			cout<<"QuestCorpus speed up: "<<((double)baseCost / cost)<<"x"<<endl;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,202 @@
+#include <iostream>
+#include <map>
+#include <chrono>
+#include <zlib.h>
+#include "TelemetryChannel.h"
+
+using namespace std;
+
+const size_t gc_telemetryCompressThreshold = 1024;
+
+void TelemetryChannel::start(TCPClientPtr client, const std::string& region, int flushMsec, size_t maxBatchBytes)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	if (_running)
+		return;
+
+	_client = client;
+	_region = region;
+	_flushMsec = (flushMsec > 0) ? flushMsec : 200;
+	_maxBatchBytes = maxBatchBytes ? maxBatchBytes : 256 * 1024;
+	_running = true;
+	_flushThread = std::thread(&TelemetryChannel::flushCycle, this);
+}
+
+void TelemetryChannel::stop()
+{
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		if (!_running)
+			return;
+
+		_running = false;
+		_condition.notify_one();
+	}
+
+	_flushThread.join();
+	flush();
+}
+
+void TelemetryChannel::append(int taskId, bool result, const std::string& payload)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	_taskIds.push_back(taskId);
+	_kinds.push_back(result ? 1 : 0);
+	_payloads.push_back(payload);
+
+	_pendingBytes += payload.size();
+	if (result)
+		_hasResult = true;
+
+	if (_pendingBytes >= _maxBatchBytes)
+		_condition.notify_one();
+}
+
+void TelemetryChannel::flushCycle()
+{
+	while (true)
+	{
+		std::vector<int> taskIds;
+		std::vector<int> kinds;
+		std::vector<std::string> payloads;
+		bool hasResult;
+		{
+			std::unique_lock<std::mutex> lck(_mutex);
+			if (!_running)
+				return;
+
+			if (_pendingBytes < _maxBatchBytes)
+				_condition.wait_for(lck, std::chrono::milliseconds(_flushMsec));
+
+			requeueRejected();
+			if (_taskIds.empty())
+				continue;
+
+			taskIds.swap(_taskIds);
+			kinds.swap(_kinds);
+			payloads.swap(_payloads);
+			hasResult = _hasResult;
+
+			_pendingBytes = 0;
+			_hasResult = false;
+		}
+
+		sendBatch(taskIds, kinds, payloads, hasResult);
+	}
+}
+
+//-- Under _mutex.
+void TelemetryChannel::requeueRejected()
+{
+	std::unique_lock<std::mutex> lck(_rejected->mutex);
+	for (size_t i = 0; i < _rejected->taskIds.size(); i++)
+	{
+		_taskIds.push_back(_rejected->taskIds[i]);
+		_kinds.push_back(1);
+		_pendingBytes += _rejected->payloads[i].size();
+		_payloads.push_back(std::move(_rejected->payloads[i]));
+		_hasResult = true;
+	}
+
+	_rejected->taskIds.clear();
+	_rejected->payloads.clear();
+}
+
+void TelemetryChannel::flush()
+{
+	std::vector<int> taskIds;
+	std::vector<int> kinds;
+	std::vector<std::string> payloads;
+	bool hasResult;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		requeueRejected();
+		if (_taskIds.empty())
+			return;
+
+		taskIds.swap(_taskIds);
+		kinds.swap(_kinds);
+		payloads.swap(_payloads);
+		hasResult = _hasResult;
+
+		_pendingBytes = 0;
+		_hasResult = false;
+	}
+
+	sendBatch(taskIds, kinds, payloads, hasResult);
+}
+
+void TelemetryChannel::sendBatch(std::vector<int>& taskIds, std::vector<int>& kinds, std::vector<std::string>& payloads, bool hasResult)
+{
+	FPWriter pw(3);
+	pw.param("taskIds", taskIds);
+	pw.param("kinds", kinds);
+	pw.param("payloads", payloads);
+	std::string records = pw.raw();
+
+	bool zip = false;
+	size_t rawSize = records.size();
+	if (rawSize >= gc_telemetryCompressThreshold)
+	{
+		uLongf compressedSize = compressBound(rawSize);
+		std::string compressed(compressedSize, '\0');
+		if (compress2((Bytef*)&compressed[0], &compressedSize, (const Bytef*)records.data(), rawSize, Z_BEST_SPEED) == Z_OK
+			&& compressedSize < rawSize)
+		{
+			compressed.resize(compressedSize);
+			records.swap(compressed);
+			zip = true;
+		}
+	}
+
+	FPQWriter qw(5, "actorStatusBatch", !hasResult);
+	qw.param("region", _region);
+	qw.param("count", taskIds.size());
+	qw.param("zip", zip);
+	qw.param("rawSize", rawSize);
+	qw.paramBinary("records", records.data(), records.size());
+	FPQuestPtr quest = qw.take();
+
+	size_t count = taskIds.size();
+	bool status;
+	if (hasResult)
+	{
+		//-- Results are kept until acked, for the rejected ones.
+		std::shared_ptr<std::map<int, std::pair<int, std::string>>> results = std::make_shared<std::map<int, std::pair<int, std::string>>>();
+		for (size_t i = 0; i < count; i++)
+			if (kinds[i])
+				(*results)[(int)i] = std::make_pair(taskIds[i], std::move(payloads[i]));
+
+		std::shared_ptr<struct RejectedResults> rejectedResults = _rejected;
+		status = _client->sendQuest(quest, [count, results, rejectedResults](FPAnswerPtr answer, int errorCode){
+			if (errorCode != FPNN_EC_OK)
+			{
+				cout<<"[Error] Send telemetry batch with "<<count<<" record(s) failed. error code: "<<errorCode<<endl;
+				return;
+			}
+
+			FPAReader ar(answer);
+			std::vector<int> rejected = ar.get("rejected", std::vector<int>());
+			if (rejected.empty())
+				return;
+
+			cout<<"[Warning] "<<rejected.size()<<" result(s) rejected by control center, retry with the next batch."<<endl;
+
+			std::unique_lock<std::mutex> lck(rejectedResults->mutex);
+			for (int idx: rejected)
+			{
+				auto iter = results->find(idx);
+				if (iter == results->end())
+					continue;
+
+				rejectedResults->taskIds.push_back(iter->second.first);
+				rejectedResults->payloads.push_back(std::move(iter->second.second));
+			}
+		});
+	}
+	else
+		status = _client->sendQuest(quest, [](FPAnswerPtr, int){});
+
+	if (!status)
+		cout<<"[Error] Send telemetry batch with "<<count<<" record(s) failed."<<endl;
+}
@@ -0,0 +1,59 @@
+#ifndef Telemetry_Channel_h
+#define Telemetry_Channel_h
+
+#include <memory>
+#include <condition_variable>
+#include "TCPClient.h"
+
+using namespace fpnn;
+
+/*
+	Batches actorStatus/actorResult records, and sends them to control center in one actorStatusBatch quest.
+	A batch is flushed when the flush window expired or pending payload size reaches the batch limit.
+	Batch contains only status records is sent as one way quest; batch contains results is acked once per batch.
+	Results rejected by a flooded control center are sent again with the next batch.
+*/
+class TelemetryChannel
+{
+	//-- Filled by answer callbacks, which may run after the channel is destroyed.
+	struct RejectedResults
+	{
+		std::mutex mutex;
+		std::vector<int> taskIds;
+		std::vector<std::string> payloads;
+	};
+
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	TCPClientPtr _client;
+	std::string _region;
+
+	std::vector<int> _taskIds;
+	std::vector<int> _kinds;		//-- 0: actorStatus, 1: actorResult
+	std::vector<std::string> _payloads;
+	size_t _pendingBytes;
+	bool _hasResult;
+	std::shared_ptr<struct RejectedResults> _rejected;
+
+	int _flushMsec;
+	size_t _maxBatchBytes;
+	bool _running;
+	std::thread _flushThread;
+
+	void flushCycle();
+	void requeueRejected();
+	void sendBatch(std::vector<int>& taskIds, std::vector<int>& kinds, std::vector<std::string>& payloads, bool hasResult);
+
+public:
+	TelemetryChannel(): _pendingBytes(0), _hasResult(false), _rejected(std::make_shared<struct RejectedResults>()),
+		_flushMsec(200), _maxBatchBytes(256 * 1024), _running(false) {}
+	~TelemetryChannel() { stop(); }
+
+	void start(TCPClientPtr client, const std::string& region, int flushMsec, size_t maxBatchBytes);
+	void stop();
+
+	void append(int taskId, bool result, const std::string& payload);
+	void flush();
+};
+
+#endif
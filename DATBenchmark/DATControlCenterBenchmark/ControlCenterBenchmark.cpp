@@ -0,0 +1,454 @@
+#include <malloc.h>
+#include <random>
+#include "FPWriter.h"
+#include "MicroBenchmark.h"
+#include "ControlCenterTables.h"
+#include "ConnectionTable.h"
+#include "StatusIngest.h"
+
+using namespace std;
+using namespace fpnn;
+
+/*
+	Hot functions of DATControlCenter on synthetic fleets.
+	range: fields count for buildIdxMap, deployed actors for parseDeployedActors, sections for upload, hosts for the others.
+*/
+
+const int gc_regionCount = 4;
+
+static struct DeployHost makeHost(int64_t index)
+{
+	struct DeployHost host;
+	host.region = "region-" + std::to_string(index % gc_regionCount);
+	host.endpoint = "10." + std::to_string((index >> 16) & 0xFF) + "." + std::to_string((index >> 8) & 0xFF) + "."
+		+ std::to_string(index & 0xFF) + ":" + std::to_string(30000 + index % 20000);
+	return host;
+}
+
+static struct ActorInfo makeActorInfo(int64_t index)
+{
+	struct ActorInfo info;
+	info.mtime = 1700000000 + index;
+	info.fileSize = 10 * 1024 * 1024 + index;
+	info.fileMd5 = "0123456789abcdef0123456789abcdef";
+	info.desc = "synthetic actor " + std::to_string(index);
+	return info;
+}
+
+//-- As a real 8 cores agent reports.
+static struct MonitorInfo makeMonitorInfo(int64_t index)
+{
+	struct MonitorInfo info;
+	info.cpuCount = 8;
+	info.tcpCount = 120 + index % 100;
+	info.udpCount = 4;
+	info.systemLoad = 1.25;
+	info.delayInMsec = 1;
+	info.memoryCount = (int64_t)32 * 1024 * 1024 * 1024;
+	info.freeMemories = (int64_t)8 * 1024 * 1024 * 1024;
+	info.recvBytesDiff = 1000000 + index;
+	info.sendBytesDiff = 800000 + index;
+	info.cpu.util = 16.5;
+	info.cpu.user = 12;
+	info.cpu.system = 3;
+	info.cpu.maxCoreUtil = 30;
+	info.cpu.maxCore = 3;
+	info.cpu.cores.assign(8, std::vector<float>{12.f, 3.f, 0.5f, 0.f, 1.f, 0.f, 16.5f});
+	info.io.pressure = std::map<std::string, float>{ {"cpuSome", 0.5f}, {"memorySome", 0.f}, {"memoryFull", 0.f}, {"ioSome", 0.1f}, {"ioFull", 0.f} };
+	info.io.vmstat = std::map<std::string, int64_t>{ {"majorFaults", 0}, {"swapIn", 0}, {"swapOut", 0} };
+	info.io.disks["vda"] = std::vector<float>{10.f, 20.f, 40960.f, 81920.f, 0.8f, 2.f};
+	info.io.disks["vdb"] = std::vector<float>{1.f, 2.f, 4096.f, 8192.f, 0.5f, 0.2f};
+	return info;
+}
+
+void BM_BuildIdxMap(BenchmarkState& state)
+{
+	std::vector<std::string> fields{"actor", "size", "md5", "mtime"};
+	for (int64_t i = 4; i < state.range(); i++)
+		fields.push_back("extraField" + std::to_string(i));
+
+	const std::set<std::string> hopeFields{"actor", "size", "md5", "mtime"};
+	while (state.keepRunning())
+		doNotOptimize(buildIdxMap(hopeFields, fields));
+
+	state.setItemsProcessed(state.iterations() * state.range());
+}
+DAT_BENCHMARK(BM_BuildIdxMap, 4, 16, 64, 256);
+
+void BM_ParseDeployedActors(BenchmarkState& state)
+{
+	std::vector<std::string> fields{"actor", "size", "md5", "mtime"};
+	std::vector<std::vector<std::string>> rows;
+	for (int64_t i = 0; i < state.range(); i++)
+		rows.push_back(std::vector<std::string>{"actor" + std::to_string(i), "10485760", "0123456789abcdef0123456789abcdef", "1700000000"});
+
+	std::map<std::string, struct ActorInfo> actorInfos;
+	while (state.keepRunning())
+	{
+		parseDeployedActors(fields, rows, actorInfos);
+		doNotOptimize(actorInfos);
+	}
+
+	state.setItemsProcessed(state.iterations() * state.range());
+}
+DAT_BENCHMARK(BM_ParseDeployedActors, 10, 100, 1000, 10000);
+
+//-- availableActors answer: 50 uploaded actors, range deployers with 4 deployed actors each.
+void BM_ActorInfoRows(BenchmarkState& state)
+{
+	std::map<std::string, struct ActorInfo> actorInfos;
+	for (int i = 0; i < 50; i++)
+		actorInfos["actor" + std::to_string(i)] = makeActorInfo(i);
+
+	std::map<struct DeployHost, std::map<std::string, struct ActorInfo>> deployed;
+	for (int64_t i = 0; i < state.range(); i++)
+	{
+		std::map<std::string, struct ActorInfo>& infos = deployed[makeHost(i)];
+		for (int k = 0; k < 4; k++)
+			infos["actor" + std::to_string(k)] = makeActorInfo(k);
+	}
+
+	while (state.keepRunning())
+	{
+		std::vector<std::vector<std::string>> availableRows, deployedRows;
+		appendAvailableActorRows(availableRows, actorInfos);
+		for (auto& pp: deployed)
+			appendDeployedActorRows(deployedRows, pp.first, pp.second);
+
+		doNotOptimize(deployedRows);
+	}
+
+	state.setItemsProcessed(state.iterations() * state.range());
+}
+DAT_BENCHMARK(BM_ActorInfoRows, 10, 100, 1000, 10000, 100000);
+
+void BM_MachineStatusRows(BenchmarkState& state)
+{
+	std::map<struct DeployHost, struct MonitorInfo> infos;
+	for (int64_t i = 0; i < state.range(); i++)
+		infos[makeHost(i)] = makeMonitorInfo(i);
+
+	while (state.keepRunning())
+	{
+		std::vector<std::vector<std::string>> rows;
+		for (auto& pp: infos)
+			appendMachineStatusRow(rows, "Deployer", pp.first, pp.second);
+
+		doNotOptimize(rows);
+	}
+
+	state.setItemsProcessed(state.iterations() * state.range());
+}
+DAT_BENCHMARK(BM_MachineStatusRows, 10, 100, 1000, 10000, 100000);
+
+//-- msgpack encoding of the machineStatus rows, the part after the lock.
+void BM_MachineStatusEncode(BenchmarkState& state)
+{
+	std::vector<std::vector<std::string>> rows;
+	for (int64_t i = 0; i < state.range(); i++)
+		appendMachineStatusRow(rows, "Deployer", makeHost(i), makeMonitorInfo(i));
+
+	const std::vector<std::string> fields(rows.empty() ? 0 : rows[0].size(), "field");
+	while (state.keepRunning())
+	{
+		FPWriter pw(2);
+		pw.param("fields", fields);
+		pw.param("rows", rows);
+		doNotOptimize(pw.raw());
+	}
+
+	state.setItemsProcessed(state.iterations() * state.range());
+}
+DAT_BENCHMARK(BM_MachineStatusEncode, 10, 100, 1000, 10000, 100000);
+
+//-- Upload of range sections: every received section is stored, then writeUploadActor fetches & erases it.
+void BM_UploadSections(BenchmarkState& state)
+{
+	const std::string content(4096, 'a');
+	std::string section;
+	int no;
+
+	while (state.keepRunning())
+	{
+		std::map<int, std::string> sections;
+		for (int64_t i = 0; i < state.range(); i++)
+			sections[i + 1] = std::string();
+
+		for (int64_t i = 0; i < state.range(); i++)
+		{
+			std::string received(content);
+			sections[i + 1].swap(received);
+
+			if (fetchFilledSection(sections, no, section))
+			{
+				sections.erase(no);
+				section.clear();
+			}
+		}
+		doNotOptimize(sections);
+	}
+
+	state.setItemsProcessed(state.iterations() * state.range());
+}
+DAT_BENCHMARK(BM_UploadSections, 10, 100, 1000, 10000);
+
+//-- _deployerInfos/_monitorInfos/_runningActorInfos lookups by DeployHost.
+void BM_DeployHostFind(BenchmarkState& state)
+{
+	std::map<struct DeployHost, int> hosts;
+	for (int64_t i = 0; i < state.range(); i++)
+		hosts[makeHost(i)] = (int)i;
+
+	const int lookups = 1024;
+	std::vector<struct DeployHost> keys;
+	std::mt19937 random(1);
+	for (int i = 0; i < lookups; i++)
+		keys.push_back(makeHost(random() % state.range()));
+
+	while (state.keepRunning())
+	{
+		int found = 0;
+		for (auto& key: keys)
+			found += hosts.find(key)->second;
+
+		doNotOptimize(found);
+	}
+
+	state.setItemsProcessed(state.iterations() * lookups);
+}
+DAT_BENCHMARK(BM_DeployHostFind, 10, 100, 1000, 10000, 100000);
+
+//-- Same lookups in HostRegistry: by endpoint string as actorAction, and by interned id as connection records.
+void BM_HostRegistryFind(BenchmarkState& state)
+{
+	HostNames names;
+	HostRegistry<int> hosts(names);
+	for (int64_t i = 0; i < state.range(); i++)
+		hosts[makeHost(i)] = (int)i;
+
+	const int lookups = 1024;
+	std::vector<struct DeployHost> keys;
+	std::mt19937 random(1);
+	for (int i = 0; i < lookups; i++)
+		keys.push_back(makeHost(random() % state.range()));
+
+	while (state.keepRunning())
+	{
+		int found = 0;
+		for (auto& key: keys)
+			found += hosts.find(key)->second;
+
+		doNotOptimize(found);
+	}
+
+	state.setItemsProcessed(state.iterations() * lookups);
+}
+DAT_BENCHMARK(BM_HostRegistryFind, 10, 100, 1000, 10000, 100000);
+
+void BM_HostRegistryFindId(BenchmarkState& state)
+{
+	HostNames names;
+	HostRegistry<int> hosts(names);
+	for (int64_t i = 0; i < state.range(); i++)
+		hosts[makeHost(i)] = (int)i;
+
+	const int lookups = 1024;
+	std::vector<uint32_t> keys;
+	std::mt19937 random(1);
+	for (int i = 0; i < lookups; i++)
+		keys.push_back(names.endpoints.find(makeHost(random() % state.range()).endpoint));
+
+	while (state.keepRunning())
+	{
+		int found = 0;
+		for (uint32_t key: keys)
+			found += hosts.findEndpoint(key)->second;
+
+		doNotOptimize(found);
+	}
+
+	state.setItemsProcessed(state.iterations() * lookups);
+}
+DAT_BENCHMARK(BM_HostRegistryFindId, 10, 100, 1000, 10000, 100000);
+
+//-- Connect & disconnect of an agent.
+void BM_DeployHostInsertErase(BenchmarkState& state)
+{
+	std::map<struct DeployHost, struct MonitorInfo> hosts;
+	for (int64_t i = 0; i < state.range(); i++)
+		hosts[makeHost(i)] = MonitorInfo();
+
+	const struct DeployHost key = makeHost(state.range() + 1);
+	while (state.keepRunning())
+	{
+		hosts[key].cpuCount = 8;
+		hosts.erase(key);
+	}
+
+	state.setItemsProcessed(state.iterations());
+}
+DAT_BENCHMARK(BM_DeployHostInsertErase, 10, 100, 1000, 10000, 100000);
+
+void BM_HostRegistryInsertErase(BenchmarkState& state)
+{
+	HostNames names;
+	HostRegistry<struct MonitorInfo> hosts(names);
+	for (int64_t i = 0; i < state.range(); i++)
+		hosts[makeHost(i)] = MonitorInfo();
+
+	const struct DeployHost key = makeHost(state.range() + 1);
+	while (state.keepRunning())
+	{
+		hosts[key].cpuCount = 8;
+		hosts.erase(key);
+	}
+
+	state.setItemsProcessed(state.iterations());
+}
+DAT_BENCHMARK(BM_HostRegistryInsertErase, 10, 100, 1000, 10000, 100000);
+
+//-- Allocated heap bytes, for memory per entry.
+static size_t heapBytes()
+{
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+	return mallinfo2().uordblks;
+#else
+	return (size_t)(unsigned int)mallinfo().uordblks;
+#endif
+}
+
+//-- Layout of _connData before ConnectionTable: std::map<int, ConnectionPrivateDataPtr>.
+struct LegacyConnectionData
+{
+	std::mutex _mutex;
+	UploadInfoPtr _upload;
+	ClientRole _role;
+	struct DeployHost _deployHost;
+	std::string _actorName;
+	int _actorPid;
+	bool _monitoringMachineStatus;
+
+	LegacyConnectionData(): _role(ClientRole::Controller), _actorPid(0), _monitoringMachineStatus(false) {}
+};
+
+const int gc_firstSocket = 16;
+const int gc_actorsPerHost = 8;
+
+//-- Idle actor connections: range actors, 8 per host. Lookup by socket as every quest does.
+void BM_ConnDataMapLookup(BenchmarkState& state)
+{
+	size_t heapBegin = heapBytes();
+	std::map<int, std::shared_ptr<struct LegacyConnectionData>> connData;
+	for (int64_t i = 0; i < state.range(); i++)
+	{
+		std::shared_ptr<struct LegacyConnectionData> cpd = std::make_shared<struct LegacyConnectionData>();
+		cpd->_role = ClientRole::Actor;
+		cpd->_deployHost = makeHost(i / gc_actorsPerHost);
+		cpd->_deployHost.endpoint.append(std::to_string(i % gc_actorsPerHost));		//-- actor endpoint: own port.
+		cpd->_actorName = "actor" + std::to_string(i % gc_actorsPerHost);
+		cpd->_actorPid = (int)i + 1000;
+		connData[gc_firstSocket + (int)i] = cpd;
+	}
+	double bytesPerConnection = (double)(heapBytes() - heapBegin) / state.range();
+
+	const int lookups = 1024;
+	std::vector<int> sockets;
+	std::mt19937 random(1);
+	for (int i = 0; i < lookups; i++)
+		sockets.push_back(gc_firstSocket + random() % state.range());
+
+	while (state.keepRunning())
+	{
+		int actors = 0;
+		for (int socket: sockets)
+		{
+			std::shared_ptr<struct LegacyConnectionData> cpd = connData[socket];
+			actors += (cpd->_role == ClientRole::Actor);
+		}
+		doNotOptimize(actors);
+	}
+
+	state.setItemsProcessed(state.iterations() * lookups);
+	state.setCounter("bytesPerConnection", bytesPerConnection);
+}
+DAT_BENCHMARK(BM_ConnDataMapLookup, 1000, 10000, 100000);
+
+void BM_ConnDataSlabLookup(BenchmarkState& state)
+{
+	size_t heapBegin = heapBytes();
+	HostNames names;
+	ConnectionTable connData(names);
+	for (int64_t i = 0; i < state.range(); i++)
+	{
+		int socket = gc_firstSocket + (int)i;
+		struct DeployHost host = makeHost(i / gc_actorsPerHost);
+
+		connData.open(socket);
+		connData.registerRole(socket, ClientRole::Actor, host.region, host.endpoint + std::to_string(i % gc_actorsPerHost));
+		connData.registerActor(socket, "actor" + std::to_string(i % gc_actorsPerHost), (int)i + 1000);
+	}
+	double bytesPerConnection = (double)(heapBytes() - heapBegin) / state.range();
+
+	const int lookups = 1024;
+	std::vector<int> sockets;
+	std::mt19937 random(1);
+	for (int i = 0; i < lookups; i++)
+		sockets.push_back(gc_firstSocket + random() % state.range());
+
+	while (state.keepRunning())
+	{
+		int actors = 0;
+		for (int socket: sockets)
+			actors += (connData[socket].role == ClientRole::Actor);
+
+		doNotOptimize(actors);
+	}
+
+	state.setItemsProcessed(state.iterations() * lookups);
+	state.setCounter("bytesPerConnection", bytesPerConnection);
+	state.setCounter("estimatedBytesPerConnection", (double)(connData.memoryBytes() + names.memoryBytes()) / state.range());
+}
+DAT_BENCHMARK(BM_ConnDataSlabLookup, 1000, 10000, 100000);
+
+//-- actorStatus ingest of a worker: enqueue only, shard threads drain. range: shard threads.
+void BM_StatusIngestPush(BenchmarkState& state)
+{
+	std::atomic<uint64_t> dispatched(0);
+	StatusIngest ingest;
+	ingest.start((int)state.range(), 16384, [&dispatched](struct StatusMessage& message){ dispatched++; });
+
+	const int batch = 1024;
+	std::string payload(64, 'x');
+	int taskId = 0;
+
+	while (state.keepRunning())
+	{
+		for (int i = 0; i < batch; i++)
+		{
+			struct StatusMessage message;
+			message.taskId = taskId++ % 97;
+			message.region = "region-0";
+			message.endpoint = "10.0.0.1:30000";
+			message.payload = payload;
+			ingest.push(message);
+		}
+	}
+
+	std::vector<std::vector<std::string>> rows;
+	ingest.appendRows(rows);
+	ingest.stop();
+
+	uint64_t dropped = 0;
+	for (auto& row: rows)
+		dropped += std::stoull(row[6]);
+
+	state.setItemsProcessed(state.iterations() * batch);
+	state.setCounter("dropped", (double)dropped);
+	state.setCounter("dispatched", (double)dispatched.load());
+}
+DAT_BENCHMARK(BM_StatusIngestPush, 1, 2, 4);
+
+int main(int argc, const char** argv)
+{
+	return MicroBenchmark::runAll(argc, argv);
+}
@@ -0,0 +1,412 @@
+#include <iostream>
+#include <unistd.h>
+#include "ignoreSignals.h"
+#include "CommandLineUtil.h"
+#include "FormattedPrint.h"
+#include "TCPClient.h"
+#include "FleetQuestProcessor.h"
+
+using namespace std;
+using namespace fpnn;
+
+/*
+	Load test of DATControlCenter itself.
+
+	The simulated fleet grows in steps. Each step connects & registers its share of deployers, monitors and actors,
+	then drives actorStatus from all connected actors for stepSec seconds, and reports one row:
+	CC answer latency & throughput of actorStatus, the forwarding latency to a subscribed controller,
+	and how many machineStatus polls of deployerMontiorCycle are received against the expected count.
+*/
+class FleetSimulator
+{
+	std::string _endpoint;
+	std::string _region;
+	int _deployers;
+	int _monitors;
+	int _actors;
+	double _statusRate;			//-- actorStatus per actor per second.
+	int _payloadSize;
+	int _steps;
+	int _stepSec;
+	int _actorsPerTask;
+	int _taskIdBase;
+
+	FleetStats _stats;
+	std::shared_ptr<FleetQuestProcessor> _processor;
+	TCPClientPtr _controller;
+	std::vector<TCPClientPtr> _deployerClients;
+	std::vector<TCPClientPtr> _monitorClients;
+	std::vector<TCPClientPtr> _actorClients;
+	std::vector<int> _actorTaskIds;
+
+	std::vector<std::string> _fields;
+	std::vector<std::vector<std::string>> _rows;
+
+	TCPClientPtr connectAgent();
+	void registerAgent(TCPClientPtr client, FPQuestPtr quest);
+	bool waitRegistered(uint64_t expected);
+	void addDeployer();
+	void addMonitor();
+	void addActor();
+	bool openController();
+	void grow(int step);
+	void drive(int step);
+	void sendActorStatus(size_t index);
+	void queryMachineStatus();
+
+public:
+	FleetSimulator(): _processor(std::make_shared<FleetQuestProcessor>(_stats)) {}
+
+	bool init(int argc, const char** argv);
+	void run();
+};
+
+bool FleetSimulator::init(int argc, const char** argv)
+{
+	CommandLineParser::init(argc, argv);
+
+	_endpoint = CommandLineParser::getString("e");
+	if (_endpoint.empty())
+	{
+		_endpoint = CommandLineParser::getString("h");
+		std::string port = CommandLineParser::getString("p");
+		if (_endpoint.empty() || port.empty())
+			return false;
+
+		_endpoint.append(":").append(port);
+	}
+
+	_region = CommandLineParser::getString("region", "fleetSimulator");
+	_deployers = (int)CommandLineParser::getInt("deployers", 100);
+	_monitors = (int)CommandLineParser::getInt("monitors", 0);
+	_actors = (int)CommandLineParser::getInt("actors", 1000);
+	_statusRate = CommandLineParser::getReal("rate", 1);
+	_payloadSize = (int)CommandLineParser::getInt("payload", 256);
+	_steps = (int)CommandLineParser::getInt("steps", 10);
+	_stepSec = (int)CommandLineParser::getInt("stepSec", 10);
+	_actorsPerTask = (int)CommandLineParser::getInt("actorsPerTask", 100);
+	_taskIdBase = (int)CommandLineParser::getInt("taskIdBase", 1000000);
+
+	if (_deployers < 0 || _monitors < 0 || _actors < 0 || _statusRate < 0 || _steps <= 0 || _stepSec <= 0 || _actorsPerTask <= 0)
+		return false;
+
+	_fields = std::vector<std::string>{ "step", "deployers", "monitors", "actors", "registerP99(us)", "status/s", "answered/s", "failed", "inflight",
+		"statusP50(us)", "statusP90(us)", "statusP99(us)", "statusP99.9(us)", "statusMax(us)",
+		"forwarded/s", "forwardP50(us)", "forwardP99(us)", "polls/s", "expectedPolls/s", "queryP50(us)", "queryP99(us)" };
+
+	return openController();
+}
+
+//-- Subscribe all simulated tasks, and open machine status monitoring, so deployerMontiorCycle runs.
+bool FleetSimulator::openController()
+{
+	_controller = TCPClient::createClient(_endpoint);
+	if (!_controller)
+		return false;
+
+	_controller->setQuestProcessor(_processor);
+
+	FPQWriter qw(1, "monitorMachineStatus");
+	qw.param("monitor", true);
+	FPAReader ar(_controller->sendQuest(qw.take()));
+	if (ar.status())
+	{
+		cout<<"[Error] Open machine status monitoring failed. code: "<<ar.wantInt("code")<<", ex: "<<ar.wantString("ex")<<endl;
+		return false;
+	}
+
+	std::set<int> taskIds;
+	int taskCount = (_actors + _actorsPerTask - 1) / _actorsPerTask;
+	for (int i = 0; i < taskCount; i++)
+		taskIds.insert(_taskIdBase + i);
+
+	if (taskIds.empty())
+		return true;
+
+	FPQWriter mw(1, "monitorTasks");
+	mw.param("taskIds", taskIds);
+	FPAReader mr(_controller->sendQuest(mw.take()));
+	if (mr.status())
+	{
+		cout<<"[Error] Subscribe simulated tasks failed. code: "<<mr.wantInt("code")<<", ex: "<<mr.wantString("ex")<<endl;
+		return false;
+	}
+	return true;
+}
+
+TCPClientPtr FleetSimulator::connectAgent()
+{
+	TCPClientPtr client = TCPClient::createClient(_endpoint, false);
+	if (!client)
+		return nullptr;
+
+	client->setQuestProcessor(_processor);
+	if (!client->connect())
+	{
+		cout<<"[Error] Connect "<<_endpoint<<" failed. Check ulimit -n for thousands of connections."<<endl;
+		return nullptr;
+	}
+	return client;
+}
+
+void FleetSimulator::registerAgent(TCPClientPtr client, FPQuestPtr quest)
+{
+	int64_t sendUsec = steadyUsec();
+	bool status = client->sendQuest(quest, [this, sendUsec](FPAnswerPtr answer, int errorCode){
+		if (errorCode == FPNN_EC_OK)
+		{
+			_stats.registerLatency.record(steadyUsec() - sendUsec);
+			_stats.registered++;
+		}
+		else
+			_stats.registerFailed++;
+	});
+
+	if (!status)
+		_stats.registerFailed++;
+}
+
+void FleetSimulator::addDeployer()
+{
+	TCPClientPtr client = connectAgent();
+	if (!client)
+		return;
+
+	std::vector<std::vector<std::string>> rows{
+		{"SimulatedActor", "10485760", "0123456789abcdef0123456789abcdef", "1700000000"},
+		{"SimulatedCorpus", "1048576", "fedcba9876543210fedcba9876543210", "1700000000"} };
+
+	FPQWriter qw(5, "registerDeployer");
+	qw.param("region", _region);
+	qw.param("fields", std::vector<std::string>{"actor", "size", "md5", "mtime"});
+	qw.param("rows", rows);
+	qw.param("cpus", 8);
+	qw.param("totalMemories", (int64_t)32 * 1024 * 1024 * 1024);
+
+	registerAgent(client, qw.take());
+	_deployerClients.push_back(client);
+}
+
+void FleetSimulator::addMonitor()
+{
+	TCPClientPtr client = connectAgent();
+	if (!client)
+		return;
+
+	FPQWriter qw(3, "registerMonitor");
+	qw.param("region", _region);
+	qw.param("cpus", 8);
+	qw.param("totalMemories", (int64_t)32 * 1024 * 1024 * 1024);
+
+	registerAgent(client, qw.take());
+	_monitorClients.push_back(client);
+}
+
+void FleetSimulator::addActor()
+{
+	TCPClientPtr client = connectAgent();
+	if (!client)
+		return;
+
+	int index = (int)_actorClients.size();
+	int taskId = _taskIdBase + index / _actorsPerTask;
+
+	std::map<int, std::vector<std::string>> executingTasks;
+	executingTasks[taskId] = std::vector<std::string>{"simulate", "fleet simulator"};
+
+	FPQWriter qw(4, "registerActor");
+	qw.param("region", _region);
+	qw.param("name", "SimulatedActor");
+	qw.param("pid", 100000 + index);
+	qw.param("executingTasks", executingTasks);
+
+	registerAgent(client, qw.take());
+	_actorClients.push_back(client);
+	_actorTaskIds.push_back(taskId);
+}
+
+bool FleetSimulator::waitRegistered(uint64_t expected)
+{
+	for (int i = 0; i < 3000; i++)
+	{
+		if (_stats.registered + _stats.registerFailed >= expected)
+			return true;
+
+		usleep(10 * 1000);
+	}
+	return false;
+}
+
+//-- Fleet size of step n: n/steps of the total.
+void FleetSimulator::grow(int step)
+{
+	int64_t begin = steadyUsec();
+	size_t before = _deployerClients.size() + _monitorClients.size() + _actorClients.size();
+
+	while ((int)_deployerClients.size() < _deployers * step / _steps)
+		addDeployer();
+
+	while ((int)_monitorClients.size() < _monitors * step / _steps)
+		addMonitor();
+
+	while ((int)_actorClients.size() < _actors * step / _steps)
+		addActor();
+
+	size_t total = _deployerClients.size() + _monitorClients.size() + _actorClients.size();
+	bool done = waitRegistered(total);
+
+	cout<<"[Step "<<step<<"/"<<_steps<<"] "<<(total - before)<<" agents connected & registered in "<<(steadyUsec() - begin) / 1000<<" ms";
+	if (!done)
+		cout<<", registration timeout";
+	if (_stats.registerFailed)
+		cout<<", "<<_stats.registerFailed<<" registrations failed";
+	cout<<endl;
+}
+
+void FleetSimulator::sendActorStatus(size_t index)
+{
+	int64_t sendUsec = steadyUsec();
+
+	FPQWriter qw(3, "actorStatus");
+	qw.param("taskId", _actorTaskIds[index]);
+	qw.param("region", _region);
+	qw.param("payload", FleetQuestProcessor::buildPayload(sendUsec, _payloadSize));
+
+	_stats.statusSent++;
+	bool status = _actorClients[index]->sendQuest(qw.take(), [this, sendUsec](FPAnswerPtr answer, int errorCode){
+		if (errorCode == FPNN_EC_OK)
+		{
+			_stats.statusLatency.record(steadyUsec() - sendUsec);
+			_stats.statusAnswered++;
+		}
+		else
+			_stats.statusFailed++;
+	});
+
+	if (!status)
+		_stats.statusFailed++;
+}
+
+void FleetSimulator::queryMachineStatus()
+{
+	int64_t sendUsec = steadyUsec();
+	_controller->sendQuest(FPQWriter::emptyQuest("machineStatus"), [this, sendUsec](FPAnswerPtr answer, int errorCode){
+		if (errorCode == FPNN_EC_OK)
+			_stats.queryLatency.record(steadyUsec() - sendUsec);
+	});
+}
+
+void FleetSimulator::drive(int step)
+{
+	const int tickMsec = 10;
+
+	uint64_t sent = _stats.statusSent;
+	uint64_t answered = _stats.statusAnswered;
+	uint64_t forwarded = _stats.forwarded;
+	uint64_t polls = _stats.machineStatusPolls;
+
+	LatencyHistogram discarded;
+	_stats.statusLatency.drainTo(discarded);
+	_stats.forwardLatency.drainTo(discarded);
+	_stats.queryLatency.drainTo(discarded);
+
+	int64_t begin = steadyUsec();
+	int64_t end = begin + (int64_t)_stepSec * 1000 * 1000;
+	int64_t nextQuery = begin;
+	int64_t last = begin;
+	double credit = 0;
+	size_t cursor = 0;
+
+	while (true)
+	{
+		int64_t now = steadyUsec();
+		if (now >= end)
+			break;
+
+		//-- Spread actorStatus evenly: credit accumulates at actors * rate per second.
+		credit += _actorClients.size() * _statusRate * (now - last) / 1000000.0;
+		last = now;
+		while (credit >= 1 && _actorClients.size())
+		{
+			sendActorStatus(cursor);
+			cursor = (cursor + 1) % _actorClients.size();
+			credit -= 1;
+		}
+
+		if (now >= nextQuery)
+		{
+			queryMachineStatus();
+			nextQuery += 1000 * 1000;
+		}
+
+		usleep(tickMsec * 1000);
+	}
+
+	//-- Let the answers of the last tick arrive.
+	usleep(200 * 1000);
+
+	double seconds = (steadyUsec() - begin) / 1000000.0;
+	uint64_t failed = _stats.statusFailed;
+	uint64_t inflight = _stats.statusSent - _stats.statusAnswered - failed;
+
+	std::vector<std::string> row{ std::to_string(step), std::to_string(_deployerClients.size()), std::to_string(_monitorClients.size()),
+		std::to_string(_actorClients.size()), std::to_string(_stats.registerLatency.percentile(99)),
+		std::to_string((int64_t)((_stats.statusSent - sent) / seconds)), std::to_string((int64_t)((_stats.statusAnswered - answered) / seconds)),
+		std::to_string(failed), std::to_string(inflight),
+		std::to_string(_stats.statusLatency.percentile(50)), std::to_string(_stats.statusLatency.percentile(90)),
+		std::to_string(_stats.statusLatency.percentile(99)), std::to_string(_stats.statusLatency.percentile(99.9)),
+		std::to_string(_stats.statusLatency.max()),
+		std::to_string((int64_t)((_stats.forwarded - forwarded) / seconds)),
+		std::to_string(_stats.forwardLatency.percentile(50)), std::to_string(_stats.forwardLatency.percentile(99)),
+		std::to_string((int64_t)((_stats.machineStatusPolls - polls) / seconds)),
+		std::to_string((_deployerClients.size() + _monitorClients.size()) / 2),
+		std::to_string(_stats.queryLatency.percentile(50)), std::to_string(_stats.queryLatency.percentile(99)) };
+
+	printTable(_fields, std::vector<std::vector<std::string>>{row});
+	_rows.push_back(row);
+}
+
+void FleetSimulator::run()
+{
+	for (int step = 1; step <= _steps; step++)
+	{
+		grow(step);
+		drive(step);
+	}
+
+	cout<<endl<<"Summary:"<<endl;
+	printTable(_fields, _rows);
+}
+
+int showUsage(const char* appName)
+{
+	cout<<"Usgae:"<<endl;
+	cout<<"\t"<<appName<<" -e endpoint [options]"<<endl;
+	cout<<"\t"<<appName<<" -h host -p port [options]"<<endl;
+	cout<<"Options:"<<endl;
+	cout<<"\t--deployers count      default: 100"<<endl;
+	cout<<"\t--monitors count       default: 0"<<endl;
+	cout<<"\t--actors count         default: 1000"<<endl;
+	cout<<"\t--rate qps             actorStatus per actor per second, default: 1"<<endl;
+	cout<<"\t--payload bytes        padding of actorStatus payload, default: 256"<<endl;
+	cout<<"\t--steps count          fleet grows in steps, default: 10"<<endl;
+	cout<<"\t--stepSec seconds      driving seconds of each step, default: 10"<<endl;
+	cout<<"\t--actorsPerTask count  default: 100"<<endl;
+	cout<<"\t--taskIdBase id        simulated task ids, default: 1000000"<<endl;
+	cout<<"\t--region region        default: fleetSimulator"<<endl;
+	return -1;
+}
+
+int main(int argc, const char** argv)
+{
+	ignoreSignals();
+	ClientEngine::configAnswerCallbackThreadPool(2, 1, 4, 8);
+	ClientEngine::configQuestProcessThreadPool(2, 1, 4, 8, 0);
+
+	FleetSimulator simulator;
+	if (!simulator.init(argc, argv))
+		return showUsage(argv[0]);
+
+	simulator.run();
+	return 0;
+}
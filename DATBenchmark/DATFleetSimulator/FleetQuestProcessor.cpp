@@ -0,0 +1,86 @@
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+#include "msec.h"
+#include "NetStackCounters.h"
+#include "FleetQuestProcessor.h"
+
+const char* gc_sendUsecKey = "\"sendUsec\":";
+
+int64_t steadyUsec()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string FleetQuestProcessor::buildPayload(int64_t sendUsec, int padding)
+{
+	std::string payload("{\"type\":\"simulated\",");
+	payload.append(gc_sendUsecKey).append(std::to_string(sendUsec));
+	payload.append(",\"pad\":\"").append(padding > 0 ? padding : 0, 'x').append("\"}");
+	return payload;
+}
+
+//-- Same fields as real agents, with 8 cores, so the CC parses & stores as much as it does for real machines.
+FPAnswerPtr FleetQuestProcessor::machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	_stats.machineStatusPolls++;
+
+	int64_t msec = slack_mono_msec();
+	std::vector<std::vector<float>> cores(8, std::vector<float>{12.f, 3.f, 0.5f, 0.f, 1.f, 0.f, 16.5f});
+
+	std::map<std::string, int64_t> netStack;
+	for (int i = 0; i < NetStackCounterCount; i++)
+		netStack[gc_netStackCounterNames[i]] = 0;
+	netStack[gc_netStackCounterNames[TcpRetransSegs]] = 3;
+	netStack[gc_netStackCounterNames[TcpOutRsts]] = 1;
+	netStack[gc_netStackTimeWaitName] = 40;
+
+	FPAWriter aw(20, quest);
+	aw.param("sysLoad", 1.25);
+	aw.param("tcpConn", 120);
+	aw.param("udpConn", 4);
+	aw.param("freeMemories", (int64_t)8 * 1024 * 1024 * 1024);
+	aw.param("RX", msec * 1000);
+	aw.param("TX", msec * 800);
+	aw.param("cpuUtil", 16.5);
+	aw.param("cpuUser", 12.0);
+	aw.param("cpuSystem", 3.0);
+	aw.param("cpuIowait", 0.5);
+	aw.param("cpuIrq", 0.0);
+	aw.param("cpuSoftirq", 1.0);
+	aw.param("cpuSteal", 0.0);
+	aw.param("maxCoreUtil", 16.5);
+	aw.param("maxCore", 0);
+	aw.param("cores", cores);
+	aw.param("netStack", netStack);
+	aw.param("pressure", std::map<std::string, float>{ {"cpuSome", 0.5f}, {"memorySome", 0.f}, {"ioSome", 0.1f} });
+	aw.param("disks", std::map<std::string, std::vector<float>>{ {"vda", std::vector<float>{10.f, 20.f, 40960.f, 81920.f, 0.8f, 2.f}} });
+	aw.param("vmstat", std::map<std::string, int64_t>{ {"majorFaults", 0}, {"swapIn", 0}, {"swapOut", 0} });
+	return aw.take();
+}
+
+FPAnswerPtr FleetQuestProcessor::ping(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	_stats.pings++;
+	return FPAWriter::emptyAnswer(quest);
+}
+
+FPAnswerPtr FleetQuestProcessor::action(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	_stats.actions++;
+	return FPAWriter::emptyAnswer(quest);
+}
+
+FPAnswerPtr FleetQuestProcessor::forwardedStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string payload = args->getString("payload");
+	size_t pos = payload.find(gc_sendUsecKey);
+	if (pos != std::string::npos)
+	{
+		int64_t sendUsec = strtoll(payload.c_str() + pos + strlen(gc_sendUsecKey), NULL, 10);
+		_stats.forwardLatency.record(steadyUsec() - sendUsec);
+	}
+
+	_stats.forwarded++;
+	return FPAWriter::emptyAnswer(quest);
+}
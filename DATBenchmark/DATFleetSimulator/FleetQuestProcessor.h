@@ -0,0 +1,64 @@
+#ifndef DAT_Fleet_Quest_Processor_h
+#define DAT_Fleet_Quest_Processor_h
+
+#include <atomic>
+#include "IQuestProcessor.h"
+#include "LatencyHistogram.h"
+
+using namespace fpnn;
+
+int64_t steadyUsec();
+
+struct FleetStats
+{
+	std::atomic<uint64_t> registered;
+	std::atomic<uint64_t> registerFailed;
+	std::atomic<uint64_t> statusSent;
+	std::atomic<uint64_t> statusAnswered;
+	std::atomic<uint64_t> statusFailed;
+	std::atomic<uint64_t> forwarded;
+	std::atomic<uint64_t> machineStatusPolls;
+	std::atomic<uint64_t> pings;
+	std::atomic<uint64_t> actions;
+
+	LatencyHistogram registerLatency;		//-- registerDeployer/registerMonitor/registerActor answer.
+	LatencyHistogram statusLatency;			//-- actorStatus answer.
+	LatencyHistogram forwardLatency;		//-- actorStatus sent by simulated actor -> forwarded to simulated controller.
+	LatencyHistogram queryLatency;			//-- machineStatus query answer, as a dashboard refreshing.
+
+	FleetStats(): registered(0), registerFailed(0), statusSent(0), statusAnswered(0), statusFailed(0),
+		forwarded(0), machineStatusPolls(0), pings(0), actions(0) {}
+};
+
+/*
+	Shared by all simulated connections: deployers & monitors answer the pushes of deployerMontiorCycle,
+	actors answer actions, and the simulated controller receives the forwarded actorStatus & actorResult.
+*/
+class FleetQuestProcessor: public IQuestProcessor
+{
+	QuestProcessorClassPrivateFields(FleetQuestProcessor)
+
+	FleetStats& _stats;
+
+public:
+	FleetQuestProcessor(FleetStats& stats): _stats(stats)
+	{
+		registerMethod("machineStatus", &FleetQuestProcessor::machineStatus);
+		registerMethod("ping", &FleetQuestProcessor::ping);
+		registerMethod("action", &FleetQuestProcessor::action);
+		registerMethod("actorStatus", &FleetQuestProcessor::forwardedStatus);
+		registerMethod("actorResult", &FleetQuestProcessor::forwardedStatus);
+	}
+
+	FPAnswerPtr machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr ping(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr action(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr forwardedStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+
+	//-- Payload of simulated actorStatus, carries the send time for forwardLatency.
+	static std::string buildPayload(int64_t sendUsec, int padding);
+
+	QuestProcessorClassBasicPublicFuncs
+};
+
+#endif
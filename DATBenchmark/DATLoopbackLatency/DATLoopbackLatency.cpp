@@ -0,0 +1,403 @@
+#include <iostream>
+#include <fstream>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include "ignoreSignals.h"
+#include "CommandLineUtil.h"
+#include "FormattedPrint.h"
+#include "FileSystemUtil.h"
+#include "TCPClient.h"
+#include "LoopbackQuestProcessor.h"
+
+using namespace std;
+using namespace fpnn;
+
+const char* gc_actorName = "LoopbackActor";
+const char* gc_region = "loopback";
+
+/*
+	End-to-end latency of the action/result control path on localhost:
+		controller actorAction -> CC actorAction -> actor action -> actor actorResult -> CC forwardActorStatus -> controller.
+
+	Starts a DATControlCenter (unless -e is given), a DATDeployer (if found), and N instrumented actors,
+	which are this program forked in actor mode. Then drives actorAction at a fixed rate, round robin over actors,
+	and prints latency percentiles of each hop.
+*/
+class LoopbackHarness
+{
+	std::string _endpoint;
+	std::string _workDir;
+	int _port;
+	int _actors;
+	double _rate;
+	int _seconds;
+	int _warmupSec;
+	int _workUsec;
+
+	std::vector<pid_t> _children;
+	LoopbackHops _hops;
+	TCPClientPtr _client;
+	std::vector<std::pair<std::string, int>> _actorEndpoints;		//-- endpoint, pid
+
+	pid_t spawn(const std::string& path, const std::vector<std::string>& args, const std::string& cwd);
+	bool startControlCenter(const std::string& path);
+	void startDeployer(const std::string& path);
+	void startActors();
+	bool waitControlCenter();
+	bool discoverActors();
+	void sendAction(size_t index, int64_t seq);
+	void report();
+
+public:
+	LoopbackHarness(): _port(0), _actors(0), _rate(0), _seconds(0), _warmupSec(0), _workUsec(0) {}
+	~LoopbackHarness();
+
+	bool init();
+	int run();
+};
+
+LoopbackHarness::~LoopbackHarness()
+{
+	if (_client)
+		_client->close();
+
+	for (pid_t pid: _children)
+		kill(pid, SIGTERM);
+
+	for (pid_t pid: _children)
+		waitpid(pid, NULL, 0);
+}
+
+pid_t LoopbackHarness::spawn(const std::string& path, const std::vector<std::string>& args, const std::string& cwd)
+{
+	std::vector<char*> argv;
+	argv.push_back((char*)path.c_str());
+	for (auto& arg: args)
+		argv.push_back((char*)arg.c_str());
+	argv.push_back(NULL);
+
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		//-- Don't outlive the harness.
+		prctl(PR_SET_PDEATHSIG, SIGTERM);
+		if (cwd.size() && chdir(cwd.c_str()) != 0)
+			_exit(127);
+
+		execv(path.c_str(), argv.data());
+		_exit(127);
+	}
+
+	if (pid > 0)
+		_children.push_back(pid);
+	else
+		cout<<"[Error] Fork "<<path<<" failed."<<endl;
+
+	return pid;
+}
+
+bool LoopbackHarness::startControlCenter(const std::string& path)
+{
+	if (access(path.c_str(), X_OK) != 0)
+	{
+		cout<<"[Error] DATControlCenter "<<path<<" is not executable. Build it, or use -e for a running one."<<endl;
+		return false;
+	}
+
+	std::string cachePath = _workDir + "/cache";
+	FileSystemUtil::createDirectories(cachePath.c_str());
+
+	std::string config = _workDir + "/controlCenter.conf";
+	std::ofstream out(config);
+	out<<"FPNN.server.listening.ip ="<<endl;
+	out<<"FPNN.server.listening.port = "<<_port<<endl;
+	out<<"FPNN.server.name = DATControlCenter"<<endl;
+	out<<"FPNN.server.log.level = ERROR"<<endl;
+	out<<"FPNN.server.log.endpoint = std::cout"<<endl;
+	out<<"FPNN.server.log.route = DATControlCenter"<<endl;
+	out<<"FPNN.server.duplex.thread.min.size = 4"<<endl;
+	out<<"FPNN.server.duplex.thread.max.size = 4"<<endl;
+	out<<"DATControlCenter.cachePath = "<<cachePath<<endl;
+	out.close();
+
+	return spawn(path, std::vector<std::string>{config}, _workDir) > 0;
+}
+
+//-- Deployer is not on the measured path, but it is polled by CC as in real tests.
+void LoopbackHarness::startDeployer(const std::string& path)
+{
+	if (access(path.c_str(), X_OK) != 0)
+	{
+		cout<<"[Warning] DATDeployer "<<path<<" is not executable, run without deployer."<<endl;
+		return;
+	}
+
+	std::string cachePath = _workDir + "/deployer";
+	FileSystemUtil::createDirectories(cachePath.c_str());
+	spawn(path, std::vector<std::string>{"-h", _endpoint, "-d", cachePath}, _workDir);
+}
+
+void LoopbackHarness::startActors()
+{
+	std::string self = FileSystemUtil::getSelfExectuedFilePath();
+	for (int i = 0; i < _actors; i++)
+		spawn(self, std::vector<std::string>{"--actor", "-e", _endpoint, "--workUsec", std::to_string(_workUsec)}, "");
+}
+
+bool LoopbackHarness::waitControlCenter()
+{
+	_client = TCPClient::createClient(_endpoint);
+	if (!_client)
+		return false;
+
+	_client->setQuestProcessor(std::make_shared<LoopbackControllerProcessor>(_hops));
+
+	for (int i = 0; i < 100; i++)
+	{
+		if (_client->connect())
+			return true;
+
+		usleep(100 * 1000);
+	}
+
+	cout<<"[Error] Connect DATControlCenter "<<_endpoint<<" failed."<<endl;
+	return false;
+}
+
+//-- actorTaskStatus fields: region, endpoint, actor, pid, taskId, method, desc
+bool LoopbackHarness::discoverActors()
+{
+	for (int i = 0; i < 100; i++)
+	{
+		FPAReader ar(_client->sendQuest(FPQWriter::emptyQuest("actorTaskStatus")));
+		if (ar.status() == 0)
+		{
+			std::vector<std::vector<std::string>> rows = ar.want("rows", std::vector<std::vector<std::string>>());
+			std::set<std::pair<std::string, int>> actors;
+			for (auto& row: rows)
+				if (row.size() > 3 && row[0] == gc_region && row[2] == gc_actorName)
+					actors.insert(std::make_pair(row[1], atoi(row[3].c_str())));
+
+			if ((int)actors.size() >= _actors)
+			{
+				_actorEndpoints.assign(actors.begin(), actors.end());
+				return true;
+			}
+		}
+
+		usleep(100 * 1000);
+	}
+
+	cout<<"[Error] Only "<<_actorEndpoints.size()<<" of "<<_actors<<" actors registered."<<endl;
+	return false;
+}
+
+bool LoopbackHarness::init()
+{
+	_actors = (int)CommandLineParser::getInt("actors", 4);
+	_rate = CommandLineParser::getReal("rate", 100);
+	_seconds = (int)CommandLineParser::getInt("seconds", 30);
+	_warmupSec = (int)CommandLineParser::getInt("warmup", 2);
+	_workUsec = (int)CommandLineParser::getInt("workUsec", 0);
+	_port = (int)CommandLineParser::getInt("port", 13666);
+
+	if (_actors <= 0 || _rate <= 0 || _seconds <= 0 || _warmupSec < 0)
+		return false;
+
+	_workDir = std::string("/tmp/DATLoopbackLatency-").append(std::to_string(getpid()));
+	FileSystemUtil::createDirectories(_workDir.c_str());
+
+	std::string dir = FileSystemUtil::getSelfExectuedFilePath();
+	dir = dir.substr(0, dir.find_last_of('/') + 1);
+
+	_endpoint = CommandLineParser::getString("e");
+	if (_endpoint.empty())
+	{
+		_endpoint = std::string("127.0.0.1:").append(std::to_string(_port));
+		if (!startControlCenter(CommandLineParser::getString("cc", dir + "../../DATControlCenter/DATControlCenter")))
+			return false;
+	}
+
+	if (!waitControlCenter())
+		return false;
+
+	if (!CommandLineParser::exist("noDeployer"))
+		startDeployer(CommandLineParser::getString("deployer", dir + "../../DATDeployer/DATDeployer"));
+
+	startActors();
+	return discoverActors();
+}
+
+void LoopbackHarness::sendAction(size_t index, int64_t seq)
+{
+	int64_t sendUsec = monotonicUsec();
+
+	FPWriter pw(2);
+	pw.param("seq", seq);
+	pw.param("sendUsec", sendUsec);
+
+	FPQWriter qw(6, "actorAction");
+	qw.param("actor", gc_actorName);
+	qw.param("endpoint", _actorEndpoints[index].first);
+	qw.param("pid", _actorEndpoints[index].second);
+	qw.param("method", "trace");
+	qw.param("payload", pw.raw());
+	qw.param("taskDesc", "loopback latency");
+
+	bool status = _client->sendQuest(qw.take(), [this, sendUsec](FPAnswerPtr answer, int errorCode){
+		if (errorCode != FPNN_EC_OK)
+			_hops.failed++;
+		else if (_hops.recording)
+			_hops.actionAnswer.record(monotonicUsec() - sendUsec);
+	});
+
+	if (!status)
+		_hops.failed++;
+}
+
+void LoopbackHarness::report()
+{
+	std::vector<std::string> fields{"hop"};
+	std::vector<std::string> histogramFields = LatencyHistogram::fields("");
+	for (auto& field: histogramFields)
+		fields.push_back(field + (field == "count" ? "" : "(us)"));
+
+	std::vector<std::pair<const char*, LatencyHistogram*>> hops{
+		{"controller->CC->actor", &_hops.dispatch},
+		{"actor", &_hops.actor},
+		{"actor->CC->controller", &_hops.resultForward},
+		{"actorAction answer", &_hops.actionAnswer},
+		{"end to end", &_hops.endToEnd} };
+
+	std::vector<std::vector<std::string>> rows;
+	for (auto& hop: hops)
+	{
+		rows.push_back(std::vector<std::string>{hop.first});
+		hop.second->appendRow(rows.back());
+	}
+
+	printTable(fields, rows);
+	cout<<"actions failed: "<<_hops.failed<<endl;
+}
+
+int LoopbackHarness::run()
+{
+	cout<<"Drive "<<_rate<<" actions/s over "<<_actorEndpoints.size()<<" actors, "<<_warmupSec<<" s warm up, "<<_seconds<<" s measured."<<endl;
+
+	int64_t begin = monotonicUsec();
+	int64_t recordBegin = begin + (int64_t)_warmupSec * 1000000;
+	int64_t end = recordBegin + (int64_t)_seconds * 1000000;
+	int64_t intervalUsec = (int64_t)(1000000 / _rate);
+	int64_t next = begin;
+	int64_t seq = 0;
+
+	while (true)
+	{
+		int64_t now = monotonicUsec();
+		if (now >= end)
+			break;
+
+		if (now >= recordBegin)
+			_hops.recording = true;
+
+		//-- Absolute schedule, so a slow send doesn't lower the rate. Catch up at most 1 second.
+		if (next < now - 1000000)
+			next = now - 1000000;
+
+		while (next <= now)
+		{
+			sendAction(seq % _actorEndpoints.size(), seq);
+			seq++;
+			next += intervalUsec;
+		}
+
+		usleep((useconds_t)(next - now < 10000 ? next - now : 10000));
+	}
+
+	//-- Results in flight.
+	sleep(1);
+	_hops.recording = false;
+
+	report();
+	return 0;
+}
+
+class ActorProcess
+{
+	TCPClientPtr _client;
+	std::string _endpoint;
+	int _workUsec;
+
+	bool registerActor()
+	{
+		FPQWriter qw(3, "registerActor");
+		qw.param("region", gc_region);
+		qw.param("name", gc_actorName);
+		qw.param("pid", (int64_t)getpid());
+
+		FPAReader ar(_client->sendQuest(qw.take()));
+		return ar.status() == 0;
+	}
+
+public:
+	ActorProcess(const std::string& endpoint, int workUsec): _endpoint(endpoint), _workUsec(workUsec) {}
+
+	int run()
+	{
+		_client = TCPClient::createClient(_endpoint, false);
+		if (!_client)
+			return -1;
+
+		_client->setQuestProcessor(std::make_shared<LoopbackActorProcessor>(gc_region, _workUsec));
+		if (!_client->connect() || !registerActor())
+		{
+			cout<<"[Error] Loopback actor "<<getpid()<<" register failed."<<endl;
+			return -1;
+		}
+
+		while (_client->connected())
+			sleep(1);
+
+		return 0;
+	}
+};
+
+int showUsage(const char* appName)
+{
+	cout<<"Usgae:"<<endl;
+	cout<<"\t"<<appName<<" [options]"<<endl;
+	cout<<"Options:"<<endl;
+	cout<<"\t-e endpoint            use a running DATControlCenter, don't start one"<<endl;
+	cout<<"\t--cc path              DATControlCenter executable, default: ../../DATControlCenter/DATControlCenter"<<endl;
+	cout<<"\t--port port            port of the started DATControlCenter, default: 13666"<<endl;
+	cout<<"\t--deployer path        DATDeployer executable, default: ../../DATDeployer/DATDeployer"<<endl;
+	cout<<"\t--noDeployer           don't start deployer"<<endl;
+	cout<<"\t--actors count         instrumented actors, default: 4"<<endl;
+	cout<<"\t--rate qps             actions per second of all actors, default: 100"<<endl;
+	cout<<"\t--seconds seconds      measured seconds, default: 30"<<endl;
+	cout<<"\t--warmup seconds       default: 2"<<endl;
+	cout<<"\t--workUsec usec        actor work before actorResult, default: 0"<<endl;
+	return -1;
+}
+
+int main(int argc, const char** argv)
+{
+	ignoreSignals();
+	ClientEngine::configAnswerCallbackThreadPool(2, 1, 2, 4);
+	ClientEngine::configQuestProcessThreadPool(2, 1, 2, 4, 0);
+
+	CommandLineParser::init(argc, argv);
+	if (CommandLineParser::exist("actor"))
+	{
+		ActorProcess actor(CommandLineParser::getString("e"), (int)CommandLineParser::getInt("workUsec", 0));
+		return actor.run();
+	}
+
+	LoopbackHarness harness;
+	if (!harness.init())
+		return showUsage(argv[0]);
+
+	return harness.run();
+}
@@ -0,0 +1,70 @@
+#include <time.h>
+#include <unistd.h>
+#include <iostream>
+#include "LoopbackQuestProcessor.h"
+
+using namespace std;
+
+int64_t monotonicUsec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+//-- payload: { seq:%d, sendUsec:%d }
+FPAnswerPtr LoopbackActorProcessor::action(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	int64_t receiveUsec = monotonicUsec();
+
+	int taskId = args->wantInt("taskId");
+	std::string payload = args->wantString("payload");
+
+	FPReader reader(payload);
+	int64_t seq = reader.wantInt("seq");
+	int64_t sendUsec = reader.wantInt("sendUsec");
+
+	if (_workUsec > 0)
+		usleep(_workUsec);
+
+	FPWriter pw(4);
+	pw.param("seq", seq);
+	pw.param("sendUsec", sendUsec);
+	pw.param("receiveUsec", receiveUsec);
+	pw.param("resultUsec", monotonicUsec());
+
+	FPQWriter qw(3, "actorResult");
+	qw.param("taskId", taskId);
+	qw.param("region", _region);
+	qw.param("payload", pw.raw());
+
+	QuestSenderPtr sender = genQuestSender(ci);
+	sender->sendQuest(qw.take(), [](FPAnswerPtr answer, int errorCode){
+		if (errorCode != FPNN_EC_OK)
+			cout<<"[Error] Send actorResult failed. error code: "<<errorCode<<endl;
+	});
+
+	return FPAWriter::emptyAnswer(quest);
+}
+
+FPAnswerPtr LoopbackControllerProcessor::actorResult(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	int64_t arriveUsec = monotonicUsec();
+
+	std::string payload = args->wantString("payload");
+	FPReader reader(payload);
+	int64_t sendUsec = reader.wantInt("sendUsec");
+	int64_t receiveUsec = reader.wantInt("receiveUsec");
+	int64_t resultUsec = reader.wantInt("resultUsec");
+
+	_hops.received++;
+	if (_hops.recording)
+	{
+		_hops.dispatch.record(receiveUsec - sendUsec);
+		_hops.actor.record(resultUsec - receiveUsec);
+		_hops.resultForward.record(arriveUsec - resultUsec);
+		_hops.endToEnd.record(arriveUsec - sendUsec);
+	}
+
+	return FPAWriter::emptyAnswer(quest);
+}
@@ -0,0 +1,76 @@
+#ifndef DAT_Loopback_Quest_Processor_h
+#define DAT_Loopback_Quest_Processor_h
+
+#include <atomic>
+#include "IQuestProcessor.h"
+#include "LatencyHistogram.h"
+
+using namespace fpnn;
+
+/*
+	Trace stamps of one action, all in CLOCK_MONOTONIC usec, which is shared by all processes on the host:
+		sendUsec:     controller sends actorAction.
+		receiveUsec:  actor receives action.
+		resultUsec:   actor sends actorResult.
+		arriveUsec:   controller receives the forwarded actorResult.
+*/
+int64_t monotonicUsec();
+
+struct LoopbackHops
+{
+	LatencyHistogram dispatch;		//-- controller -> CC actorAction -> actor action.
+	LatencyHistogram actor;			//-- action received -> actorResult sent.
+	LatencyHistogram actionAnswer;	//-- actorAction answered to controller, after actor answered CC.
+	LatencyHistogram resultForward;	//-- actor actorResult -> CC forwardActorStatus -> controller.
+	LatencyHistogram endToEnd;		//-- actorAction sent -> actorResult arrived.
+
+	std::atomic<uint64_t> failed;
+	std::atomic<uint64_t> received;
+	std::atomic<bool> recording;	//-- false during warm up.
+
+	LoopbackHops(): failed(0), received(0), recording(false) {}
+};
+
+//-- Instrumented actor: stamps action, and answers with actorResult immediately, or after workUsec.
+class LoopbackActorProcessor: public IQuestProcessor
+{
+	QuestProcessorClassPrivateFields(LoopbackActorProcessor)
+
+	std::string _region;
+	int _workUsec;
+
+public:
+	LoopbackActorProcessor(const std::string& region, int workUsec): _region(region), _workUsec(workUsec)
+	{
+		registerMethod("action", &LoopbackActorProcessor::action);
+	}
+
+	FPAnswerPtr action(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+
+	QuestProcessorClassBasicPublicFuncs
+};
+
+//-- Controller side: receives the forwarded actorResult, and fills hops.
+class LoopbackControllerProcessor: public IQuestProcessor
+{
+	QuestProcessorClassPrivateFields(LoopbackControllerProcessor)
+
+	LoopbackHops& _hops;
+
+public:
+	LoopbackControllerProcessor(LoopbackHops& hops): _hops(hops)
+	{
+		registerMethod("actorResult", &LoopbackControllerProcessor::actorResult);
+		registerMethod("actorStatus", &LoopbackControllerProcessor::actorStatus);
+	}
+
+	FPAnswerPtr actorResult(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr actorStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+	{
+		return FPAWriter::emptyAnswer(quest);
+	}
+
+	QuestProcessorClassBasicPublicFuncs
+};
+
+#endif
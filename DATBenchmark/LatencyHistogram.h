@@ -0,0 +1,155 @@
+#ifndef DAT_Latency_Histogram_h
+#define DAT_Latency_Histogram_h
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+	Log-linear latency histogram, in usec.
+
+	Each power of 2 is divided into 16 sub-buckets, so a percentile is at most 1/16 (6.25%) above the recorded value.
+	record() is lock free and can be called from any thread; the readers see a consistent view only when the recorders are quiet,
+	or after drainTo(), which moves the counts into a private histogram for an interval report.
+*/
+class LatencyHistogram
+{
+public:
+	static const int subBucketBits = 4;
+	static const int subBucketCount = 1 << subBucketBits;
+	static const int maxExponent = 40;		//-- 2^40 usec: about 12 days.
+	static const int bucketCount = (maxExponent - subBucketBits + 2) * subBucketCount;
+
+private:
+	std::vector<std::atomic<uint64_t>> _counts;
+	std::atomic<uint64_t> _total;
+	std::atomic<int64_t> _sum;
+	std::atomic<int64_t> _max;
+
+	static int bucketIndex(int64_t value)
+	{
+		if (value < subBucketCount)
+			return (value < 0) ? 0 : (int)value;
+
+		int exponent = 63 - __builtin_clzll((uint64_t)value);
+		if (exponent > maxExponent)
+			return bucketCount - 1;
+
+		int sub = (int)(value >> (exponent - subBucketBits)) & (subBucketCount - 1);
+		return (exponent - subBucketBits + 1) * subBucketCount + sub;
+	}
+
+	//-- The largest value falls into the bucket.
+	static int64_t bucketUpperBound(int index)
+	{
+		if (index < subBucketCount)
+			return index;
+
+		int exponent = index / subBucketCount + subBucketBits - 1;
+		int sub = index % subBucketCount;
+		int shift = exponent - subBucketBits;
+		return ((int64_t)(subBucketCount + sub + 1) << shift) - 1;
+	}
+
+public:
+	LatencyHistogram(): _counts(bucketCount), _total(0), _sum(0), _max(0)
+	{
+		for (auto& count: _counts)
+			count.store(0, std::memory_order_relaxed);
+	}
+
+	void record(int64_t usec)
+	{
+		_counts[bucketIndex(usec)].fetch_add(1, std::memory_order_relaxed);
+		_total.fetch_add(1, std::memory_order_relaxed);
+		_sum.fetch_add(usec, std::memory_order_relaxed);
+
+		int64_t max = _max.load(std::memory_order_relaxed);
+		while (usec > max && !_max.compare_exchange_weak(max, usec, std::memory_order_relaxed))
+			continue;
+	}
+
+	//-- Move all counts into target, and this histogram restarts from empty.
+	void drainTo(LatencyHistogram& target)
+	{
+		for (int i = 0; i < bucketCount; i++)
+		{
+			uint64_t count = _counts[i].exchange(0, std::memory_order_relaxed);
+			if (count)
+				target._counts[i].fetch_add(count, std::memory_order_relaxed);
+		}
+
+		target._total.fetch_add(_total.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+		target._sum.fetch_add(_sum.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+
+		int64_t max = _max.exchange(0, std::memory_order_relaxed);
+		if (max > target._max.load(std::memory_order_relaxed))
+			target._max.store(max, std::memory_order_relaxed);
+	}
+
+	void reset()
+	{
+		for (auto& count: _counts)
+			count.store(0, std::memory_order_relaxed);
+
+		_total = 0;
+		_sum = 0;
+		_max = 0;
+	}
+
+	uint64_t count() const { return _total.load(std::memory_order_relaxed); }
+	int64_t max() const { return _max.load(std::memory_order_relaxed); }
+	double mean() const
+	{
+		uint64_t total = count();
+		return total ? (double)_sum.load(std::memory_order_relaxed) / total : 0;
+	}
+
+	//-- percent: 0 ~ 100. Returns 0 if empty.
+	int64_t percentile(double percent) const
+	{
+		uint64_t total = count();
+		if (total == 0)
+			return 0;
+
+		uint64_t rank = (uint64_t)(total * percent / 100);
+		if (rank < 1)
+			rank = 1;
+		else if (rank > total)
+			rank = total;
+
+		uint64_t seen = 0;
+		for (int i = 0; i < bucketCount; i++)
+		{
+			seen += _counts[i].load(std::memory_order_relaxed);
+			if (seen >= rank)
+			{
+				int64_t bound = bucketUpperBound(i);
+				int64_t max = this->max();
+				return (bound < max) ? bound : max;
+			}
+		}
+		return max();
+	}
+
+	//-- Fields: count, mean, p50, p90, p99, p99.9, max. All in usec.
+	static std::vector<std::string> fields(const std::string& prefix)
+	{
+		return std::vector<std::string>{ prefix + "count", prefix + "mean", prefix + "p50", prefix + "p90",
+			prefix + "p99", prefix + "p99.9", prefix + "max" };
+	}
+
+	void appendRow(std::vector<std::string>& row) const
+	{
+		row.push_back(std::to_string(count()));
+		row.push_back(std::to_string((int64_t)mean()));
+		row.push_back(std::to_string(percentile(50)));
+		row.push_back(std::to_string(percentile(90)));
+		row.push_back(std::to_string(percentile(99)));
+		row.push_back(std::to_string(percentile(99.9)));
+		row.push_back(std::to_string(max()));
+	}
+};
+
+#endif
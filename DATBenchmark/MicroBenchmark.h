@@ -0,0 +1,305 @@
+#ifndef DAT_Micro_Benchmark_h
+#define DAT_Micro_Benchmark_h
+
+#include <time.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+/*
+	Minimal Google Benchmark style runner, without the dependency.
+
+		void BM_Func(BenchmarkState& state)
+		{
+			... prepare with state.range() entries ...
+			while (state.keepRunning())
+				... measured code ...
+			state.setItemsProcessed(state.iterations() * state.range());
+			state.setCounter("bytesPerItem", ...);		//-- optional user counters
+		}
+		DAT_BENCHMARK(BM_Func, 10, 100, 1000);
+
+		int main(int argc, const char** argv) { return MicroBenchmark::runAll(argc, argv); }
+
+	Options: --filter substring, --format console|json|csv, --minTime seconds.
+	JSON output uses the field names of Google Benchmark, user counters as extra keys, so results can be compared by the same scripts.
+*/
+
+template <class T>
+inline void doNotOptimize(T const& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class BenchmarkState
+{
+	int64_t _range;
+	uint64_t _iterations;
+	uint64_t _remain;
+	bool _started;
+	int64_t _itemsProcessed;
+	int64_t _realNsec;
+	int64_t _cpuNsec;
+	int64_t _realBegin;
+	int64_t _cpuBegin;
+	std::vector<std::pair<std::string, double>> _counters;
+
+	static int64_t now(clockid_t clock)
+	{
+		struct timespec ts;
+		clock_gettime(clock, &ts);
+		return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
+
+public:
+	BenchmarkState(int64_t range, uint64_t iterations): _range(range), _iterations(iterations), _remain(iterations),
+		_started(false), _itemsProcessed(-1), _realNsec(0), _cpuNsec(0), _realBegin(0), _cpuBegin(0) {}
+
+	//-- Timing starts at the first call, and stops when iterations are done.
+	bool keepRunning()
+	{
+		if (!_started)
+		{
+			_started = true;
+			resumeTiming();
+		}
+
+		if (_remain)
+		{
+			_remain--;
+			return true;
+		}
+
+		pauseTiming();
+		return false;
+	}
+
+	//-- Exclude per iteration setup from timing.
+	void pauseTiming()
+	{
+		_realNsec += now(CLOCK_MONOTONIC) - _realBegin;
+		_cpuNsec += now(CLOCK_PROCESS_CPUTIME_ID) - _cpuBegin;
+	}
+	void resumeTiming()
+	{
+		_realBegin = now(CLOCK_MONOTONIC);
+		_cpuBegin = now(CLOCK_PROCESS_CPUTIME_ID);
+	}
+
+	int64_t range() const { return _range; }
+	uint64_t iterations() const { return _iterations; }
+	void setItemsProcessed(int64_t items) { _itemsProcessed = items; }
+	void setCounter(const std::string& name, double value) { _counters.emplace_back(name, value); }
+
+	int64_t itemsProcessed() const { return _itemsProcessed; }
+	int64_t realNsec() const { return _realNsec; }
+	int64_t cpuNsec() const { return _cpuNsec; }
+	const std::vector<std::pair<std::string, double>>& counters() const { return _counters; }
+};
+
+typedef std::function<void (BenchmarkState&)> BenchmarkFunc;
+
+class MicroBenchmark
+{
+	struct Case
+	{
+		std::string name;
+		BenchmarkFunc func;
+		std::vector<int64_t> ranges;
+	};
+
+	struct Result
+	{
+		std::string name;
+		uint64_t iterations;
+		double realNsec;		//-- per iteration
+		double cpuNsec;			//-- per iteration
+		double itemsPerSecond;	//-- negative: not set.
+		std::vector<std::pair<std::string, double>> counters;
+	};
+
+	static std::vector<Case>& cases()
+	{
+		static std::vector<Case> registered;
+		return registered;
+	}
+
+	//-- Grow iterations until a run lasts minTime, as Google Benchmark does.
+	static Result runCase(const Case& bm, int64_t range, double minTime)
+	{
+		uint64_t iterations = 1;
+		while (true)
+		{
+			BenchmarkState state(range, iterations);
+			bm.func(state);
+
+			double seconds = state.realNsec() / 1e9;
+			if (seconds >= minTime || iterations >= 1000000000)
+			{
+				Result result;
+				result.name = bm.name + "/" + std::to_string(range);
+				result.iterations = iterations;
+				result.realNsec = (double)state.realNsec() / iterations;
+				result.cpuNsec = (double)state.cpuNsec() / iterations;
+				result.itemsPerSecond = (state.itemsProcessed() >= 0 && seconds > 0) ? state.itemsProcessed() / seconds : -1;
+				result.counters = state.counters();
+				return result;
+			}
+
+			double multiplier = (seconds > 0) ? minTime * 1.4 / seconds : 10;
+			if (multiplier > 10)
+				multiplier = 10;
+			uint64_t next = (uint64_t)(iterations * multiplier);
+			iterations = (next > iterations) ? next : iterations + 1;
+		}
+	}
+
+	static void printConsole(const Result& result)
+	{
+		char line[256];
+		snprintf(line, sizeof(line), "%-48s %14.0f ns %14.0f ns %12llu", result.name.c_str(), result.realNsec, result.cpuNsec,
+			(unsigned long long)result.iterations);
+		std::cout<<line;
+		if (result.itemsPerSecond >= 0)
+			std::cout<<"  items/s: "<<(int64_t)result.itemsPerSecond;
+		for (auto& counter: result.counters)
+			std::cout<<"  "<<counter.first<<": "<<counter.second;
+		std::cout<<std::endl;
+	}
+
+	static void printJson(const std::vector<Result>& results)
+	{
+		char host[256] = {0};
+		gethostname(host, sizeof(host) - 1);
+
+		time_t now = time(NULL);
+		char date[64];
+		strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+
+		std::cout<<"{"<<std::endl;
+		std::cout<<"  \"context\": {"<<std::endl;
+		std::cout<<"    \"date\": \""<<date<<"\","<<std::endl;
+		std::cout<<"    \"host_name\": \""<<host<<"\","<<std::endl;
+		std::cout<<"    \"num_cpus\": "<<sysconf(_SC_NPROCESSORS_ONLN)<<std::endl;
+		std::cout<<"  },"<<std::endl;
+		std::cout<<"  \"benchmarks\": ["<<std::endl;
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const Result& result = results[i];
+			std::cout<<"    {"<<std::endl;
+			std::cout<<"      \"name\": \""<<result.name<<"\","<<std::endl;
+			std::cout<<"      \"iterations\": "<<result.iterations<<","<<std::endl;
+			std::cout<<"      \"real_time\": "<<std::to_string(result.realNsec)<<","<<std::endl;
+			std::cout<<"      \"cpu_time\": "<<std::to_string(result.cpuNsec)<<","<<std::endl;
+			if (result.itemsPerSecond >= 0)
+				std::cout<<"      \"items_per_second\": "<<std::to_string(result.itemsPerSecond)<<","<<std::endl;
+			for (auto& counter: result.counters)
+				std::cout<<"      \""<<counter.first<<"\": "<<std::to_string(counter.second)<<","<<std::endl;
+			std::cout<<"      \"time_unit\": \"ns\""<<std::endl;
+			std::cout<<"    }"<<(i + 1 < results.size() ? "," : "")<<std::endl;
+		}
+		std::cout<<"  ]"<<std::endl;
+		std::cout<<"}"<<std::endl;
+	}
+
+	static void printCsv(const std::vector<Result>& results)
+	{
+		std::vector<std::string> counterNames;
+		for (auto& result: results)
+			for (auto& counter: result.counters)
+				if (std::find(counterNames.begin(), counterNames.end(), counter.first) == counterNames.end())
+					counterNames.push_back(counter.first);
+
+		std::cout<<"name,iterations,real_time,cpu_time,time_unit,items_per_second";
+		for (auto& name: counterNames)
+			std::cout<<","<<name;
+		std::cout<<std::endl;
+
+		for (auto& result: results)
+		{
+			std::cout<<result.name<<","<<result.iterations<<","<<std::to_string(result.realNsec)<<","<<std::to_string(result.cpuNsec)<<",ns,";
+			if (result.itemsPerSecond >= 0)
+				std::cout<<std::to_string(result.itemsPerSecond);
+
+			for (auto& name: counterNames)
+			{
+				std::cout<<",";
+				for (auto& counter: result.counters)
+					if (counter.first == name)
+						std::cout<<std::to_string(counter.second);
+			}
+			std::cout<<std::endl;
+		}
+	}
+
+public:
+	static int add(const std::string& name, BenchmarkFunc func, const std::vector<int64_t>& ranges)
+	{
+		Case bm;
+		bm.name = name;
+		bm.func = func;
+		bm.ranges = ranges.empty() ? std::vector<int64_t>{0} : ranges;
+		cases().push_back(bm);
+		return (int)cases().size();
+	}
+
+	static int runAll(int argc, const char** argv)
+	{
+		std::string filter, format("console");
+		double minTime = 0.5;
+
+		for (int i = 1; i < argc; i += 2)
+		{
+			bool hasValue = (i + 1 < argc);
+			if (hasValue && strcmp(argv[i], "--filter") == 0)
+				filter = argv[i + 1];
+			else if (hasValue && strcmp(argv[i], "--format") == 0)
+				format = argv[i + 1];
+			else if (hasValue && strcmp(argv[i], "--minTime") == 0)
+				minTime = atof(argv[i + 1]);
+			else
+			{
+				std::cout<<"Usage: "<<argv[0]<<" [--filter substring] [--format console|json|csv] [--minTime seconds]"<<std::endl;
+				return -1;
+			}
+		}
+
+		bool console = (format == "console");
+		if (console)
+		{
+			char header[256];
+			snprintf(header, sizeof(header), "%-48s %17s %17s %12s", "Benchmark", "Time", "CPU", "Iterations");
+			std::cout<<header<<std::endl<<std::string(96, '-')<<std::endl;
+		}
+
+		std::vector<Result> results;
+		for (auto& bm: cases())
+		{
+			if (filter.size() && bm.name.find(filter) == std::string::npos)
+				continue;
+
+			for (int64_t range: bm.ranges)
+			{
+				results.push_back(runCase(bm, range, minTime));
+				if (console)
+					printConsole(results.back());
+			}
+		}
+
+		if (format == "json")
+			printJson(results);
+		else if (format == "csv")
+			printCsv(results);
+
+		return 0;
+	}
+};
+
+#define DAT_BENCHMARK(func, ...) static int func##Registered = MicroBenchmark::add(#func, func, std::vector<int64_t>{__VA_ARGS__})
+
+#endif
@@ -0,0 +1,164 @@
+#include <errno.h>
+#include <time.h>
+#include <iostream>
+#include "FPWriter.h"
+#include "RecordsCompressor.h"
+#include "BurstSampler.h"
+
+using namespace std;
+using namespace fpnn;
+
+const std::vector<std::string> gc_burstSampleFields{"offsetMsec", "cpu%", "usr%", "sys%", "iowait%", "softirq%", "steal%",
+	"maxCore%", "maxCore", "tcpCount", "RX", "TX", "tcpRetrans", "tcpOutRsts", "listenDrops", "majorFaults", "diskIOPS", "maxDiskUtil%"};
+
+BurstSampler::~BurstSampler()
+{
+	if (_thread.joinable())
+		_thread.join();
+}
+
+bool BurstSampler::start(int intervalMs, int durationSec, BurstUploader uploader, int& count)
+{
+	if (intervalMs < minIntervalMs)
+		intervalMs = minIntervalMs;
+
+	if (durationSec <= 0)
+		durationSec = 1;
+	else if (durationSec > maxDurationSec)
+		durationSec = maxDurationSec;
+
+	count = durationSec * 1000 / intervalMs;
+	if (count > maxSamples)
+		count = maxSamples;
+
+	std::unique_lock<std::mutex> lck(_mutex);
+	if (_running)
+		return false;
+
+	//-- Previous burst thread has finished but not been joined.
+	if (_thread.joinable())
+		_thread.join();
+
+	_running = true;
+	_thread = std::thread(&BurstSampler::run, this, intervalMs, count, uploader);
+	return true;
+}
+
+static void addMsec(struct timespec& ts, int msec)
+{
+	ts.tv_nsec += (long)(msec % 1000) * 1000000;
+	ts.tv_sec += msec / 1000 + ts.tv_nsec / 1000000000;
+	ts.tv_nsec %= 1000000000;
+}
+
+void BurstSampler::run(int intervalMs, int count, BurstUploader uploader)
+{
+	const size_t fieldCount = gc_burstSampleFields.size();
+	std::vector<float> buffer(fieldCount * count);
+
+	//-- Reused to keep cores & disks vectors' capacity.
+	struct MachineSample sample;
+	_collector.sample(sample);
+	uint64_t lastRX = sample.recvBytes;
+	uint64_t lastTX = sample.sendBytes;
+
+	struct timespec begin, next;
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+	struct timespec realBegin;
+	clock_gettime(CLOCK_REALTIME, &realBegin);
+	next = begin;
+
+	for (int i = 0; i < count; i++)
+	{
+		//-- Absolute deadlines: sampling cost doesn't accumulate as drift.
+		addMsec(next, intervalMs);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+			continue;
+
+		_collector.sample(sample);
+
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+
+		float diskIOPS = 0, maxDiskUtil = 0;
+		for (auto& disk: sample.disks)
+		{
+			diskIOPS += disk.readIops + disk.writeIops;
+			if (disk.util > maxDiskUtil)
+				maxDiskUtil = disk.util;
+		}
+
+		float* row = &buffer[i * fieldCount];
+		row[0] = (now.tv_sec - begin.tv_sec) * 1000.0f + (now.tv_nsec - begin.tv_nsec) / 1000000.0f;
+		row[1] = sample.cpu.util;
+		row[2] = sample.cpu.user;
+		row[3] = sample.cpu.system;
+		row[4] = sample.cpu.iowait;
+		row[5] = sample.cpu.softirq;
+		row[6] = sample.cpu.steal;
+		row[7] = sample.maxCoreUtil;
+		row[8] = (float)sample.maxCore;
+		row[9] = (float)sample.tcpConn;
+		row[10] = (float)(sample.recvBytes - lastRX);
+		row[11] = (float)(sample.sendBytes - lastTX);
+		row[12] = (float)sample.net.counters[TcpRetransSegs];
+		row[13] = (float)sample.net.counters[TcpOutRsts];
+		row[14] = (float)sample.net.counters[TcpListenDrops];
+		row[15] = (float)sample.vm.majorFaults;
+		row[16] = diskIOPS;
+		row[17] = maxDiskUtil;
+
+		lastRX = sample.recvBytes;
+		lastTX = sample.sendBytes;
+	}
+
+	//-- Columns compress much better than rows.
+	std::vector<std::vector<float>> columns(fieldCount);
+	for (size_t f = 0; f < fieldCount; f++)
+	{
+		columns[f].resize(count);
+		for (int i = 0; i < count; i++)
+			columns[f][i] = buffer[i * fieldCount + f];
+	}
+
+	FPWriter pw(4);
+	pw.param("startMsec", (int64_t)realBegin.tv_sec * 1000 + realBegin.tv_nsec / 1000000);
+	pw.param("intervalMs", intervalMs);
+	pw.param("fields", gc_burstSampleFields);
+	pw.param("columns", columns);
+	std::string records = pw.raw();
+
+	size_t rawSize = records.size();
+	bool zip = compressRecords(records);
+
+	uploader(records, zip, rawSize, count);
+
+	std::unique_lock<std::mutex> lck(_mutex);
+	_running = false;
+}
+
+FPAnswerPtr BurstSampler::burstSample(const FPReaderPtr args, const FPQuestPtr quest, QuestSenderPtr sender)
+{
+	int taskId = args->wantInt("taskId");
+	int intervalMs = (int)args->getInt("intervalMs", minIntervalMs);
+	int durationSec = (int)args->wantInt("durationSec");
+
+	int count = 0;
+	bool started = start(intervalMs, durationSec, [sender, taskId](const std::string& records, bool zip, size_t rawSize, int samples){
+		FPQWriter qw(5, "burstSampleData");
+		qw.param("taskId", taskId);
+		qw.param("count", samples);
+		qw.param("zip", zip);
+		qw.param("rawSize", rawSize);
+		qw.paramBinary("records", records.data(), records.size());
+
+		bool status = sender->sendQuest(qw.take(), [taskId](FPAnswerPtr answer, int errorCode){
+			if (errorCode != FPNN_EC_OK)
+				cout<<"[Error] Upload burst samples of task "<<taskId<<" failed. error code: "<<errorCode<<endl;
+		});
+		if (!status)
+			cout<<"[Error] Upload burst samples of task "<<taskId<<" failed. Connection is closed."<<endl;
+	}, count);
+
+	return FPAWriter(2, quest)("ok", started)("samples", count);
+}
@@ -0,0 +1,50 @@
+#ifndef DAT_Burst_Sampler_h
+#define DAT_Burst_Sampler_h
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <thread>
+#include <functional>
+#include "IQuestProcessor.h"
+#include "ProcCollector.h"
+
+using namespace fpnn;
+
+//-- records: msgpack { startMsec:%d, intervalMs:%d, fields:[%s], columns:[[%f]] }, zlib compressed if zip.
+typedef std::function<void (const std::string& records, bool zip, size_t rawSize, int count)> BurstUploader;
+
+/*
+	High frequency sampling for a short period, used to catch stalls shorter than machine status interval.
+
+	Samples are written into a buffer allocated before the burst, nothing is sent during the burst.
+	The burst owns its ProcCollector, so the deltas of regular machineStatus are not disturbed.
+	When the burst ends, uploader is called in the sampling thread with the whole buffer encoded column by column.
+
+	Note: /proc/stat is in USER_HZ (100) ticks, so cpu percentages of 10 ms samples have 1 tick resolution per core.
+*/
+class BurstSampler
+{
+	std::mutex _mutex;
+	bool _running;
+	std::thread _thread;
+	ProcCollector _collector;
+
+	void run(int intervalMs, int count, BurstUploader uploader);
+
+public:
+	BurstSampler(): _running(false) {}
+	~BurstSampler();
+
+	//-- Return false if another burst is running.
+	bool start(int intervalMs, int durationSec, BurstUploader uploader, int& count);
+
+	//-- burstSample quest of deployer & monitor. Samples are uploaded to sender as burstSampleData.
+	FPAnswerPtr burstSample(const FPReaderPtr args, const FPQuestPtr quest, QuestSenderPtr sender);
+
+	static const int minIntervalMs = 10;
+	static const int maxDurationSec = 300;
+	static const int maxSamples = 30000;
+};
+
+#endif
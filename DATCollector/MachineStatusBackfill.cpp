@@ -0,0 +1,92 @@
+#include <iostream>
+#include "msec.h"
+#include "FPWriter.h"
+#include "RecordsCompressor.h"
+#include "MachineStatusBackfill.h"
+
+using namespace std;
+
+void MachineStatusBackfill::record(ProcCollector& collector)
+{
+	struct MachineSample sample;
+	collector.sample(sample);
+
+	FPWriter pw(gc_machineSampleFieldCount + 1);
+	pw.param("time", slack_real_sec());
+	writeMachineSample(pw, sample);
+
+	std::unique_lock<std::mutex> lck(_mutex);
+	_records.push_back(pw.raw());
+	while (_records.size() > _capacity)
+		_records.pop_front();
+}
+
+void MachineStatusBackfill::take(std::vector<std::string>& records)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	size_t count = (_records.size() < chunkSize) ? _records.size() : chunkSize;
+
+	records.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		records.push_back(std::string());
+		records.back().swap(_records.front());
+		_records.pop_front();
+	}
+}
+
+//-- Sending failed. Put back before the samples taken during sending, and keep the newest ones if overflow.
+void MachineStatusBackfill::restore(std::vector<std::string>& records)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	_records.insert(_records.begin(), records.begin(), records.end());
+	while (_records.size() > _capacity)
+		_records.pop_front();
+
+	_sending = false;
+}
+
+void MachineStatusBackfill::backfill(TCPClientPtr client)
+{
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		if (_sending || _records.empty())
+			return;
+
+		_sending = true;
+	}
+
+	std::shared_ptr<std::vector<std::string>> records(new std::vector<std::string>());
+	take(*records);
+
+	FPWriter pw(1);
+	pw.param("records", *records);
+	std::string raw = pw.raw();
+
+	size_t rawSize = raw.size();
+	bool zip = compressRecords(raw);
+
+	FPQWriter qw(4, "machineStatusBackfill");
+	qw.param("count", records->size());
+	qw.param("zip", zip);
+	qw.param("rawSize", rawSize);
+	qw.paramBinary("records", raw.data(), raw.size());
+
+	bool status = client->sendQuest(qw.take(), [this, client, records](FPAnswerPtr answer, int errorCode){
+		if (errorCode != FPNN_EC_OK)
+		{
+			cout<<"[Error] Backfill "<<records->size()<<" machine status samples failed. error code: "<<errorCode<<endl;
+			restore(*records);
+			return;
+		}
+
+		{
+			std::unique_lock<std::mutex> lck(_mutex);
+			_sending = false;
+		}
+		backfill(client);
+	});
+
+	if (!status)
+		restore(*records);
+}
@@ -0,0 +1,41 @@
+#ifndef DAT_Machine_Status_Backfill_h
+#define DAT_Machine_Status_Backfill_h
+
+#include <mutex>
+#include <deque>
+#include <string>
+#include <vector>
+#include "TCPClient.h"
+#include "ProcCollector.h"
+
+using namespace fpnn;
+
+/*
+	Machine status sampled while agent is disconnected from control center.
+
+	Samples are kept in a bounded in-memory ring, each one is encoded as machineStatus answer fields with its sample time.
+	When ring is full, the oldest sample is dropped. Ring capacity is the same as the machine status history of control center.
+	After agent re-registered, samples are sent back by machineStatusBackfill quests in chunks, oldest first.
+*/
+class MachineStatusBackfill
+{
+	std::mutex _mutex;
+	std::deque<std::string> _records;
+	size_t _capacity;
+	bool _sending;
+
+	void take(std::vector<std::string>& records);
+	void restore(std::vector<std::string>& records);
+
+public:
+	MachineStatusBackfill(size_t capacity = 300): _capacity(capacity), _sending(false) {}
+
+	void record(ProcCollector& collector);
+
+	//-- Send a chunk; the next chunk is sent when the previous one answered.
+	void backfill(TCPClientPtr client);
+
+	static const size_t chunkSize = 100;
+};
+
+#endif
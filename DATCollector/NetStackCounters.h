@@ -0,0 +1,36 @@
+#ifndef DAT_Net_Stack_Counters_h
+#define DAT_Net_Stack_Counters_h
+
+/*
+	TCP/UDP stack counters from /proc/net/snmp & /proc/net/netstat, deltas between two successive samples.
+	Index of NetStackSample::counters.
+	Shared by agents, CC tables and simulators, so the netStack names are defined only here.
+*/
+enum NetStackCounter
+{
+	TcpRetransSegs,
+	TcpOutRsts,
+	TcpEstabResets,
+	TcpInErrs,
+	TcpListenOverflows,
+	TcpListenDrops,
+	TcpSyncookiesSent,
+	TcpSyncookiesRecv,
+	TcpSyncookiesFailed,
+	UdpRcvbufErrors,
+	UdpInErrors,
+	UdpSndbufErrors,
+	NetStackCounterCount
+};
+
+//-- Field names in machineStatus netStack, ordered as NetStackCounter.
+const char* const gc_netStackCounterNames[NetStackCounterCount] = {
+	"tcpRetrans", "tcpOutRsts", "tcpEstabResets", "tcpInErrs",
+	"listenOverflows", "listenDrops", "syncookiesSent", "syncookiesRecv", "syncookiesFailed",
+	"udpRcvbufErrors", "udpInErrors", "udpSndbufErrors"
+};
+
+//-- Current TIME_WAIT sockets, reported in netStack with the counters.
+const char* const gc_netStackTimeWaitName = "timeWait";
+
+#endif
@@ -0,0 +1,539 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/sysinfo.h>
+#include "msec.h"
+#include "ProcCollector.h"
+
+const size_t gc_procBufferSize = 256 * 1024;
+
+struct NetStackCounterSource
+{
+	const char* section;
+	const char* name;
+	NetStackCounter counter;
+};
+
+//-- Grouped by section.
+static const struct NetStackCounterSource gc_netStackCounterSources[] = {
+	{ "Tcp", "RetransSegs", TcpRetransSegs },
+	{ "Tcp", "OutRsts", TcpOutRsts },
+	{ "Tcp", "EstabResets", TcpEstabResets },
+	{ "Tcp", "InErrs", TcpInErrs },
+	{ "TcpExt", "ListenOverflows", TcpListenOverflows },
+	{ "TcpExt", "ListenDrops", TcpListenDrops },
+	{ "TcpExt", "SyncookiesSent", TcpSyncookiesSent },
+	{ "TcpExt", "SyncookiesRecv", TcpSyncookiesRecv },
+	{ "TcpExt", "SyncookiesFailed", TcpSyncookiesFailed },
+	{ "Udp", "RcvbufErrors", UdpRcvbufErrors },
+	{ "Udp", "InErrors", UdpInErrors },
+	{ "Udp", "SndbufErrors", UdpSndbufErrors },
+};
+
+ProcFile::~ProcFile()
+{
+	if (_fd >= 0)
+		::close(_fd);
+}
+
+bool ProcFile::open(const std::string& path)
+{
+	_path = path;
+	_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (_fd < 0)
+		return false;
+
+	_existed = true;
+	return true;
+}
+
+ssize_t ProcFile::read(char* buffer, size_t size)
+{
+	if (_fd < 0)
+	{
+		if (_path.empty() || !open(_path))
+			return -1;
+	}
+
+	size_t total = 0;
+	while (total < size - 1)
+	{
+		ssize_t len = pread(_fd, buffer + total, size - 1 - total, total);
+		if (len > 0)
+		{
+			total += len;
+			continue;
+		}
+
+		if (len == 0)
+			break;
+
+		if (errno == EINTR)
+			continue;
+
+		//-- e.g. network namespace changed. Reopen next time.
+		::close(_fd);
+		_fd = -1;
+		return -1;
+	}
+
+	buffer[total] = '\0';
+	return (ssize_t)total;
+}
+
+ProcCollector::ProcCollector(): _buffer(gc_procBufferSize)
+{
+	_loadavg.open("/proc/loadavg");
+	_sockstat.open("/proc/net/sockstat");
+	_netdev.open("/proc/net/dev");
+	_stat.open("/proc/stat");
+	_snmp.open("/proc/net/snmp");
+	_netstat.open("/proc/net/netstat");
+	_pressureCpu.open("/proc/pressure/cpu");
+	_pressureMemory.open("/proc/pressure/memory");
+	_pressureIo.open("/proc/pressure/io");
+	_diskstats.open("/proc/diskstats");
+	_vmstat.open("/proc/vmstat");
+
+	memset(&_lastTotalTicks, 0, sizeof(_lastTotalTicks));
+	memset(_netCounters, 0, sizeof(_netCounters));
+	memset(_lastNetCounters, 0, sizeof(_lastNetCounters));
+	_netCountersReady = false;
+
+	_lastDiskMsec = 0;
+	memset(_lastVmCounters, 0, sizeof(_lastVmCounters));
+	_vmCountersReady = false;
+}
+
+bool ProcCollector::physicalInterface(const char* name, size_t len)
+{
+	if (len < 3)
+		return false;
+
+	return (memcmp(name, "eth", 3) == 0 || memcmp(name, "ens", 3) == 0
+		|| memcmp(name, "eno", 3) == 0 || memcmp(name, "enp", 3) == 0);
+}
+
+float ProcCollector::loadAverage()
+{
+	ssize_t len = _loadavg.read(_buffer.data(), _buffer.size());
+	if (len <= 0)
+		return -1;
+
+	ProcScanner scanner(_buffer.data(), len);
+	return (float)scanner.parseDouble();		//-- load average within 1 minute
+}
+
+void ProcCollector::connections(int& tcpConn, int& udpConn, int& timeWait)
+{
+	tcpConn = -1;
+	udpConn = -1;
+	timeWait = -1;
+
+	ssize_t len = _sockstat.read(_buffer.data(), _buffer.size());
+	if (len <= 0)
+		return;
+
+	//-- TCP: inuse 10 orphan 0 tw 3 alloc 12 mem 1
+	//-- UDP: inuse 2 mem 1
+	ProcScanner scanner(_buffer.data(), len);
+	do
+	{
+		if (scanner.match("TCP:", 4))
+		{
+			if (scanner.match("inuse", 5))
+				tcpConn = (int)scanner.parseUInt();
+			if (scanner.match("orphan", 6))
+				scanner.parseUInt();
+			if (scanner.match("tw", 2))
+				timeWait = (int)scanner.parseUInt();
+		}
+		else if (scanner.match("UDP:", 4))
+		{
+			if (scanner.match("inuse", 5))
+				udpConn = (int)scanner.parseUInt();
+		}
+
+	} while (scanner.nextLine());
+}
+
+/*
+	/proc/net/snmp & /proc/net/netstat are pairs of lines:
+		Tcp: RtoAlgorithm RtoMin RtoMax ...
+		Tcp: 1 200 120000 ...
+*/
+void ProcCollector::parseCounterPairs(ProcFile& file)
+{
+	ssize_t len = file.read(_buffer.data(), _buffer.size());
+	if (len <= 0)
+		return;
+
+	const size_t sourceCount = sizeof(gc_netStackCounterSources) / sizeof(gc_netStackCounterSources[0]);
+
+	ProcScanner header(_buffer.data(), len);
+	while (!header.eof())
+	{
+		const char* section;
+		size_t sectionLen;
+		header.token(section, sectionLen);
+		header.skipChar(':');
+
+		ProcScanner values = header;
+		if (!values.nextLine())
+			break;
+
+		const char* valueSection;
+		size_t valueSectionLen;
+		values.token(valueSection, valueSectionLen);
+		values.skipChar(':');
+
+		if (sectionLen == 0 || valueSectionLen != sectionLen || memcmp(section, valueSection, sectionLen) != 0)
+		{
+			header.nextLine();
+			continue;
+		}
+
+		//-- Most sections (Ip, Icmp, IpExt ...) are not concerned. Skip them without scanning.
+		size_t begin = sourceCount, end = sourceCount;
+		for (size_t i = 0; i < sourceCount; i++)
+		{
+			const char* wanted = gc_netStackCounterSources[i].section;
+			bool same = (strlen(wanted) == sectionLen && memcmp(wanted, section, sectionLen) == 0);
+			if (same && begin == sourceCount)
+				begin = i;
+			else if (!same && begin != sourceCount)
+			{
+				end = i;
+				break;
+			}
+		}
+
+		const char* name;
+		size_t nameLen;
+		while (begin < end && header.token(name, nameLen))
+		{
+			int64_t value = values.parseInt();
+			for (size_t i = begin; i < end; i++)
+			{
+				const struct NetStackCounterSource& source = gc_netStackCounterSources[i];
+				if (source.name[0] == name[0] && strlen(source.name) == nameLen && memcmp(source.name, name, nameLen) == 0)
+				{
+					_netCounters[source.counter] = (uint64_t)value;
+					break;
+				}
+			}
+		}
+
+		header = values;
+		header.nextLine();
+	}
+}
+
+void ProcCollector::netStackCounters(struct NetStackSample& net)
+{
+	parseCounterPairs(_snmp);
+	parseCounterPairs(_netstat);
+
+	if (_netCountersReady)
+	{
+		for (int i = 0; i < NetStackCounterCount; i++)
+			net.counters[i] = (_netCounters[i] >= _lastNetCounters[i]) ? _netCounters[i] - _lastNetCounters[i] : 0;
+	}
+
+	memcpy(_lastNetCounters, _netCounters, sizeof(_netCounters));
+	_netCountersReady = true;
+}
+
+void ProcCollector::networkBytes(uint64_t& recvBytes, uint64_t& sendBytes)
+{
+	recvBytes = 0;
+	sendBytes = 0;
+
+	ssize_t len = _netdev.read(_buffer.data(), _buffer.size());
+	if (len <= 0)
+		return;
+
+	//-- Two header lines, then: "  eth0: rxBytes rxPackets errs drop fifo frame compressed multicast txBytes ..."
+	ProcScanner scanner(_buffer.data(), len);
+	scanner.nextLine();
+	while (scanner.nextLine())
+	{
+		const char* name;
+		size_t nameLen;
+		if (!scanner.token(name, nameLen) || !physicalInterface(name, nameLen))
+			continue;
+
+		scanner.skipChar(':');
+		recvBytes += scanner.parseUInt();
+		for (int i = 0; i < 7; i++)
+			scanner.parseUInt();
+		sendBytes += scanner.parseUInt();
+	}
+}
+
+void ProcCollector::readTicks(ProcScanner& scanner, struct CpuTicks& ticks)
+{
+	//-- user nice system idle iowait irq softirq steal guest guest_nice. guest is included in user.
+	ticks.user = scanner.parseUInt();
+	ticks.user += scanner.parseUInt();
+	ticks.system = scanner.parseUInt();
+	ticks.idle = scanner.parseUInt();
+	ticks.iowait = scanner.parseUInt();
+	ticks.irq = scanner.parseUInt();
+	ticks.softirq = scanner.parseUInt();
+	ticks.steal = scanner.parseUInt();
+}
+
+void ProcCollector::calcUsage(const struct CpuTicks& last, const struct CpuTicks& current, struct CpuUsage& usage)
+{
+	uint64_t lastTotal = last.total();
+	uint64_t total = current.total();
+	if (lastTotal == 0 || total <= lastTotal)
+		return;
+
+	//-- iowait of offline/idle cpu may go backward. Clamp each delta at 0.
+	#define TICKS_PERCENT(field) ((current.field > last.field) ? (current.field - last.field) * 100.0f / diff : 0.0f)
+
+	float diff = (float)(total - lastTotal);
+	usage.user = TICKS_PERCENT(user);
+	usage.system = TICKS_PERCENT(system);
+	usage.iowait = TICKS_PERCENT(iowait);
+	usage.irq = TICKS_PERCENT(irq);
+	usage.softirq = TICKS_PERCENT(softirq);
+	usage.steal = TICKS_PERCENT(steal);
+	usage.util = 100.0f - TICKS_PERCENT(idle) - usage.iowait;
+	if (usage.util < 0)
+		usage.util = 0;
+
+	#undef TICKS_PERCENT
+}
+
+void ProcCollector::cpuUsage(struct MachineSample& sample)
+{
+	ssize_t len = _stat.read(_buffer.data(), _buffer.size());
+	if (len <= 0)
+		return;
+
+	struct CpuTicks totalTicks;
+	memset(&totalTicks, 0, sizeof(totalTicks));
+	_coreTicks.clear();
+
+	ProcScanner scanner(_buffer.data(), len);
+	do
+	{
+		if (!scanner.match("cpu", 3))
+			break;		//-- cpu lines are at the beginning.
+
+		if (*scanner.pos() == ' ')
+			readTicks(scanner, totalTicks);
+		else
+		{
+			size_t core = (size_t)scanner.parseUInt();
+			if (core >= _coreTicks.size())
+				_coreTicks.resize(core + 1);
+
+			readTicks(scanner, _coreTicks[core]);
+		}
+	} while (scanner.nextLine());
+
+	calcUsage(_lastTotalTicks, totalTicks, sample.cpu);
+
+	//-- Cpu hotplug: restart per core statistics.
+	if (_lastCoreTicks.size() != _coreTicks.size())
+		_lastCoreTicks = _coreTicks;
+
+	sample.cores.resize(_coreTicks.size());
+	for (size_t i = 0; i < _coreTicks.size(); i++)
+	{
+		sample.cores[i] = CpuUsage();
+		calcUsage(_lastCoreTicks[i], _coreTicks[i], sample.cores[i]);
+		if (sample.cores[i].util > sample.maxCoreUtil || sample.maxCore < 0)
+		{
+			sample.maxCoreUtil = sample.cores[i].util;
+			sample.maxCore = (int)i;
+		}
+	}
+
+	_lastTotalTicks = totalTicks;
+	_lastCoreTicks.swap(_coreTicks);
+}
+
+/*
+	some avg10=0.12 avg60=0.05 avg300=0.01 total=123456
+	full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+*/
+void ProcCollector::pressure(ProcFile& file, float& some, float& full)
+{
+	//-- Kernel without PSI, or booted with psi=0.
+	if (!file.existed())
+		return;
+
+	ssize_t len = file.read(_buffer.data(), _buffer.size());
+	if (len <= 0)
+		return;
+
+	ProcScanner scanner(_buffer.data(), len);
+	do
+	{
+		float* target;
+		if (scanner.match("some", 4))
+			target = &some;
+		else if (scanner.match("full", 4))
+			target = &full;
+		else
+			continue;
+
+		if (scanner.match("avg10=", 6))
+			*target = (float)scanner.parseDouble();
+
+	} while (scanner.nextLine());
+}
+
+//-- Whole disks are listed in /sys/block. Loop & ram devices are not real storage.
+bool ProcCollector::monitoredDisk(const std::string& name)
+{
+	if (name.compare(0, 4, "loop") == 0 || name.compare(0, 3, "ram") == 0)
+		return false;
+
+	std::string path("/sys/block/");
+	for (char c: name)
+		path.push_back(c == '/' ? '!' : c);
+
+	struct stat st;
+	return stat(path.c_str(), &st) == 0;
+}
+
+/*
+	major minor name readIos readMerges readSectors readMsec writeIos writeMerges writeSectors writeMsec inFlight ioMsec weightedMsec ...
+	Sector is always 512 bytes in /proc/diskstats.
+*/
+void ProcCollector::diskStatus(std::vector<struct DiskSample>& disks)
+{
+	disks.clear();
+
+	ssize_t len = _diskstats.read(_buffer.data(), _buffer.size());
+	if (len <= 0)
+		return;
+
+	int64_t now = exact_mono_msec();
+	float elapsedSec = (_lastDiskMsec > 0 && now > _lastDiskMsec) ? (now - _lastDiskMsec) / 1000.0f : 0;
+	_lastDiskMsec = now;
+
+	ProcScanner scanner(_buffer.data(), len);
+	do
+	{
+		scanner.parseUInt();
+		scanner.parseUInt();
+
+		const char* name;
+		size_t nameLen;
+		if (!scanner.token(name, nameLen))
+			continue;
+
+		struct DiskTicks ticks;
+		ticks.readIos = scanner.parseUInt();
+		scanner.parseUInt();
+		ticks.readSectors = scanner.parseUInt();
+		ticks.readMsec = scanner.parseUInt();
+		ticks.writeIos = scanner.parseUInt();
+		scanner.parseUInt();
+		ticks.writeSectors = scanner.parseUInt();
+		ticks.writeMsec = scanner.parseUInt();
+		scanner.parseUInt();
+		ticks.ioMsec = scanner.parseUInt();
+
+		//-- Key buffer keeps its capacity between lines, so looking up a known device does not allocate.
+		_deviceName.assign(name, nameLen);
+		auto iter = _lastDisks.find(_deviceName);
+		if (iter == _lastDisks.end())
+		{
+			ticks.monitored = monitoredDisk(_deviceName);
+			_lastDisks[_deviceName] = ticks;
+			continue;
+		}
+
+		struct DiskTicks& last = iter->second;
+		ticks.monitored = last.monitored;
+		if (ticks.monitored && elapsedSec > 0)
+		{
+			#define TICKS_DIFF(field) ((ticks.field > last.field) ? (ticks.field - last.field) : 0)
+
+			struct DiskSample disk;
+			disk.name = _deviceName;
+			uint64_t readIos = TICKS_DIFF(readIos);
+			uint64_t writeIos = TICKS_DIFF(writeIos);
+			disk.readIops = readIos / elapsedSec;
+			disk.writeIops = writeIos / elapsedSec;
+			disk.readBytes = TICKS_DIFF(readSectors) * 512 / elapsedSec;
+			disk.writeBytes = TICKS_DIFF(writeSectors) * 512 / elapsedSec;
+			if (readIos + writeIos)
+				disk.awaitMsec = (float)(TICKS_DIFF(readMsec) + TICKS_DIFF(writeMsec)) / (readIos + writeIos);
+			disk.util = TICKS_DIFF(ioMsec) / (elapsedSec * 10);
+			if (disk.util > 100)
+				disk.util = 100;
+
+			disks.push_back(disk);
+
+			#undef TICKS_DIFF
+		}
+
+		last = ticks;
+
+	} while (scanner.nextLine());
+}
+
+void ProcCollector::vmCounters(struct VmSample& vm)
+{
+	ssize_t len = _vmstat.read(_buffer.data(), _buffer.size());
+	if (len <= 0)
+		return;
+
+	//-- "name value" lines, about 200 of them. Only the first letter is checked before comparing.
+	uint64_t counters[3] = { _lastVmCounters[0], _lastVmCounters[1], _lastVmCounters[2] };
+	ProcScanner scanner(_buffer.data(), len);
+	do
+	{
+		const char* pos = scanner.pos();
+		if (*pos != 'p')
+			continue;
+
+		if (scanner.match("pgmajfault ", 11))
+			counters[0] = scanner.parseUInt();
+		else if (scanner.match("pswpin ", 7))
+			counters[1] = scanner.parseUInt();
+		else if (scanner.match("pswpout ", 8))
+			counters[2] = scanner.parseUInt();
+
+	} while (scanner.nextLine());
+
+	if (_vmCountersReady)
+	{
+		vm.majorFaults = (counters[0] > _lastVmCounters[0]) ? counters[0] - _lastVmCounters[0] : 0;
+		vm.swapIn = (counters[1] > _lastVmCounters[1]) ? counters[1] - _lastVmCounters[1] : 0;
+		vm.swapOut = (counters[2] > _lastVmCounters[2]) ? counters[2] - _lastVmCounters[2] : 0;
+	}
+
+	memcpy(_lastVmCounters, counters, sizeof(counters));
+	_vmCountersReady = true;
+}
+
+void ProcCollector::sample(struct MachineSample& sample)
+{
+	struct sysinfo info;
+	sysinfo(&info);
+	sample.freeMemories = info.freeram;
+
+	std::unique_lock<std::mutex> lck(_mutex);
+	sample.sysLoad = loadAverage();
+	connections(sample.tcpConn, sample.udpConn, sample.net.timeWait);
+	networkBytes(sample.recvBytes, sample.sendBytes);
+	cpuUsage(sample);
+	netStackCounters(sample.net);
+
+	pressure(_pressureCpu, sample.pressure.cpuSome, sample.pressure.cpuFull);
+	pressure(_pressureMemory, sample.pressure.memorySome, sample.pressure.memoryFull);
+	pressure(_pressureIo, sample.pressure.ioSome, sample.pressure.ioFull);
+	diskStatus(sample.disks);
+	vmCounters(sample.vm);
+}
@@ -0,0 +1,375 @@
+#ifndef DAT_Proc_Collector_h
+#define DAT_Proc_Collector_h
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "NetStackCounters.h"
+
+/*
+	Low overhead /proc collector, shared by DATMonitor and DATDeployer.
+
+	/proc files are kept opened, and re-read by pread() from offset 0 into a buffer allocated once.
+	Contents are parsed by ProcScanner in place, without any allocation.
+*/
+
+class ProcScanner
+{
+	const char* _pos;
+	const char* _end;
+
+public:
+	ProcScanner(const char* data, size_t len): _pos(data), _end(data + len) {}
+
+	inline bool eof() const { return _pos >= _end; }
+	inline const char* pos() const { return _pos; }
+
+	inline void skipSpaces()
+	{
+		while (_pos < _end && (*_pos == ' ' || *_pos == '\t'))
+			_pos++;
+	}
+
+	//-- Move to the beginning of next line.
+	inline bool nextLine()
+	{
+		while (_pos < _end && *_pos != '\n')
+			_pos++;
+
+		if (_pos < _end)
+			_pos++;
+
+		return _pos < _end;
+	}
+
+	//-- Skip spaces, then check & consume prefix.
+	inline bool match(const char* prefix, size_t len)
+	{
+		skipSpaces();
+		if ((size_t)(_end - _pos) < len || memcmp(_pos, prefix, len) != 0)
+			return false;
+
+		_pos += len;
+		return true;
+	}
+
+	//-- Skip spaces, then return token [begin, begin + len). Token ends at space, tab, newline or ':'.
+	inline bool token(const char*& begin, size_t& len)
+	{
+		skipSpaces();
+		begin = _pos;
+		while (_pos < _end && *_pos != ' ' && *_pos != '\t' && *_pos != '\n' && *_pos != ':')
+			_pos++;
+
+		len = _pos - begin;
+		return len > 0;
+	}
+
+	inline void skipToken()
+	{
+		const char* begin;
+		size_t len;
+		token(begin, len);
+	}
+
+	inline void skipChar(char c)
+	{
+		skipSpaces();
+		if (_pos < _end && *_pos == c)
+			_pos++;
+	}
+
+	inline uint64_t parseUInt()
+	{
+		skipSpaces();
+		uint64_t value = 0;
+		while (_pos < _end && *_pos >= '0' && *_pos <= '9')
+			value = value * 10 + (*_pos++ - '0');
+
+		return value;
+	}
+
+	inline int64_t parseInt()
+	{
+		skipSpaces();
+		bool negative = (_pos < _end && *_pos == '-');
+		if (negative)
+			_pos++;
+
+		int64_t value = (int64_t)parseUInt();
+		return negative ? -value : value;
+	}
+
+	//-- Only plain decimal, such as loadavg & PSI values.
+	inline double parseDouble()
+	{
+		double value = (double)parseUInt();
+		if (_pos < _end && *_pos == '.')
+		{
+			_pos++;
+			double scale = 0.1;
+			while (_pos < _end && *_pos >= '0' && *_pos <= '9')
+			{
+				value += (*_pos++ - '0') * scale;
+				scale *= 0.1;
+			}
+		}
+		return value;
+	}
+};
+
+class ProcFile
+{
+	int _fd;
+	bool _existed;
+	std::string _path;
+
+public:
+	ProcFile(): _fd(-1), _existed(false) {}
+	~ProcFile();
+
+	bool open(const std::string& path);
+	bool opened() const { return _fd >= 0; }
+	//-- Opened once at least. Still true after a failed read closed it, which is reopened by the next read().
+	bool existed() const { return _existed; }
+
+	//-- Read whole file into buffer. Return bytes read, -1 on error. buffer is '\0' terminated.
+	ssize_t read(char* buffer, size_t size);
+};
+
+//-- Percentages of one cpu (or all cpus for total) between two successive samples.
+struct CpuUsage
+{
+	float user;			//-- user + nice
+	float system;
+	float iowait;
+	float irq;
+	float softirq;
+	float steal;
+	float util;			//-- 100 - idle - iowait
+
+	CpuUsage(): user(0), system(0), iowait(0), irq(0), softirq(0), steal(0), util(0) {}
+};
+
+struct NetStackSample
+{
+	uint64_t counters[NetStackCounterCount];
+	int timeWait;		//-- current TIME_WAIT sockets, from /proc/net/sockstat
+
+	NetStackSample(): timeWait(-1) { memset(counters, 0, sizeof(counters)); }
+};
+
+//-- avg10 of /proc/pressure/{cpu,memory,io}, in percent. -1: not supported by kernel (PSI requires 4.20+).
+struct PressureSample
+{
+	float cpuSome;
+	float cpuFull;
+	float memorySome;
+	float memoryFull;
+	float ioSome;
+	float ioFull;
+
+	PressureSample(): cpuSome(-1), cpuFull(-1), memorySome(-1), memoryFull(-1), ioSome(-1), ioFull(-1) {}
+};
+
+//-- Rates of one block device from /proc/diskstats between two successive samples.
+struct DiskSample
+{
+	std::string name;
+	float readIops;
+	float writeIops;
+	float readBytes;		//-- bytes per second
+	float writeBytes;		//-- bytes per second
+	float awaitMsec;		//-- average time of completed requests, including queue time
+	float util;				//-- percent of time the device had I/O in flight
+
+	DiskSample(): readIops(0), writeIops(0), readBytes(0), writeBytes(0), awaitMsec(0), util(0) {}
+};
+
+//-- /proc/vmstat counters, deltas between two successive samples.
+struct VmSample
+{
+	uint64_t majorFaults;
+	uint64_t swapIn;		//-- pages
+	uint64_t swapOut;		//-- pages
+
+	VmSample(): majorFaults(0), swapIn(0), swapOut(0) {}
+};
+
+struct MachineSample
+{
+	float sysLoad;
+	int tcpConn;
+	int udpConn;
+	uint64_t freeMemories;
+	uint64_t recvBytes;
+	uint64_t sendBytes;
+
+	struct CpuUsage cpu;
+	std::vector<struct CpuUsage> cores;
+	float maxCoreUtil;
+	int maxCore;
+
+	struct NetStackSample net;
+
+	struct PressureSample pressure;
+	std::vector<struct DiskSample> disks;
+	struct VmSample vm;
+
+	MachineSample(): sysLoad(-1), tcpConn(-1), udpConn(-1), freeMemories(0), recvBytes(0), sendBytes(0), maxCoreUtil(0), maxCore(-1) {}
+};
+
+class ProcCollector
+{
+	//-- jiffies of one line in /proc/stat
+	struct CpuTicks
+	{
+		uint64_t user;
+		uint64_t system;
+		uint64_t idle;
+		uint64_t iowait;
+		uint64_t irq;
+		uint64_t softirq;
+		uint64_t steal;
+
+		uint64_t total() const { return user + system + idle + iowait + irq + softirq + steal; }
+	};
+
+	//-- Accumulated fields of one /proc/diskstats line.
+	struct DiskTicks
+	{
+		uint64_t readIos;
+		uint64_t readSectors;
+		uint64_t readMsec;
+		uint64_t writeIos;
+		uint64_t writeSectors;
+		uint64_t writeMsec;
+		uint64_t ioMsec;
+		bool monitored;		//-- Whole disk. Partitions, loop & ram devices are skipped.
+	};
+
+	std::mutex _mutex;
+	std::vector<char> _buffer;
+
+	ProcFile _loadavg;
+	ProcFile _sockstat;
+	ProcFile _netdev;
+	ProcFile _stat;
+	ProcFile _snmp;
+	ProcFile _netstat;
+	ProcFile _pressureCpu;
+	ProcFile _pressureMemory;
+	ProcFile _pressureIo;
+	ProcFile _diskstats;
+	ProcFile _vmstat;
+
+	struct CpuTicks _lastTotalTicks;
+	std::vector<struct CpuTicks> _lastCoreTicks;
+	std::vector<struct CpuTicks> _coreTicks;
+
+	uint64_t _netCounters[NetStackCounterCount];
+	uint64_t _lastNetCounters[NetStackCounterCount];
+	bool _netCountersReady;
+
+	std::map<std::string, struct DiskTicks> _lastDisks;
+	std::string _deviceName;		//-- lookup key of _lastDisks, reused between lines.
+	int64_t _lastDiskMsec;
+
+	uint64_t _lastVmCounters[3];
+	bool _vmCountersReady;
+
+	static void readTicks(ProcScanner& scanner, struct CpuTicks& ticks);
+	static void calcUsage(const struct CpuTicks& last, const struct CpuTicks& current, struct CpuUsage& usage);
+
+	float loadAverage();
+	void cpuUsage(struct MachineSample& sample);
+	void connections(int& tcpConn, int& udpConn, int& timeWait);
+	void parseCounterPairs(ProcFile& file);
+	void netStackCounters(struct NetStackSample& net);
+	void networkBytes(uint64_t& recvBytes, uint64_t& sendBytes);
+	void pressure(ProcFile& file, float& some, float& full);
+	void diskStatus(std::vector<struct DiskSample>& disks);
+	void vmCounters(struct VmSample& vm);
+
+	static bool monitoredDisk(const std::string& name);
+
+public:
+	ProcCollector();
+	void sample(struct MachineSample& sample);
+
+	//-- Interfaces counted by networkBytes().
+	static bool physicalInterface(const char* name, size_t len);
+};
+
+/*
+	Write sample as machineStatus answer fields. Writer is FPAWriter or FPQWriter, which must reserve
+	gc_machineSampleFieldCount fields for the sample.
+	cores: [[user, system, iowait, irq, softirq, steal, util]]
+	netStack: { counter name: delta, timeWait: current TIME_WAIT sockets }
+	pressure: { cpuSome, cpuFull, memorySome, memoryFull, ioSome, ioFull }, only supported items.
+	disks: { device: [readIops, writeIops, readBytes/s, writeBytes/s, awaitMsec, util] }
+	vmstat: { majorFaults, swapIn, swapOut }
+*/
+const int gc_machineSampleFieldCount = 20;
+
+template<class Writer>
+void writeMachineSample(Writer& writer, const struct MachineSample& sample)
+{
+	std::vector<std::vector<float>> cores;
+	cores.reserve(sample.cores.size());
+	for (auto& core: sample.cores)
+		cores.push_back(std::vector<float>{ core.user, core.system, core.iowait, core.irq, core.softirq, core.steal, core.util });
+
+	writer.param("sysLoad", sample.sysLoad);
+	writer.param("tcpConn", sample.tcpConn);
+	writer.param("udpConn", sample.udpConn);
+	writer.param("freeMemories", sample.freeMemories);
+	writer.param("RX", sample.recvBytes);
+	writer.param("TX", sample.sendBytes);
+	writer.param("cpuUtil", sample.cpu.util);
+	writer.param("cpuUser", sample.cpu.user);
+	writer.param("cpuSystem", sample.cpu.system);
+	writer.param("cpuIowait", sample.cpu.iowait);
+	writer.param("cpuIrq", sample.cpu.irq);
+	writer.param("cpuSoftirq", sample.cpu.softirq);
+	writer.param("cpuSteal", sample.cpu.steal);
+	writer.param("maxCoreUtil", sample.maxCoreUtil);
+	writer.param("maxCore", sample.maxCore);
+	writer.param("cores", cores);
+
+	std::map<std::string, int64_t> netStack;
+	for (int i = 0; i < NetStackCounterCount; i++)
+		netStack[gc_netStackCounterNames[i]] = (int64_t)sample.net.counters[i];
+	netStack[gc_netStackTimeWaitName] = sample.net.timeWait;
+
+	writer.param("netStack", netStack);
+
+	std::map<std::string, float> pressure;
+	const struct PressureSample& psi = sample.pressure;
+	const float psiValues[] = { psi.cpuSome, psi.cpuFull, psi.memorySome, psi.memoryFull, psi.ioSome, psi.ioFull };
+	const char* psiNames[] = { "cpuSome", "cpuFull", "memorySome", "memoryFull", "ioSome", "ioFull" };
+	for (int i = 0; i < 6; i++)
+		if (psiValues[i] >= 0)
+			pressure[psiNames[i]] = psiValues[i];
+
+	writer.param("pressure", pressure);
+
+	std::map<std::string, std::vector<float>> disks;
+	for (auto& disk: sample.disks)
+		disks[disk.name] = std::vector<float>{ disk.readIops, disk.writeIops, disk.readBytes, disk.writeBytes, disk.awaitMsec, disk.util };
+
+	writer.param("disks", disks);
+
+	std::map<std::string, int64_t> vmstat;
+	vmstat["majorFaults"] = (int64_t)sample.vm.majorFaults;
+	vmstat["swapIn"] = (int64_t)sample.vm.swapIn;
+	vmstat["swapOut"] = (int64_t)sample.vm.swapOut;
+
+	writer.param("vmstat", vmstat);
+}
+
+#endif
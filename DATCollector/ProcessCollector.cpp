@@ -0,0 +1,236 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include "msec.h"
+#include "ProcessCollector.h"
+
+const size_t gc_processBufferSize = 16 * 1024;
+
+ProcessCollector::ProcessCollector(): _buffer(gc_processBufferSize)
+{
+	_clockTicks = sysconf(_SC_CLK_TCK);
+	if (_clockTicks <= 0)
+		_clockTicks = 100;
+}
+
+void ProcessCollector::setWatchList(const std::set<int>& pids, const std::vector<std::string>& patterns)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	_pids = pids;
+	_patterns = patterns;
+}
+
+bool ProcessCollector::watching()
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	return _pids.size() || _patterns.size();
+}
+
+//-- /proc/<pid>/* files are generated per open, so they are not kept opened as ProcCollector does.
+bool ProcessCollector::readFile(const std::string& path, ssize_t& len)
+{
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	len = ::read(fd, _buffer.data(), _buffer.size() - 1);
+	::close(fd);
+	if (len < 0)
+		return false;
+
+	_buffer[len] = '\0';
+	return true;
+}
+
+bool ProcessCollector::readProcessName(int pid, std::string& name)
+{
+	ssize_t len;
+	if (!readFile(std::string("/proc/").append(std::to_string(pid)).append("/comm"), len))
+		return false;
+
+	while (len > 0 && _buffer[len - 1] == '\n')
+		len--;
+
+	name.assign(_buffer.data(), len);
+	return true;
+}
+
+void ProcessCollector::matchPatterns(std::map<int, std::string>& targets)
+{
+	DIR* dir = opendir("/proc");
+	if (dir == NULL)
+		return;
+
+	std::string name;
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (entry->d_name[0] < '1' || entry->d_name[0] > '9')
+			continue;
+
+		int pid = atoi(entry->d_name);
+		if (targets.find(pid) != targets.end() || !readProcessName(pid, name))
+			continue;
+
+		for (auto& pattern: _patterns)
+			if (fnmatch(pattern.c_str(), name.c_str(), 0) == 0)
+			{
+				targets[pid] = "name";
+				break;
+			}
+	}
+
+	closedir(dir);
+}
+
+bool ProcessCollector::sampleProcess(int pid, struct ProcessTicks& ticks, struct ProcessSample& sample)
+{
+	std::string prefix("/proc/");
+	prefix.append(std::to_string(pid));
+
+	//-- pid (comm) state ppid ... field 14: utime, 15: stime, 20: num_threads, 22: starttime
+	ssize_t len;
+	if (!readFile(prefix + "/stat", len))
+		return false;
+
+	const char* nameBegin = strchr(_buffer.data(), '(');
+	const char* nameEnd = strrchr(_buffer.data(), ')');		//-- comm may contain ')'.
+	if (nameBegin == NULL || nameEnd == NULL || nameEnd < nameBegin)
+		return false;
+
+	sample.pid = pid;
+	sample.name.assign(nameBegin + 1, nameEnd - nameBegin - 1);
+
+	ProcScanner scanner(nameEnd + 1, _buffer.data() + len - nameEnd - 1);
+	for (int field = 3; field < 14; field++)
+		scanner.skipToken();
+
+	ticks.utime = scanner.parseUInt();
+	ticks.stime = scanner.parseUInt();
+	for (int field = 16; field < 20; field++)
+		scanner.skipToken();
+
+	sample.threads = (int)scanner.parseInt();
+	scanner.skipToken();
+	ticks.startTime = scanner.parseUInt();
+	ticks.msec = exact_mono_msec();
+
+	//-- VmRSS: 1234 kB / voluntary_ctxt_switches: 12 / nonvoluntary_ctxt_switches: 3
+	ticks.voluntaryCtxSwitches = 0;
+	ticks.involuntaryCtxSwitches = 0;
+	if (readFile(prefix + "/status", len))
+	{
+		ProcScanner status(_buffer.data(), len);
+		do
+		{
+			const char* pos = status.pos();
+			if (*pos == 'V' && status.match("VmRSS:", 6))
+				sample.rssKB = (int64_t)status.parseUInt();
+			else if (*pos == 'v' && status.match("voluntary_ctxt_switches:", 24))
+				ticks.voluntaryCtxSwitches = status.parseUInt();
+			else if (*pos == 'n' && status.match("nonvoluntary_ctxt_switches:", 27))
+				ticks.involuntaryCtxSwitches = status.parseUInt();
+
+		} while (status.nextLine());
+	}
+
+	//-- Needs same user or CAP_SYS_PTRACE.
+	ticks.readBytes = -1;
+	ticks.writeBytes = -1;
+	if (readFile(prefix + "/io", len))
+	{
+		ProcScanner io(_buffer.data(), len);
+		do
+		{
+			if (io.match("read_bytes:", 11))
+				ticks.readBytes = (int64_t)io.parseUInt();
+			else if (io.match("write_bytes:", 12))
+				ticks.writeBytes = (int64_t)io.parseUInt();
+
+		} while (io.nextLine());
+	}
+
+	sample.fds = -1;
+	DIR* dir = opendir((prefix + "/fd").c_str());
+	if (dir)
+	{
+		sample.fds = 0;
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != NULL)
+			if (entry->d_name[0] != '.')
+				sample.fds++;
+
+		closedir(dir);
+	}
+
+	return true;
+}
+
+void ProcessCollector::sample(const std::map<int, std::string>& extraPids, std::vector<struct ProcessSample>& processes)
+{
+	processes.clear();
+
+	std::unique_lock<std::mutex> lck(_mutex);
+
+	std::map<int, std::string> targets(extraPids);
+	for (int pid: _pids)
+		if (targets.find(pid) == targets.end())
+			targets[pid] = "pid";
+
+	if (_patterns.size())
+		matchPatterns(targets);
+
+	std::map<int, struct ProcessTicks> currentTicks;
+	for (auto& pp: targets)
+	{
+		struct ProcessTicks ticks;
+		struct ProcessSample sample;
+		if (!sampleProcess(pp.first, ticks, sample))
+			continue;
+
+		sample.watchedBy = pp.second;
+
+		auto iter = _lastTicks.find(pp.first);
+		if (iter != _lastTicks.end() && iter->second.startTime == ticks.startTime && ticks.msec > iter->second.msec)
+		{
+			const struct ProcessTicks& last = iter->second;
+			float elapsedSec = (ticks.msec - last.msec) / 1000.0f;
+
+			#define TICKS_RATE(field) ((ticks.field > last.field) ? (ticks.field - last.field) / elapsedSec : 0.0f)
+
+			sample.user = TICKS_RATE(utime) * 100 / _clockTicks;
+			sample.system = TICKS_RATE(stime) * 100 / _clockTicks;
+			sample.cpu = sample.user + sample.system;
+			sample.voluntaryCtxSwitches = TICKS_RATE(voluntaryCtxSwitches);
+			sample.involuntaryCtxSwitches = TICKS_RATE(involuntaryCtxSwitches);
+			if (ticks.readBytes >= 0 && last.readBytes >= 0)
+			{
+				sample.readBytes = TICKS_RATE(readBytes);
+				sample.writeBytes = TICKS_RATE(writeBytes);
+			}
+
+			#undef TICKS_RATE
+		}
+
+		currentTicks[pp.first] = ticks;
+		processes.push_back(sample);
+	}
+
+	//-- Exited & unwatched processes are dropped here.
+	_lastTicks.swap(currentTicks);
+}
+
+void processStatusRows(const std::vector<struct ProcessSample>& processes, std::vector<std::vector<std::string>>& rows)
+{
+	for (auto& process: processes)
+	{
+		rows.push_back(std::vector<std::string>{ std::to_string(process.pid), process.name, process.watchedBy,
+			std::to_string(process.cpu), std::to_string(process.user), std::to_string(process.system),
+			std::to_string(process.rssKB), std::to_string(process.threads),
+			std::to_string(process.voluntaryCtxSwitches), std::to_string(process.involuntaryCtxSwitches),
+			std::to_string(process.fds), std::to_string(process.readBytes), std::to_string(process.writeBytes) });
+	}
+}
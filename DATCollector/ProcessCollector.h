@@ -0,0 +1,80 @@
+#ifndef DAT_Process_Collector_h
+#define DAT_Process_Collector_h
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <map>
+#include <set>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ProcCollector.h"
+
+/*
+	Per-process metrics of a watch list, shared by DATMonitor and DATDeployer.
+
+	Processes are watched by pid, or by glob pattern on process name (/proc/<pid>/comm, at most 15 chars).
+	Rates are computed between two successive samples; a pid reused by another process restarts its statistics.
+*/
+struct ProcessSample
+{
+	int pid;
+	std::string name;
+	std::string watchedBy;		//-- "pid", "name", or actor name for actors launched by deployer.
+	float cpu;					//-- percent of one core. Multi-threaded process may exceed 100.
+	float user;
+	float system;
+	int64_t rssKB;
+	int threads;
+	float voluntaryCtxSwitches;		//-- per second
+	float involuntaryCtxSwitches;	//-- per second
+	int fds;
+	float readBytes;			//-- per second, storage layer. -1: /proc/<pid>/io is not readable.
+	float writeBytes;			//-- per second, storage layer. -1: /proc/<pid>/io is not readable.
+
+	ProcessSample(): pid(0), cpu(0), user(0), system(0), rssKB(0), threads(0), voluntaryCtxSwitches(0),
+		involuntaryCtxSwitches(0), fds(0), readBytes(-1), writeBytes(-1) {}
+};
+
+class ProcessCollector
+{
+	struct ProcessTicks
+	{
+		uint64_t startTime;		//-- identifies the process together with pid.
+		uint64_t utime;
+		uint64_t stime;
+		uint64_t voluntaryCtxSwitches;
+		uint64_t involuntaryCtxSwitches;
+		int64_t readBytes;
+		int64_t writeBytes;
+		int64_t msec;
+	};
+
+	std::mutex _mutex;
+	std::vector<char> _buffer;
+	std::set<int> _pids;
+	std::vector<std::string> _patterns;
+	std::map<int, struct ProcessTicks> _lastTicks;
+	long _clockTicks;
+
+	bool readFile(const std::string& path, ssize_t& len);
+	bool readProcessName(int pid, std::string& name);
+	bool sampleProcess(int pid, struct ProcessTicks& ticks, struct ProcessSample& sample);
+	void matchPatterns(std::map<int, std::string>& targets);
+
+public:
+	ProcessCollector();
+
+	void setWatchList(const std::set<int>& pids, const std::vector<std::string>& patterns);
+	bool watching();
+
+	//-- extraPids: map<pid, watchedBy>, e.g. actors launched by deployer.
+	void sample(const std::map<int, std::string>& extraPids, std::vector<struct ProcessSample>& processes);
+};
+
+/*
+	row: pid, name, watchedBy, cpu%, usr%, sys%, rssKB, threads, voluntaryCtxSw/s, involuntaryCtxSw/s, fds, readBytes/s, writeBytes/s
+*/
+void processStatusRows(const std::vector<struct ProcessSample>& processes, std::vector<std::vector<std::string>>& rows);
+
+#endif
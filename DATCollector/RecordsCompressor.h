@@ -0,0 +1,41 @@
+#ifndef DAT_Records_Compressor_h
+#define DAT_Records_Compressor_h
+
+#include <string>
+#include <zlib.h>
+
+//-- Compress records in place by zlib when it's large enough and gets smaller. Return true if compressed.
+inline bool compressRecords(std::string& records, size_t threshold = 1024)
+{
+	size_t rawSize = records.size();
+	if (rawSize < threshold)
+		return false;
+
+	uLongf compressedSize = compressBound(rawSize);
+	std::string compressed(compressedSize, '\0');
+	if (compress2((Bytef*)&compressed[0], &compressedSize, (const Bytef*)records.data(), rawSize, Z_BEST_SPEED) != Z_OK
+		|| compressedSize >= rawSize)
+		return false;
+
+	compressed.resize(compressedSize);
+	records.swap(compressed);
+	return true;
+}
+
+//-- Decompress records in place. rawSize is told by the sender, so it is checked against maxRawSize before allocating.
+inline bool decompressRecords(std::string& records, int64_t rawSize, size_t maxRawSize)
+{
+	if (rawSize <= 0 || (uint64_t)rawSize > maxRawSize)
+		return false;
+
+	uLongf decompressedSize = (uLongf)rawSize;
+	std::string raw(decompressedSize, '\0');
+	if (uncompress((Bytef*)&raw[0], &decompressedSize, (const Bytef*)records.data(), records.size()) != Z_OK
+		|| decompressedSize != raw.size())
+		return false;
+
+	records.swap(raw);
+	return true;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#include "ConnectionTable.h"
+
+void ConnectionTable::releaseNames(struct ConnectionRecord& record)
+{
+	_names.regions.release(record.regionId);
+	_names.endpoints.release(record.endpointId);
+	_names.actorNames.release(record.actorNameId);
+
+	record.regionId = 0;
+	record.endpointId = 0;
+	record.actorNameId = 0;
+}
+
+struct ConnectionRecord& ConnectionTable::open(int socket)
+{
+	struct ConnectionRecord& record = (*this)[socket];
+	if (record.opened)
+		releaseNames(record);
+	else
+		_openedCount++;
+
+	record = ConnectionRecord();
+	record.opened = true;
+	return record;
+}
+
+void ConnectionTable::close(int socket)
+{
+	if (socket < 0 || (size_t)socket >= _records.size() || !_records[socket].opened)
+		return;
+
+	releaseNames(_records[socket]);
+	_records[socket] = ConnectionRecord();
+	_openedCount--;
+}
+
+struct ConnectionRecord& ConnectionTable::operator[](int socket)
+{
+	if ((size_t)socket >= _records.size())
+		_records.resize(socket + 1);
+
+	return _records[socket];
+}
+
+void ConnectionTable::registerRole(int socket, ClientRole role, const std::string& region, const std::string& endpoint)
+{
+	struct ConnectionRecord& record = (*this)[socket];
+	uint32_t regionId = _names.regions.intern(region);
+	uint32_t endpointId = _names.endpoints.intern(endpoint);
+	releaseNames(record);
+
+	record.role = role;
+	record.regionId = regionId;
+	record.endpointId = endpointId;
+}
+
+void ConnectionTable::registerActor(int socket, const std::string& name, int pid)
+{
+	struct ConnectionRecord& record = (*this)[socket];
+	uint32_t nameId = _names.actorNames.intern(name);
+	_names.actorNames.release(record.actorNameId);
+
+	record.actorNameId = nameId;
+	record.actorPid = pid;
+}
@@ -0,0 +1,69 @@
+#ifndef DAT_Connection_Table_h
+#define DAT_Connection_Table_h
+
+#include <memory>
+#include "StringInterner.h"
+
+enum class ClientRole: uint8_t
+{
+	Controller,
+	Deployer,
+	Monitor,
+	Actor,
+};
+
+struct ConnectionUpload;
+typedef std::shared_ptr<struct ConnectionUpload> ConnectionUploadPtr;
+
+//-- 40 bytes for an idle connection. Upload state is allocated only when the connection uploads actors.
+struct ConnectionRecord
+{
+	ConnectionUploadPtr upload;
+	int actorPid;
+	uint32_t regionId;
+	uint32_t endpointId;
+	uint32_t actorNameId;
+	ClientRole role;
+	bool monitoringMachineStatus;
+	bool opened;
+
+	ConnectionRecord(): actorPid(0), regionId(0), endpointId(0), actorNameId(0), role(ClientRole::Controller),
+		monitoringMachineStatus(false), opened(false) {}
+};
+
+/*
+	Connection records indexed by socket. Kernel assigns the lowest free fd, so the slab is dense,
+	and a lookup is an index instead of a map search & a shared_ptr copy.
+	Not thread safe: used under ControlCenterQuestProcessor::_mutex.
+	References are invalid after open() of a larger socket.
+*/
+class ConnectionTable
+{
+	std::vector<struct ConnectionRecord> _records;
+	size_t _openedCount;
+	HostNames& _names;
+
+	void releaseNames(struct ConnectionRecord& record);
+
+public:
+	explicit ConnectionTable(HostNames& names): _openedCount(0), _names(names) {}
+
+	struct ConnectionRecord& open(int socket);
+	void close(int socket);
+
+	//-- Record of a socket not opened is empty, as std::map::operator[] does.
+	struct ConnectionRecord& operator[](int socket);
+
+	void registerRole(int socket, ClientRole role, const std::string& region, const std::string& endpoint);
+	void registerActor(int socket, const std::string& name, int pid);
+
+	const std::string& region(const struct ConnectionRecord& record) const { return _names.regions.str(record.regionId); }
+	const std::string& endpoint(const struct ConnectionRecord& record) const { return _names.endpoints.str(record.endpointId); }
+	const std::string& actorName(const struct ConnectionRecord& record) const { return _names.actorNames.str(record.actorNameId); }
+
+	size_t size() const { return _openedCount; }
+	//-- Slab only, exclude names & upload states.
+	size_t memoryBytes() const { return _records.capacity() * sizeof(struct ConnectionRecord); }
+};
+
+#endif
@@ -3,6 +3,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <atomic>
+#include <limits>
+#include <algorithm>
 #include "FPLog.h"
 #include "FileSystemUtil.h"
 #include "NetworkUtility.h"
@@ -10,26 +12,24 @@
 #include "StringUtil.h"
 #include "ChainBuffer.h"
 #include "../DATErrorInfo.h"
+#include "RecordsCompressor.h"
+#include "NetStackCounters.h"
 #include "ControlCenterQuestProcessor.h"
+#include "ControlCenterTables.h"
 
 const std::string gc_defaultActorDescFileName = ".actorDesc.txt";
 const size_t gc_maxTransportLength = 2 * 1024 * 1024;
+const size_t gc_maxRecordsRawLength = 32 * 1024 * 1024;		//-- decompressed telemetry records of one quest.
 std::atomic<int> globalTaskIdGen(0);
+const size_t gc_machineStatusHistorySize = 300;		//-- 10 minutes in 2 seconds interval.
 
-std::map<std::string, int> buildIdxMap(const std::set<std::string>& hopeFields, const std::vector<std::string>& fileds)
+static std::string endpointHost(const std::string& endpoint)
 {
-	std::set<std::string> remain = hopeFields;
-	std::map<std::string, int> idxmap;
-	for (size_t i = 0; i < fileds.size(); i++)
-	{
-		idxmap[fileds[i]] = i;
-		remain.erase(fileds[i]);
-	}
+	size_t pos = endpoint.find_last_of(':');
+	if (pos == std::string::npos)
+		return endpoint;
 
-	for (auto& lost: remain)
-		idxmap[lost] = -1;
-
-	return idxmap;
+	return endpoint.substr(0, pos);
 }
 
 UploadInfo::UploadInfo(const std::string& name_, const std::string& desc_, int sectionCount, ControlCenterQuestProcessorPtr ccqp):
@@ -98,26 +98,10 @@ void UploadInfo::fetchSectionToWrite(int& no, std::string& section, bool& allDon
 		return;
 	}
 
-	for (auto& sp: sections)
-	{
-		if (sp.second.length())
-		{
-			section.swap(sp.second);
-			no = sp.first;
-			return;
-		}
-	}
-}
-
-void ConnectionPrivateData::registerRole(ClientRole role, const std::string& region, const std::string& endpoint)
-{
-	std::unique_lock<std::mutex> lck(_mutex);
-	_role = role;
-	_deployHost.region = region;
-	_deployHost.endpoint = endpoint;
+	fetchFilledSection(sections, no, section);
 }
 
-void ConnectionPrivateData::wroteUploadSections()
+void ConnectionUpload::wroteUploadSections()
 {
 	int sectionNo;
 	std::string section;
@@ -177,7 +161,7 @@ void ConnectionPrivateData::wroteUploadSections()
 	}
 }
 
-bool ConnectionPrivateData::fillUploadSection(const std::string& name, const std::string& desc,
+bool ConnectionUpload::fillUploadSection(const std::string& name, const std::string& desc,
 	int sectionCount, int sectionNo, std::string& content, QuestSenderPtr sender, ControlCenterQuestProcessorPtr ccqp)
 {
 	std::unique_lock<std::mutex> lck(_mutex);
@@ -206,19 +190,20 @@ bool ConnectionPrivateData::fillUploadSection(const std::string& name, const std
 	return true;
 }
 
-void ControlCenterQuestProcessor::writeUploadActor(int socket, ConnectionPrivateData* idAddr)
+void ControlCenterQuestProcessor::writeUploadActor(int socket, ConnectionUpload* idAddr)
 {
-	ConnectionPrivateDataPtr privData;
+	ConnectionUploadPtr upload;
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
-		privData = _connData[socket];
+		upload = _connData[socket].upload;
 	}
 
-	if (privData.get() == idAddr)
-		privData->wroteUploadSections();
+	if (upload.get() == idAddr)
+		upload->wroteUploadSections();
 }
 
-ControlCenterQuestProcessor::ControlCenterQuestProcessor(): _monitorMachineStatus(0)
+ControlCenterQuestProcessor::ControlCenterQuestProcessor(): _connData(_hostNames), _monitorInfos(_hostNames), _deployerInfos(_hostNames),
+	_runningActorInfos(_hostNames), _monitorMachineStatus(0)
 {
 	registerMethod("ping", &ControlCenterQuestProcessor::ping);
 	registerMethod("deploy", &ControlCenterQuestProcessor::deploy);
@@ -232,13 +217,29 @@ ControlCenterQuestProcessor::ControlCenterQuestProcessor(): _monitorMachineStatu
 	registerMethod("launchActor", &ControlCenterQuestProcessor::launchActor);
 	registerMethod("monitorTasks", &ControlCenterQuestProcessor::monitorTasks);
 	registerMethod("monitorMachineStatus", &ControlCenterQuestProcessor::monitorMachineStatus);
+	registerMethod("statusIngestInfo", &ControlCenterQuestProcessor::statusIngestInfo);
+	registerMethod("taskSubscriberInfo", &ControlCenterQuestProcessor::taskSubscriberInfo);
+	registerMethod("actorCgroups", &ControlCenterQuestProcessor::actorCgroups);
+	registerMethod("machineStatusHistory", &ControlCenterQuestProcessor::machineStatusHistory);
+	registerMethod("machineCoreStatus", &ControlCenterQuestProcessor::machineCoreStatus);
+	registerMethod("netStackStatus", &ControlCenterQuestProcessor::netStackStatus);
+	registerMethod("diskStatus", &ControlCenterQuestProcessor::diskStatus);
+	registerMethod("watchProcesses", &ControlCenterQuestProcessor::watchProcesses);
+	registerMethod("processStatus", &ControlCenterQuestProcessor::processStatus);
+	registerMethod("burstSample", &ControlCenterQuestProcessor::burstSample);
+	registerMethod("burstSampleResult", &ControlCenterQuestProcessor::burstSampleResult);
+	registerMethod("burstSampleData", &ControlCenterQuestProcessor::burstSampleData);
+	registerMethod("machineStatusBackfill", &ControlCenterQuestProcessor::machineStatusBackfill);
 
 	registerMethod("registerDeployer", &ControlCenterQuestProcessor::registerDeployer);
 	registerMethod("registerMonitor", &ControlCenterQuestProcessor::registerMonitor);
+	registerMethod("actorLifecycle", &ControlCenterQuestProcessor::actorLifecycle);
+	registerMethod("systemCmdOutput", &ControlCenterQuestProcessor::systemCmdOutput);
 
 	registerMethod("registerActor", &ControlCenterQuestProcessor::registerActor);
 	registerMethod("actorStatus", &ControlCenterQuestProcessor::actorStatus);
 	registerMethod("actorResult", &ControlCenterQuestProcessor::actorResult);
+	registerMethod("actorStatusBatch", &ControlCenterQuestProcessor::actorStatusBatch);
 
 	prepareActorCache();
 	loadActorCache();
@@ -246,6 +247,22 @@ ControlCenterQuestProcessor::ControlCenterQuestProcessor(): _monitorMachineStatu
 	globalTaskIdGen = (int)time(NULL) & 0xFFFF;
 	_taskPool.init(0, 1, 0, 20);
 
+	_statusIngest.start((int)Setting::getInt("DATControlCenter.statusIngest.threads", 2),
+		(size_t)Setting::getInt("DATControlCenter.statusIngest.capacity", 16384),
+		[this](struct StatusMessage& message){ dispatchActorStatus(message); });
+
+	_subscriberPolicy = OverflowPolicy::KeepLatest;
+	std::string overflow = Setting::getString("DATControlCenter.subscriber.overflow", "keepLatest");
+	if (!TaskSubscriber::parsePolicy(overflow, _subscriberPolicy))
+		LOG_ERROR("Unknown subscriber overflow policy %s, use keepLatest.", overflow.c_str());
+
+	_subscriberMaxQueueSize = (size_t)Setting::getInt("DATControlCenter.subscriber.maxQueueSize", 65536);
+	_subscriberQueueSize = (size_t)Setting::getInt("DATControlCenter.subscriber.queueSize", 1024);
+	if (_subscriberQueueSize > _subscriberMaxQueueSize)
+		_subscriberQueueSize = _subscriberMaxQueueSize;
+	_subscriberWindow = (int)Setting::getInt("DATControlCenter.subscriber.window", 16);
+	_subscriberMaxRate = (int)Setting::getInt("DATControlCenter.subscriber.maxRate", 0);
+
 	_running = true;
 	_deployerMonitorThread = std::thread(&ControlCenterQuestProcessor::deployerMontiorCycle, this);
 }
@@ -254,6 +271,7 @@ ControlCenterQuestProcessor::~ControlCenterQuestProcessor()
 {
 	_running = false;
 	_deployerMonitorThread.join();
+	_statusIngest.stop();
 
 	_taskPool.release();
 }
@@ -346,6 +364,7 @@ void ControlCenterQuestProcessor::loadActorCache()
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
 		_actorInfos.swap(actorInfos);
+		publishAvailableActors();
 	}
 }
 
@@ -411,6 +430,7 @@ void ControlCenterQuestProcessor::addNewActor(const std::string& name, const std
 		_actorInfos[name].fileSize = (size_t)attrs.size;
 		_actorInfos[name].fileMd5 = attrs.sign;
 		_actorInfos[name].desc = desc;
+		publishAvailableActors();
 	}
 
 	persistentActorDesc();
@@ -419,40 +439,113 @@ void ControlCenterQuestProcessor::addNewActor(const std::string& name, const std
 void ControlCenterQuestProcessor::connected(const ConnectionInfo& ci)
 {
 	std::unique_lock<std::mutex> lck(_mutex);
-	_connData[ci.socket] = std::make_shared<ConnectionPrivateData>();
+	_connData.open(ci.socket);
+}
+
+/*
+	Agent reconnects with a new port, so machine status history is kept by region & host while agent is disconnected,
+	and is attached to the agent again when it re-registered, then the backfilled samples join it.
+*/
+static void detachHistory(std::map<struct DeployHost, std::deque<struct MachineStatusRecord>>& detached,
+	const struct DeployHost& host, std::deque<struct MachineStatusRecord>& history)
+{
+	int64_t expired = slack_real_sec() - (int64_t)gc_machineStatusHistorySize * 2;
+	for (auto iter = detached.begin(); iter != detached.end(); )
+	{
+		if (iter->second.empty() || iter->second.back().time < expired)
+			iter = detached.erase(iter);
+		else
+			++iter;
+	}
+
+	if (history.empty())
+		return;
+
+	struct DeployHost key;
+	key.region = host.region;
+	key.endpoint = endpointHost(host.endpoint);
+	detached[key].swap(history);
+}
+
+static void attachHistory(std::map<struct DeployHost, std::deque<struct MachineStatusRecord>>& detached,
+	const struct DeployHost& host, std::deque<struct MachineStatusRecord>& history)
+{
+	struct DeployHost key;
+	key.region = host.region;
+	key.endpoint = endpointHost(host.endpoint);
+
+	auto iter = detached.find(key);
+	if (iter == detached.end())
+		return;
+
+	if (history.empty())
+		history.swap(iter->second);
+
+	detached.erase(iter);
 }
 
 void ControlCenterQuestProcessor::connectionWillClose(const ConnectionInfo& connInfo, bool closeByError)
 {
 	std::unique_lock<std::mutex> lck(_mutex);
 
-	ConnectionPrivateDataPtr cpd = _connData[connInfo.socket];
-	if (cpd->_role == ClientRole::Deployer)
+	const struct ConnectionRecord& record = _connData[connInfo.socket];
+	if (record.role == ClientRole::Deployer)
 	{
-		_deployerInfos.erase(cpd->_deployHost);
+		auto iter = _deployerInfos.findEndpoint(record.endpointId);
+		if (iter != _deployerInfos.end())
+		{
+			detachHistory(_detachedDeployerHistories, iter->first, iter->second.history);
+			_deployerInfos.erase(iter);
+			_machineStatusSnapshot.touch();
+			_actorInfosSnapshot.touch();
+		}
 	}
-	else if (cpd->_role == ClientRole::Actor)
+	else if (record.role == ClientRole::Actor)
 	{
-		_runningActorInfos[cpd->_deployHost][cpd->_actorName].erase(cpd->_actorPid);
-		if (_runningActorInfos[cpd->_deployHost][cpd->_actorName].empty())
+		auto hostIter = _runningActorInfos.findEndpoint(record.endpointId);
+		if (hostIter != _runningActorInfos.end())
 		{
-			_runningActorInfos[cpd->_deployHost].erase(cpd->_actorName);
-			if (_runningActorInfos[cpd->_deployHost].empty())
-				_runningActorInfos.erase(cpd->_deployHost);
+			auto actorIter = hostIter->second.find(_connData.actorName(record));
+			if (actorIter != hostIter->second.end())
+			{
+				actorIter->second.erase(record.actorPid);
+				if (actorIter->second.empty())
+					hostIter->second.erase(actorIter);
+			}
+
+			unindexActorPid(record.endpointId, record.actorPid);
+
+			if (hostIter->second.empty())
+				_runningActorInfos.erase(hostIter);
+
+			_actorTaskStatusSnapshot.touch();
 		}
 	}
-	else if (cpd->_role == ClientRole::Monitor)
+	else if (record.role == ClientRole::Monitor)
 	{
-		_monitorInfos.erase(cpd->_deployHost);
-	} 
+		auto iter = _monitorInfos.findEndpoint(record.endpointId);
+		if (iter != _monitorInfos.end())
+		{
+			detachHistory(_detachedMonitorHistories, iter->first, iter->second.history);
+			_monitorInfos.erase(iter);
+			_machineStatusSnapshot.touch();
+		}
+	}
 
 	for (auto& pp: _monitorMap)
 		pp.second.erase(connInfo.socket);
 
-	if (cpd->_monitoringMachineStatus)
+	auto subscriberIter = _taskSubscribers.find(connInfo.socket);
+	if (subscriberIter != _taskSubscribers.end())
+	{
+		subscriberIter->second->close();
+		_taskSubscribers.erase(subscriberIter);
+	}
+
+	if (record.monitoringMachineStatus)
 		_monitorMachineStatus--;
 
-	_connData.erase(connInfo.socket);
+	_connData.close(connInfo.socket);
 }
 
 void ControlCenterQuestProcessor::adjustMachineDelay(bool deployerRole, struct DeployHost host, int64_t cost)
@@ -462,43 +555,169 @@ void ControlCenterQuestProcessor::adjustMachineDelay(bool deployerRole, struct D
 	{
 		auto iter = _deployerInfos.find(host);
 		if (iter != _deployerInfos.end())
+		{
 			iter->second.delayInMsec = cost/2;
+			publishMachineStatus("Deployer", iter->first, iter->second);
+		}
 	}
 	else
 	{
 		auto iter = _monitorInfos.find(host);
 		if (iter != _monitorInfos.end())
+		{
 			iter->second.delayInMsec = cost/2;
+			publishMachineStatus("Monitor", iter->first, iter->second);
+		}
 	}
 }
 
-void ControlCenterQuestProcessor::adjustMachineStatus(bool deployerRole, struct DeployHost host, int intervalSec, FPAReader& ar)
+//-- Fields of machineStatus answer, except the accumulated RX & TX.
+static void readMachineRecord(FPReader& ar, struct MachineStatusRecord& record)
+{
+	record.tcpCount = ar.wantInt("tcpConn");
+	record.udpCount = ar.wantInt("udpConn");
+	record.systemLoad = ar.wantDouble("sysLoad");
+	record.freeMemories = ar.wantInt("freeMemories");
+
+	//-- Old agents don't report cpu usage.
+	record.cpu.util = ar.getDouble("cpuUtil", 0);
+	record.cpu.user = ar.getDouble("cpuUser", 0);
+	record.cpu.system = ar.getDouble("cpuSystem", 0);
+	record.cpu.iowait = ar.getDouble("cpuIowait", 0);
+	record.cpu.irq = ar.getDouble("cpuIrq", 0);
+	record.cpu.softirq = ar.getDouble("cpuSoftirq", 0);
+	record.cpu.steal = ar.getDouble("cpuSteal", 0);
+	record.cpu.maxCoreUtil = ar.getDouble("maxCoreUtil", 0);
+	record.cpu.maxCore = ar.getInt("maxCore", -1);
+	record.cpu.cores = ar.get("cores", std::vector<std::vector<float>>());
+	record.netStack = ar.get("netStack", std::map<std::string, int64_t>());
+	record.io.pressure = ar.get("pressure", std::map<std::string, float>());
+	record.io.disks = ar.get("disks", std::map<std::string, std::vector<float>>());
+	record.io.vmstat = ar.get("vmstat", std::map<std::string, int64_t>());
+	record.processes = ar.get("processes", std::vector<std::vector<std::string>>());
+}
+
+void ControlCenterQuestProcessor::updateMachineInfo(struct MonitorInfo& info, int intervalSec, FPAReader& ar)
 {
-	float load = ar.wantDouble("sysLoad");
-	int tcpCount = ar.wantInt("tcpConn");
-	int udpCount = ar.wantInt("udpConn");
-	int64_t freeMemories = ar.wantInt("freeMemories");
 	uint64_t recvBytes = ar.wantInt("RX");
 	uint64_t sendBytes = ar.wantInt("TX");
 
+	struct MachineStatusRecord record;
+	record.time = slack_real_sec();
+	readMachineRecord(ar, record);
+
+	if (info.recvBytes)
+		info.recvBytesDiff = (recvBytes - info.recvBytes)/intervalSec;
+	if (info.sendBytes)
+		info.sendBytesDiff = (sendBytes - info.sendBytes)/intervalSec;
+
+	info.recvBytes = recvBytes;
+	info.sendBytes = sendBytes;
+
+	record.recvBytesDiff = info.recvBytesDiff;
+	record.sendBytesDiff = info.sendBytesDiff;
+
+	info.tcpCount = record.tcpCount;
+	info.udpCount = record.udpCount;
+	info.systemLoad = record.systemLoad;
+	info.freeMemories = record.freeMemories;
+	info.cpu = record.cpu;
+	info.netStack = record.netStack;
+	info.io = record.io;
+	info.processes = record.processes;
+
+	info.history.push_back(record);
+	if (info.history.size() > gc_machineStatusHistorySize)
+		info.history.pop_front();
+}
+
+//-- records are in time order. Samples taken after reconnected may be already in history, so insert by time.
+void ControlCenterQuestProcessor::backfillMachineInfo(struct MonitorInfo& info, const std::vector<std::string>& records)
+{
+	int64_t lastTime = 0;
+	uint64_t lastRecvBytes = 0;
+	uint64_t lastSendBytes = 0;
+
+	for (auto& raw: records)
+	{
+		FPReader ar(raw);
+		uint64_t recvBytes = ar.wantInt("RX");
+		uint64_t sendBytes = ar.wantInt("TX");
+
+		struct MachineStatusRecord record;
+		record.time = ar.wantInt("time");
+		readMachineRecord(ar, record);
+
+		record.recvBytesDiff = 0;
+		record.sendBytesDiff = 0;
+		if (lastTime && record.time > lastTime && recvBytes >= lastRecvBytes && sendBytes >= lastSendBytes)
+		{
+			record.recvBytesDiff = (recvBytes - lastRecvBytes)/(record.time - lastTime);
+			record.sendBytesDiff = (sendBytes - lastSendBytes)/(record.time - lastTime);
+		}
+
+		lastTime = record.time;
+		lastRecvBytes = recvBytes;
+		lastSendBytes = sendBytes;
+
+		auto pos = std::upper_bound(info.history.begin(), info.history.end(), record.time,
+			[](int64_t time, const struct MachineStatusRecord& r){ return time < r.time; });
+		info.history.insert(pos, record);
+	}
+
+	while (info.history.size() > gc_machineStatusHistorySize)
+		info.history.pop_front();
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::machineStatusBackfill(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string records = args->wantString("records");
+
+	if (args->getBool("zip", false))
+	{
+		if (!decompressRecords(records, args->wantInt("rawSize"), gc_maxRecordsRawLength))
+		{
+			LOG_ERROR("Decompress machine status backfill from %s failed.", ci.endpoint().c_str());
+			return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidTelemetryBatchCode, "Decompress machine status backfill failed.", "DATControlCenter");
+		}
+	}
+
+	FPReader reader(records);
+	std::vector<std::string> samples = reader.want("records", std::vector<std::string>());
+
+	std::unique_lock<std::mutex> lck(_mutex);
+	const struct ConnectionRecord& record = _connData[ci.socket];
+	if (record.role == ClientRole::Deployer)
+	{
+		auto iter = _deployerInfos.findEndpoint(record.endpointId);
+		if (iter != _deployerInfos.end())
+			backfillMachineInfo(iter->second, samples);
+	}
+	else if (record.role == ClientRole::Monitor)
+	{
+		auto iter = _monitorInfos.findEndpoint(record.endpointId);
+		if (iter != _monitorInfos.end())
+			backfillMachineInfo(iter->second, samples);
+	}
+
+	return FPAWriter::emptyAnswer(quest);
+}
+
+void ControlCenterQuestProcessor::adjustMachineStatus(bool deployerRole, struct DeployHost host, int intervalSec, FPAReader& ar)
+{
+	std::vector<std::vector<std::string>> cgroupRows;
+	if (deployerRole)
+		cgroupRows = ar.get("actorCgroups", cgroupRows);
+
 	std::unique_lock<std::mutex> lck(_mutex);
 	if (deployerRole)
 	{
 		auto iter = _deployerInfos.find(host);
 		if (iter != _deployerInfos.end())
 		{
-			iter->second.tcpCount = tcpCount;
-			iter->second.udpCount = udpCount;
-			iter->second.systemLoad = load;
-			iter->second.freeMemories = freeMemories;
-
-			if (iter->second.recvBytes)
-				iter->second.recvBytesDiff = (recvBytes - iter->second.recvBytes)/intervalSec;
-			if (iter->second.sendBytes)
-				iter->second.sendBytesDiff = (sendBytes - iter->second.sendBytes)/intervalSec;
-
-			iter->second.recvBytes = recvBytes;
-			iter->second.sendBytes = sendBytes;
+			adjustActorCgroups(iter->second, intervalSec, cgroupRows);
+			updateMachineInfo(iter->second, intervalSec, ar);
+			publishMachineStatus("Deployer", iter->first, iter->second);
 		}
 	}
 	else
@@ -506,20 +725,57 @@ void ControlCenterQuestProcessor::adjustMachineStatus(bool deployerRole, struct
 		auto iter = _monitorInfos.find(host);
 		if (iter != _monitorInfos.end())
 		{
-			iter->second.tcpCount = tcpCount;
-			iter->second.udpCount = udpCount;
-			iter->second.systemLoad = load;
-			iter->second.freeMemories = freeMemories;
-
-			if (iter->second.recvBytes)
-				iter->second.recvBytesDiff = (recvBytes - iter->second.recvBytes)/intervalSec;
-			if (iter->second.sendBytes)
-				iter->second.sendBytesDiff = (sendBytes - iter->second.sendBytes)/intervalSec;
-			
-			iter->second.recvBytes = recvBytes;
-			iter->second.sendBytes = sendBytes;
+			updateMachineInfo(iter->second, intervalSec, ar);
+			publishMachineStatus("Monitor", iter->first, iter->second);
+		}
+	}
+}
+
+void ControlCenterQuestProcessor::adjustActorCgroups(struct DeoplyerInfo& info, int intervalSec, const std::vector<std::vector<std::string>>& rows)
+{
+	//-- row: actor, pid, isolation, usageUsec, nrPeriods, nrThrottled, throttledUsec,
+	//--	memoryCurrent, anon, file, memoryHighEvents, memoryMaxEvents, oomKills
+	const size_t columnCount = 13;
+
+	std::map<int, struct ActorCgroupInfo> cgroups;
+	for (auto& row: rows)
+	{
+		if (row.size() < columnCount)
+			continue;
+
+		int pid = atoi(row[1].c_str());
+		struct ActorCgroupInfo& cg = cgroups[pid];
+
+		cg.actor = row[0];
+		cg.isolation = row[2];
+		cg.usageUsec = strtoull(row[3].c_str(), NULL, 10);
+		cg.nrPeriods = strtoull(row[4].c_str(), NULL, 10);
+		cg.nrThrottled = strtoull(row[5].c_str(), NULL, 10);
+		cg.throttledUsec = strtoull(row[6].c_str(), NULL, 10);
+		cg.memoryCurrent = strtoull(row[7].c_str(), NULL, 10);
+		cg.anonBytes = strtoull(row[8].c_str(), NULL, 10);
+		cg.fileBytes = strtoull(row[9].c_str(), NULL, 10);
+		cg.memoryHighEvents = strtoull(row[10].c_str(), NULL, 10);
+		cg.memoryMaxEvents = strtoull(row[11].c_str(), NULL, 10);
+		cg.oomKills = strtoull(row[12].c_str(), NULL, 10);
+
+		cg.cpuUsage = 0.0;
+		cg.throttledPercent = 0.0;
+		cg.throttledUsecDiff = 0;
+
+		auto iter = info.actorCgroups.find(pid);
+		if (iter != info.actorCgroups.end() && cg.usageUsec >= iter->second.usageUsec)
+		{
+			cg.cpuUsage = (cg.usageUsec - iter->second.usageUsec) / (intervalSec * 1000000.0);
+			cg.throttledUsecDiff = cg.throttledUsec - iter->second.throttledUsec;
+
+			uint64_t periods = cg.nrPeriods - iter->second.nrPeriods;
+			if (periods)
+				cg.throttledPercent = (cg.nrThrottled - iter->second.nrThrottled) * 100.0 / periods;
 		}
 	}
+
+	info.actorCgroups.swap(cgroups);
 }
 
 void ControlCenterQuestProcessor::deployerMontiorCycle()
@@ -539,6 +795,8 @@ void ControlCenterQuestProcessor::deployerMontiorCycle()
 			pingTicket = 0;
 		}
 
+		expireLaunchVerifications();
+
 		if (_monitorMachineStatus == 0)
 			continue;
 
@@ -619,6 +877,24 @@ std::map<struct DeployHost, QuestSenderPtr> ControlCenterQuestProcessor::fetchDe
 	return rev;
 }
 
+std::map<struct DeployHost, QuestSenderPtr> ControlCenterQuestProcessor::fetchMonitorSenders(const std::string& region, std::set<std::string>& ips)
+{
+	std::map<struct DeployHost, QuestSenderPtr> rev;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		for (auto& pp: _monitorInfos)
+		{
+			if (pp.first.region == region || ips.find(pp.first.endpoint) != ips.end())
+			{
+				ips.erase(pp.first.endpoint);
+				rev[pp.first] = pp.second.sender;
+			}
+		}
+	}
+
+	return rev;
+}
+
 class DeployCallback
 {
 	std::mutex _mutex;
@@ -729,13 +1005,17 @@ FPAnswerPtr ControlCenterQuestProcessor::uploadActor(const FPReaderPtr args, con
 	bool rev;
 	int taskId = 0;
 	int socket = ci.socket;
-	ConnectionPrivateData* addr;
+	ConnectionUpload* addr;
 	QuestSenderPtr sender = genQuestSender(ci);
 	ControlCenterQuestProcessorPtr CCQP = shared_from_this();
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
-		rev = _connData[socket]->fillUploadSection(name, desc, count, no, section, sender, CCQP);
-		addr = _connData[socket].get();
+		ConnectionUploadPtr& upload = _connData[socket].upload;
+		if (!upload)
+			upload = std::make_shared<ConnectionUpload>();
+
+		rev = upload->fillUploadSection(name, desc, count, no, section, sender, CCQP);
+		addr = upload.get();
 		taskId = addr->_upload->taskId;
 	}
 
@@ -759,61 +1039,59 @@ const std::vector<std::string> actorTaskStatusFields{"region", "endpoint", "acto
 
 FPAnswerPtr ControlCenterQuestProcessor::returnActorInfos(const FPQuestPtr quest)
 {
-	std::vector<std::vector<std::string>> availableActors, deployedActors;
+	FPAnswerPtr answer = _actorInfosSnapshot.reuse(quest);
+	if (answer)
+		return answer;
+
+	uint64_t version;
+	std::vector<SharedRows> availableActors, deployedActors;
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
+		version = _actorInfosSnapshot.version();
 
-		for (auto& pp: _actorInfos)
-		{
-			availableActors.push_back(std::vector<std::string>());
-			size_t idx = availableActors.size() - 1;
-
-			availableActors[idx].push_back(pp.first);
-			availableActors[idx].push_back(std::to_string(pp.second.fileSize));
-			availableActors[idx].push_back(std::to_string(pp.second.mtime));
-			availableActors[idx].push_back(pp.second.fileMd5);
-			availableActors[idx].push_back(pp.second.desc);
-		}
+		availableActors.push_back(_availableActorRows);
 
+		deployedActors.reserve(_deployerInfos.size());
 		for (auto& pp: _deployerInfos)
-		{
-			for (auto& pp2: pp.second.actorInfos)
-			{
-				deployedActors.push_back(std::vector<std::string>());
-				size_t idx = deployedActors.size() - 1;
-
-				deployedActors[idx].push_back(pp.first.region);
-				deployedActors[idx].push_back(pp.first.endpoint);
-				deployedActors[idx].push_back(pp2.first);
-				deployedActors[idx].push_back(std::to_string(pp2.second.fileSize));
-				deployedActors[idx].push_back(std::to_string(pp2.second.mtime));
-				deployedActors[idx].push_back(pp2.second.fileMd5);
-			}
-
-			if (pp.second.actorInfos.empty())
-			{
-				deployedActors.push_back(std::vector<std::string>());
-				size_t idx = deployedActors.size() - 1;
-
-				deployedActors[idx].push_back(pp.first.region);
-				deployedActors[idx].push_back(pp.first.endpoint);
-				deployedActors[idx].push_back("");
-				deployedActors[idx].push_back("");
-				deployedActors[idx].push_back("");
-				deployedActors[idx].push_back("");
-			}
-		}
+			deployedActors.push_back(pp.second.deployedActorRows);
 	}
 
 	FPAWriter aw(2, quest);
 	aw.paramMap("availableActors", 2);
 	aw.param("fields", availableActorsFields);
-	aw.param("rows", availableActors);
+	writeRows(aw, "rows", availableActors);
 	aw.paramMap("deployedActors", 2);
 	aw.param("fields", deployedActorFields);
-	aw.param("rows", deployedActors);
+	writeRows(aw, "rows", deployedActors);
 
-	return aw.take();
+	answer = aw.take();
+	_actorInfosSnapshot.publish(version, quest, answer);
+	return answer;
+}
+
+void ControlCenterQuestProcessor::publishAvailableActors()
+{
+	std::vector<std::vector<std::string>> rows;
+	appendAvailableActorRows(rows, _actorInfos);
+	_availableActorRows = shareRows(rows);
+	_actorInfosSnapshot.touch();
+}
+
+void ControlCenterQuestProcessor::publishMachineStatus(const char* source, const struct DeployHost& host, struct MonitorInfo& info)
+{
+	std::vector<std::vector<std::string>> rows;
+	appendMachineStatusRow(rows, source, host, info);
+	info.statusRows = shareRows(rows);
+	_machineStatusSnapshot.touch();
+}
+
+void ControlCenterQuestProcessor::publishActorTasks(const struct DeployHost& host, const std::string& actor, int pid,
+	struct ActorProcessInfo& info)
+{
+	std::vector<std::vector<std::string>> rows;
+	appendActorTaskRows(rows, host, actor, pid, info.taskMap);
+	info.taskRows = shareRows(rows);
+	_actorTaskStatusSnapshot.touch();
 }
 
 FPAnswerPtr ControlCenterQuestProcessor::reloadActorInfo(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
@@ -827,199 +1105,798 @@ FPAnswerPtr ControlCenterQuestProcessor::availableActors(const FPReaderPtr args,
 	return returnActorInfos(quest);
 }
 
-const std::vector<std::string> MachineStatusFields{"source", "region", "host", "ping/2 (msec)", "cpus", "load", "memories", "freeMemories", "tcpCount", "udpCount", "RX", "TX"};
+const std::vector<std::string> MachineStatusFields{"source", "region", "host", "ping/2 (msec)", "cpus", "load", "memories", "freeMemories", "tcpCount", "udpCount", "RX", "TX",
+	"cpu%", "usr%", "sys%", "iowait%", "irq%", "softirq%", "steal%", "maxCore%", "maxCore",
+	"cpuPSI%", "memPSI%", "memFullPSI%", "ioPSI%", "ioFullPSI%", "majorFaults", "swapIn", "swapOut",
+	"diskIOPS", "diskRead", "diskWrite", "maxDiskUtil%", "maxDisk"};
 
 FPAnswerPtr ControlCenterQuestProcessor::machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	std::vector<std::vector<std::string>> rows;
+	FPAnswerPtr answer = _machineStatusSnapshot.reuse(quest);
+	if (answer)
+		return answer;
+
+	uint64_t version;
+	std::vector<SharedRows> rows;
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
+		version = _machineStatusSnapshot.version();
 
+		rows.reserve(_deployerInfos.size() + _monitorInfos.size());
 		for (auto& pp: _deployerInfos)
-		{
-			std::string host;
-			int port;
-
-			if (!parseAddress(pp.first.endpoint, host, port))
-				host = pp.first.endpoint;
-		
-			rows.push_back(std::vector<std::string>());
-			size_t idx = rows.size() - 1;
-
-			rows[idx].push_back("Deployer");
-			rows[idx].push_back(pp.first.region);
-			rows[idx].push_back(host);
-			
-			rows[idx].push_back(std::to_string(pp.second.delayInMsec));
-			rows[idx].push_back(std::to_string(pp.second.cpuCount));
-			rows[idx].push_back(std::to_string(pp.second.systemLoad));
-
-			rows[idx].push_back(std::to_string(pp.second.memoryCount));
-			rows[idx].push_back(std::to_string(pp.second.freeMemories));
-			rows[idx].push_back(std::to_string(pp.second.tcpCount));
-			rows[idx].push_back(std::to_string(pp.second.udpCount));
-
-			rows[idx].push_back(std::to_string(pp.second.recvBytesDiff));
-			rows[idx].push_back(std::to_string(pp.second.sendBytesDiff));
-		}
+			rows.push_back(pp.second.statusRows);
 
 		for (auto& pp: _monitorInfos)
-		{
-			std::string host;
-			int port;
-
-			if (!parseAddress(pp.first.endpoint, host, port))
-				host = pp.first.endpoint;
-		
-			rows.push_back(std::vector<std::string>());
-			size_t idx = rows.size() - 1;
-
-			rows[idx].push_back("Monitor");
-			rows[idx].push_back(pp.first.region);
-			rows[idx].push_back(host);
-			
-			rows[idx].push_back(std::to_string(pp.second.delayInMsec));
-			rows[idx].push_back(std::to_string(pp.second.cpuCount));
-			rows[idx].push_back(std::to_string(pp.second.systemLoad));
-
-			rows[idx].push_back(std::to_string(pp.second.memoryCount));
-			rows[idx].push_back(std::to_string(pp.second.freeMemories));
-			rows[idx].push_back(std::to_string(pp.second.tcpCount));
-			rows[idx].push_back(std::to_string(pp.second.udpCount));
-
-			rows[idx].push_back(std::to_string(pp.second.recvBytesDiff));
-			rows[idx].push_back(std::to_string(pp.second.sendBytesDiff));
-		}
+			rows.push_back(pp.second.statusRows);
 	}
 	
 	FPAWriter aw(2, quest);
 	aw.param("fields", MachineStatusFields);
-	aw.param("rows", rows);
+	writeRows(aw, "rows", rows);
 
-	return aw.take();
+	answer = aw.take();
+	_machineStatusSnapshot.publish(version, quest, answer);
+	return answer;
 }
 
-FPAnswerPtr ControlCenterQuestProcessor::actorTaskStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+//-- Names reported by agents in machineStatus netStack: TCP counters, timeWait, then UDP counters.
+static std::vector<std::string> netStackFields()
 {
-	std::vector<std::vector<std::string>> rows;
-	{
-		std::unique_lock<std::mutex> lck(_mutex);
-		for (auto& pp: _runningActorInfos)
-		{
-			for (auto& pp2: pp.second)
-			{
-				for (auto& pp3: pp2.second)
-				{
-					for (auto& pp4: pp3.second.taskMap)
-					{
-						rows.push_back(std::vector<std::string>());
-						size_t idx = rows.size() - 1;
-
-						rows[idx].push_back(pp.first.region);
-						rows[idx].push_back(pp.first.endpoint);
-						rows[idx].push_back(pp2.first);
-						rows[idx].push_back(std::to_string(pp3.first));
-						rows[idx].push_back(std::to_string(pp4.first));
-						rows[idx].push_back(pp4.second[0]);
-						rows[idx].push_back(pp4.second[1]);
-					}
+	std::vector<std::string> names(gc_netStackCounterNames, gc_netStackCounterNames + UdpRcvbufErrors);
+	names.push_back(gc_netStackTimeWaitName);
+	names.insert(names.end(), gc_netStackCounterNames + UdpRcvbufErrors, gc_netStackCounterNames + NetStackCounterCount);
+	return names;
+}
 
-					if (pp3.second.taskMap.empty())
-					{
-						rows.push_back(std::vector<std::string>());
-						size_t idx = rows.size() - 1;
-
-						rows[idx].push_back(pp.first.region);
-						rows[idx].push_back(pp.first.endpoint);
-						rows[idx].push_back(pp2.first);
-						rows[idx].push_back(std::to_string(pp3.first));
-						rows[idx].push_back("");
-						rows[idx].push_back("");
-						rows[idx].push_back("");
-					}
-				}
-			}
-		}
+const std::vector<std::string> NetStackCounterNames = netStackFields();
+
+static void appendNetStack(std::vector<std::string>& row, const std::map<std::string, int64_t>& netStack)
+{
+	for (auto& name: NetStackCounterNames)
+	{
+		auto iter = netStack.find(name);
+		row.push_back((iter != netStack.end()) ? std::to_string(iter->second) : std::string("N/A"));
 	}
-	
-	FPAWriter aw(2, quest);
-	aw.param("fields", actorTaskStatusFields);
-	aw.param("rows", rows);
+}
 
-	return aw.take();
+static std::vector<std::string> machineStatusHistoryFields()
+{
+	std::vector<std::string> fields{"time", "source", "region", "host", "load", "tcpCount", "udpCount", "freeMemories", "RX", "TX",
+		"cpu%", "usr%", "sys%", "iowait%", "irq%", "softirq%", "steal%", "maxCore%", "maxCore", "coreUtils"};
+
+	fields.insert(fields.end(), NetStackCounterNames.begin(), NetStackCounterNames.end());
+
+	std::vector<std::string> tail{"cpuPSI%", "memPSI%", "memFullPSI%", "ioPSI%", "ioFullPSI%", "majorFaults", "swapIn", "swapOut",
+		"diskIOPS", "diskRead", "diskWrite", "maxDiskUtil%", "maxDisk"};
+	fields.insert(fields.end(), tail.begin(), tail.end());
+	return fields;
 }
 
-void ControlCenterQuestProcessor::actorTaskFinish(const std::string& endpoint, const std::string& actor, int pid, int taskId)
+const std::vector<std::string> MachineStatusHistoryFields = machineStatusHistoryFields();
+
+static bool matchMachine(const struct DeployHost& deployHost, const std::string& region, const std::set<std::string>& hosts)
 {
-	std::unique_lock<std::mutex> lck(_mutex);
-	for (auto& pp: _runningActorInfos)
+	if (region.empty() && hosts.empty())
+		return true;
+
+	if (region.size() && deployHost.region == region)
+		return true;
+
+	if (hosts.find(deployHost.endpoint) != hosts.end())
+		return true;
+
+	std::string host;
+	int port;
+	return parseAddress(deployHost.endpoint, host, port) && hosts.find(host) != hosts.end();
+}
+
+static void appendMachineHistoryRows(std::vector<std::vector<std::string>>& rows, const char* source, const struct DeployHost& deployHost,
+	const struct MonitorInfo& info, int64_t since)
+{
+	std::string host;
+	int port;
+
+	if (!parseAddress(deployHost.endpoint, host, port))
+		host = deployHost.endpoint;
+
+	for (auto& record: info.history)
 	{
-		if (pp.first.endpoint == endpoint)
+		if (record.time < since)
+			continue;
+
+		rows.push_back(std::vector<std::string>());
+		std::vector<std::string>& row = rows.back();
+
+		row.push_back(std::to_string(record.time));
+		row.push_back(source);
+		row.push_back(deployHost.region);
+		row.push_back(host);
+		row.push_back(std::to_string(record.systemLoad));
+		row.push_back(std::to_string(record.tcpCount));
+		row.push_back(std::to_string(record.udpCount));
+		row.push_back(std::to_string(record.freeMemories));
+		row.push_back(std::to_string(record.recvBytesDiff));
+		row.push_back(std::to_string(record.sendBytesDiff));
+
+		appendCpuStatus(row, record.cpu);
+
+		std::string coreUtils;
+		for (auto& core: record.cpu.cores)
 		{
-			auto actorIter = pp.second.find(actor);
-			if (actorIter != pp.second.end())
-			{
-				auto pidIter = actorIter->second.find(pid);
-				if (pidIter != actorIter->second.end())
-					pidIter->second.taskMap.erase(taskId);
-			}
-			break;
+			if (coreUtils.size())
+				coreUtils.append(",");
+			coreUtils.append(std::to_string((int)(core.size() > 6 ? core[6] + 0.5 : 0)));
 		}
-	}
+		row.push_back(coreUtils);
 
-	_monitorMap.erase(taskId);
+		appendNetStack(row, record.netStack);
+		appendIoStatus(row, record.io);
+	}
 }
 
-FPAnswerPtr ControlCenterQuestProcessor::actorAction(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+FPAnswerPtr ControlCenterQuestProcessor::machineStatusHistory(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	std::string actor = args->wantString("actor");
-	std::string endpoint = args->wantString("endpoint");
-	int pid = args->wantInt("pid");
-	std::string method = args->wantString("method");
-	std::string payload = args->wantString("payload");
-	std::string taskDesc = args->getString("taskDesc");
+	std::string region = args->getString("region");
+	std::set<std::string> hosts = args->get("endpoints", std::set<std::string>());
+	int64_t seconds = args->getInt("seconds", 0);
+	int64_t since = seconds > 0 ? slack_real_sec() - seconds : 0;
 
-	int taskId = 0;
-	QuestSenderPtr sender;
+	std::vector<std::vector<std::string>> rows;
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
-		for (auto& pp: _runningActorInfos)
-		{
-			if (pp.first.endpoint == endpoint)
-			{
-				auto actorIter = pp.second.find(actor);
-				if (actorIter != pp.second.end())
-				{
-					auto pidIter = actorIter->second.find(pid);
-					if (pidIter != actorIter->second.end())
-					{
-						sender = pidIter->second.sender;
 
-						taskId = globalTaskIdGen++;
-						pidIter->second.taskMap[taskId].push_back(method);
-						pidIter->second.taskMap[taskId].push_back(taskDesc);
-					}
-				}
-				break;
-			}
-		}
+		for (auto& pp: _deployerInfos)
+			if (matchMachine(pp.first, region, hosts))
+				appendMachineHistoryRows(rows, "Deployer", pp.first, pp.second, since);
 
-		_monitorMap[taskId][ci.socket] = genQuestSender(ci);
+		for (auto& pp: _monitorInfos)
+			if (matchMachine(pp.first, region, hosts))
+				appendMachineHistoryRows(rows, "Monitor", pp.first, pp.second, since);
 	}
 
-	if (sender)
-	{
-		FPQWriter qw(3, "action");
-		qw.param("taskId", taskId);
-		qw.param("method", method);
-		qw.param("payload", payload);
+	FPAWriter aw(2, quest);
+	aw.param("fields", MachineStatusHistoryFields);
+	aw.param("rows", rows);
 
-		IAsyncAnswerPtr async = genAsyncAnswer(quest);
-		ControlCenterQuestProcessorPtr CCQP = shared_from_this();
-		bool status = sender->sendQuest(qw.take(), [async, taskId, endpoint, actor, pid, CCQP](FPAnswerPtr answer, int errorCode){
-			if (errorCode == FPNN_EC_OK)
-			{
-				FPAWriter aw(1, async->getQuest());
+	return aw.take();
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::netStackStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string region = args->getString("region");
+	std::set<std::string> hosts = args->get("endpoints", std::set<std::string>());
+
+	std::vector<std::string> fields{"source", "region", "host"};
+	fields.insert(fields.end(), NetStackCounterNames.begin(), NetStackCounterNames.end());
+
+	std::vector<std::vector<std::string>> rows;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+
+		for (auto& pp: _deployerInfos)
+		{
+			if (!matchMachine(pp.first, region, hosts))
+				continue;
+
+			rows.push_back(std::vector<std::string>{"Deployer", pp.first.region, pp.first.endpoint});
+			appendNetStack(rows.back(), pp.second.netStack);
+		}
+
+		for (auto& pp: _monitorInfos)
+		{
+			if (!matchMachine(pp.first, region, hosts))
+				continue;
+
+			rows.push_back(std::vector<std::string>{"Monitor", pp.first.region, pp.first.endpoint});
+			appendNetStack(rows.back(), pp.second.netStack);
+		}
+	}
+
+	FPAWriter aw(2, quest);
+	aw.param("fields", fields);
+	aw.param("rows", rows);
+
+	return aw.take();
+}
+
+const std::vector<std::string> DiskStatusFields{"source", "region", "host", "disk", "readIOPS", "writeIOPS", "readBytes/s", "writeBytes/s", "await (msec)", "util%"};
+
+static void appendDiskRows(std::vector<std::vector<std::string>>& rows, const char* source, const struct DeployHost& deployHost,
+	const struct MonitorInfo& info)
+{
+	std::string host;
+	int port;
+
+	if (!parseAddress(deployHost.endpoint, host, port))
+		host = deployHost.endpoint;
+
+	for (auto& pp: info.io.disks)
+	{
+		rows.push_back(std::vector<std::string>{source, deployHost.region, host, pp.first});
+		std::vector<std::string>& row = rows.back();
+
+		for (size_t i = 0; i < 6; i++)
+			row.push_back(i < pp.second.size() ? std::to_string(pp.second[i]) : std::string("N/A"));
+	}
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::diskStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string region = args->getString("region");
+	std::set<std::string> hosts = args->get("endpoints", std::set<std::string>());
+
+	std::vector<std::vector<std::string>> rows;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+
+		for (auto& pp: _deployerInfos)
+			if (matchMachine(pp.first, region, hosts))
+				appendDiskRows(rows, "Deployer", pp.first, pp.second);
+
+		for (auto& pp: _monitorInfos)
+			if (matchMachine(pp.first, region, hosts))
+				appendDiskRows(rows, "Monitor", pp.first, pp.second);
+	}
+
+	FPAWriter aw(2, quest);
+	aw.param("fields", DiskStatusFields);
+	aw.param("rows", rows);
+
+	return aw.take();
+}
+
+const std::vector<std::string> ProcessStatusFields{"time", "source", "region", "host", "pid", "name", "watchedBy", "cpu%", "usr%", "sys%",
+	"rssKB", "threads", "voluntaryCtxSw/s", "involuntaryCtxSw/s", "fds", "readBytes/s", "writeBytes/s"};
+
+static void appendProcessRows(std::vector<std::vector<std::string>>& rows, const char* source, const struct DeployHost& deployHost,
+	int64_t time, const std::vector<std::vector<std::string>>& processes)
+{
+	std::string host;
+	int port;
+
+	if (!parseAddress(deployHost.endpoint, host, port))
+		host = deployHost.endpoint;
+
+	for (auto& process: processes)
+	{
+		rows.push_back(std::vector<std::string>{std::to_string(time), source, deployHost.region, host});
+		rows.back().insert(rows.back().end(), process.begin(), process.end());
+	}
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::processStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string region = args->getString("region");
+	std::set<std::string> hosts = args->get("endpoints", std::set<std::string>());
+	int64_t seconds = args->getInt("seconds", 0);
+	int64_t since = slack_real_sec() - seconds;
+
+	std::vector<std::vector<std::string>> rows;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+
+		for (auto& pp: _deployerInfos)
+		{
+			if (!matchMachine(pp.first, region, hosts) || pp.second.history.empty())
+				continue;
+
+			if (seconds <= 0)
+				appendProcessRows(rows, "Deployer", pp.first, pp.second.history.back().time, pp.second.processes);
+			else
+				for (auto& record: pp.second.history)
+					if (record.time >= since)
+						appendProcessRows(rows, "Deployer", pp.first, record.time, record.processes);
+		}
+
+		for (auto& pp: _monitorInfos)
+		{
+			if (!matchMachine(pp.first, region, hosts) || pp.second.history.empty())
+				continue;
+
+			if (seconds <= 0)
+				appendProcessRows(rows, "Monitor", pp.first, pp.second.history.back().time, pp.second.processes);
+			else
+				for (auto& record: pp.second.history)
+					if (record.time >= since)
+						appendProcessRows(rows, "Monitor", pp.first, record.time, record.processes);
+		}
+	}
+
+	FPAWriter aw(2, quest);
+	aw.param("fields", ProcessStatusFields);
+	aw.param("rows", rows);
+
+	return aw.take();
+}
+
+class WatchProcessesCallback
+{
+	std::mutex _mutex;
+	IAsyncAnswerPtr _async;
+	std::set<std::string> _failedEndpoints;
+
+public:
+	WatchProcessesCallback(std::set<std::string> invalidEndpoints, IAsyncAnswerPtr async): _async(async)
+	{
+		_failedEndpoints = invalidEndpoints;
+	}
+	~WatchProcessesCallback()
+	{
+		if (_failedEndpoints.empty())
+			_async->sendAnswer(FPAWriter(1, _async->getQuest())("ok", true));
+		else
+		{
+			FPAWriter aw(2, _async->getQuest());
+			aw.param("ok", false);
+			aw.param("failedEndpoints", _failedEndpoints);
+			_async->sendAnswer(aw.take());
+		}
+	}
+
+	void addFailedEndpoint(const std::string& endpoint)
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		_failedEndpoints.insert(endpoint);
+	}
+};
+
+FPAnswerPtr ControlCenterQuestProcessor::watchProcesses(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	const std::string def("<no-region>");
+
+	std::string region = args->getString("region", def);
+	std::set<std::string> endpoints = args->get("endpoints", std::set<std::string>());
+	std::set<int> pids = args->get("pids", std::set<int>());
+	std::vector<std::string> names = args->get("names", std::vector<std::string>());
+	bool actors = args->getBool("actors", false);
+
+	std::map<struct DeployHost, QuestSenderPtr> senders = fetchDeployerSenders(region, endpoints);
+	std::map<struct DeployHost, QuestSenderPtr> monitorSenders = fetchMonitorSenders(region, endpoints);
+	senders.insert(monitorSenders.begin(), monitorSenders.end());
+
+	std::shared_ptr<WatchProcessesCallback> allCB(new WatchProcessesCallback(endpoints, genAsyncAnswer(quest)));
+
+	FPQWriter qw(3, "watchProcesses");
+	qw.param("pids", pids);
+	qw.param("names", names);
+	qw.param("actors", actors);
+	FPQuestPtr orgQuest = qw.take();
+
+	for (auto& pp: senders)
+	{
+		std::string endpoint = pp.first.endpoint;
+		bool status = pp.second->sendQuest(orgQuest, [endpoint, allCB](FPAnswerPtr answer, int errorCode){
+			if (errorCode != FPNN_EC_OK)
+				allCB->addFailedEndpoint(endpoint);
+		});
+		if (!status)
+			allCB->addFailedEndpoint(endpoint);
+	}
+
+	return nullptr;
+}
+
+const size_t gc_burstSampleTaskLimit = 16;
+
+class BurstSampleCallback
+{
+	std::mutex _mutex;
+	IAsyncAnswerPtr _async;
+	int _taskId;
+	std::set<std::string> _failedEndpoints;
+	std::map<std::string, int> _samples;
+
+public:
+	BurstSampleCallback(std::set<std::string> invalidEndpoints, IAsyncAnswerPtr async, int taskId): _async(async), _taskId(taskId)
+	{
+		_failedEndpoints = invalidEndpoints;
+	}
+	~BurstSampleCallback()
+	{
+		if (_failedEndpoints.empty())
+		{
+			FPAWriter aw(3, _async->getQuest());
+			aw.param("ok", true);
+			aw.param("taskId", _taskId);
+			aw.param("samples", _samples);
+			_async->sendAnswer(aw.take());
+		}
+		else
+		{
+			FPAWriter aw(4, _async->getQuest());
+			aw.param("ok", false);
+			aw.param("taskId", _taskId);
+			aw.param("failedEndpoints", _failedEndpoints);
+			aw.param("samples", _samples);
+			_async->sendAnswer(aw.take());
+		}
+	}
+
+	void addFailedEndpoint(const std::string& endpoint)
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		_failedEndpoints.insert(endpoint);
+	}
+
+	void addSamples(const std::string& endpoint, int count)
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		_samples[endpoint] = count;
+	}
+};
+
+FPAnswerPtr ControlCenterQuestProcessor::burstSample(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	const std::string def("<no-region>");
+
+	std::string region = args->getString("region", def);
+	std::set<std::string> endpoints = args->get("endpoints", std::set<std::string>());
+	int intervalMs = (int)args->getInt("intervalMs", 10);
+	int durationSec = (int)args->wantInt("durationSec");
+
+	std::map<struct DeployHost, QuestSenderPtr> senders = fetchDeployerSenders(region, endpoints);
+	std::map<struct DeployHost, QuestSenderPtr> monitorSenders = fetchMonitorSenders(region, endpoints);
+	senders.insert(monitorSenders.begin(), monitorSenders.end());
+
+	int taskId = globalTaskIdGen++;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		struct BurstSampleTask& task = _burstSampleTasks[taskId];
+		task.intervalMs = intervalMs;
+		task.durationSec = durationSec;
+		task.requester = genQuestSender(ci);
+		for (auto& pp: senders)
+			task.pending.insert(pp.first.endpoint);
+
+		//-- Task ids are increasing, the oldest task is the first one.
+		while (_burstSampleTasks.size() > gc_burstSampleTaskLimit)
+			_burstSampleTasks.erase(_burstSampleTasks.begin());
+	}
+
+	std::shared_ptr<BurstSampleCallback> allCB(new BurstSampleCallback(endpoints, genAsyncAnswer(quest), taskId));
+
+	FPQWriter qw(3, "burstSample");
+	qw.param("taskId", taskId);
+	qw.param("intervalMs", intervalMs);
+	qw.param("durationSec", durationSec);
+	FPQuestPtr orgQuest = qw.take();
+
+	ControlCenterQuestProcessorPtr CCQP = shared_from_this();
+	for (auto& pp: senders)
+	{
+		std::string endpoint = pp.first.endpoint;
+		bool status = pp.second->sendQuest(orgQuest, [endpoint, taskId, allCB, CCQP](FPAnswerPtr answer, int errorCode){
+			bool started = false;
+			if (errorCode == FPNN_EC_OK)
+			{
+				FPAReader ar(answer);
+				started = ar.getBool("ok", false);
+				allCB->addSamples(endpoint, (int)ar.getInt("samples", 0));
+			}
+
+			if (!started)
+			{
+				allCB->addFailedEndpoint(endpoint);
+				CCQP->cancelBurstSample(taskId, endpoint);
+			}
+		});
+		if (!status)
+		{
+			allCB->addFailedEndpoint(endpoint);
+			cancelBurstSample(taskId, endpoint);
+		}
+	}
+
+	return nullptr;
+}
+
+void ControlCenterQuestProcessor::cancelBurstSample(int taskId, const std::string& endpoint)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	auto iter = _burstSampleTasks.find(taskId);
+	if (iter != _burstSampleTasks.end())
+		iter->second.pending.erase(endpoint);
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::burstSampleData(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	int taskId = args->wantInt("taskId");
+	std::string records = args->wantString("records");
+
+	if (args->getBool("zip", false))
+	{
+		if (!decompressRecords(records, args->wantInt("rawSize"), gc_maxRecordsRawLength))
+		{
+			LOG_ERROR("Decompress burst samples of task %d from %s failed.", taskId, ci.endpoint().c_str());
+			return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidTelemetryBatchCode, "Decompress burst samples failed.", "DATControlCenter");
+		}
+	}
+
+	struct BurstSampleResult result;
+	FPReader reader(records);
+	result.startMsec = reader.wantInt("startMsec");
+	result.fields = reader.want("fields", std::vector<std::string>());
+	result.columns = reader.want("columns", std::vector<std::vector<float>>());
+
+	std::string endpoint = ci.endpoint();
+	QuestSenderPtr requester;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		auto iter = _burstSampleTasks.find(taskId);
+		if (iter == _burstSampleTasks.end())
+		{
+			LOG_ERROR("Burst samples of task %d from %s are dropped. Task is expired.", taskId, endpoint.c_str());
+			return FPAWriter::emptyAnswer(quest);
+		}
+
+		result.region = _connData.region(_connData[ci.socket]);
+
+		struct BurstSampleTask& task = iter->second;
+		task.results[endpoint] = std::move(result);
+		task.pending.erase(endpoint);
+		if (task.pending.empty())
+			requester = task.requester;
+	}
+
+	if (requester)
+	{
+		FPQWriter qw(1, "burstSampleFinished", true);
+		qw.param("taskId", taskId);
+		requester->sendQuest(qw.take(), [](FPAnswerPtr, int){});
+	}
+
+	return FPAWriter::emptyAnswer(quest);
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::burstSampleResult(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	int taskId = args->wantInt("taskId");
+	std::set<std::string> endpoints = args->get("endpoints", std::set<std::string>());
+
+	std::vector<std::string> fields;
+	std::vector<std::string> resultEndpoints;
+	std::vector<std::string> regions;
+	std::vector<int64_t> startMsecs;
+	std::vector<std::vector<std::vector<float>>> columns;
+	std::set<std::string> pending;
+	int intervalMs;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		auto iter = _burstSampleTasks.find(taskId);
+		if (iter == _burstSampleTasks.end())
+			return FPAWriter::errorAnswer(quest, ErrorInfo::BurstSampleTaskNotExistCode, "Burst sample task is not exist or expired.", "DATControlCenter");
+
+		intervalMs = iter->second.intervalMs;
+		pending = iter->second.pending;
+		for (auto& pp: iter->second.results)
+		{
+			if (endpoints.size() && endpoints.find(pp.first) == endpoints.end())
+				continue;
+
+			if (fields.empty())
+				fields = pp.second.fields;
+
+			resultEndpoints.push_back(pp.first);
+			regions.push_back(pp.second.region);
+			startMsecs.push_back(pp.second.startMsec);
+			columns.push_back(pp.second.columns);
+		}
+	}
+
+	FPAWriter aw(8, quest);
+	aw.param("finished", pending.empty());
+	aw.param("pending", pending);
+	aw.param("intervalMs", intervalMs);
+	aw.param("fields", fields);
+	aw.param("endpoints", resultEndpoints);
+	aw.param("regions", regions);
+	aw.param("startMsec", startMsecs);
+	aw.param("columns", columns);
+
+	return aw.take();
+}
+
+const std::vector<std::string> MachineCoreStatusFields{"source", "region", "host", "core", "usr%", "sys%", "iowait%", "irq%", "softirq%", "steal%", "util%"};
+
+static void appendMachineCoreRows(std::vector<std::vector<std::string>>& rows, const char* source, const struct DeployHost& deployHost,
+	const struct MonitorInfo& info)
+{
+	std::string host;
+	int port;
+
+	if (!parseAddress(deployHost.endpoint, host, port))
+		host = deployHost.endpoint;
+
+	for (size_t i = 0; i < info.cpu.cores.size(); i++)
+	{
+		rows.push_back(std::vector<std::string>());
+		std::vector<std::string>& row = rows.back();
+
+		row.push_back(source);
+		row.push_back(deployHost.region);
+		row.push_back(host);
+		row.push_back(std::to_string(i));
+
+		for (float value: info.cpu.cores[i])
+			row.push_back(std::to_string(value));
+	}
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::machineCoreStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string region = args->getString("region");
+	std::set<std::string> hosts = args->get("endpoints", std::set<std::string>());
+
+	std::vector<std::vector<std::string>> rows;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+
+		for (auto& pp: _deployerInfos)
+			if (matchMachine(pp.first, region, hosts))
+				appendMachineCoreRows(rows, "Deployer", pp.first, pp.second);
+
+		for (auto& pp: _monitorInfos)
+			if (matchMachine(pp.first, region, hosts))
+				appendMachineCoreRows(rows, "Monitor", pp.first, pp.second);
+	}
+
+	FPAWriter aw(2, quest);
+	aw.param("fields", MachineCoreStatusFields);
+	aw.param("rows", rows);
+
+	return aw.take();
+}
+
+const std::vector<std::string> ActorCgroupsFields{"region", "host", "actor", "pid", "isolation", "cpuUsage", "throttled%", "throttledMsec",
+	"memory", "anon", "file", "memHighEvents", "memMaxEvents", "oomKills"};
+
+FPAnswerPtr ControlCenterQuestProcessor::actorCgroups(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::vector<std::vector<std::string>> rows;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+
+		for (auto& pp: _deployerInfos)
+		{
+			std::string host;
+			int port;
+
+			if (!parseAddress(pp.first.endpoint, host, port))
+				host = pp.first.endpoint;
+
+			for (auto& cpp: pp.second.actorCgroups)
+			{
+				rows.push_back(std::vector<std::string>());
+				std::vector<std::string>& row = rows.back();
+
+				row.push_back(pp.first.region);
+				row.push_back(host);
+				row.push_back(cpp.second.actor);
+				row.push_back(std::to_string(cpp.first));
+				row.push_back(cpp.second.isolation);
+				row.push_back(std::to_string(cpp.second.cpuUsage));
+				row.push_back(std::to_string(cpp.second.throttledPercent));
+				row.push_back(std::to_string(cpp.second.throttledUsecDiff / 1000));
+				row.push_back(std::to_string(cpp.second.memoryCurrent));
+				row.push_back(std::to_string(cpp.second.anonBytes));
+				row.push_back(std::to_string(cpp.second.fileBytes));
+				row.push_back(std::to_string(cpp.second.memoryHighEvents));
+				row.push_back(std::to_string(cpp.second.memoryMaxEvents));
+				row.push_back(std::to_string(cpp.second.oomKills));
+			}
+		}
+	}
+
+	FPAWriter aw(2, quest);
+	aw.param("fields", ActorCgroupsFields);
+	aw.param("rows", rows);
+
+	return aw.take();
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::actorTaskStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	FPAnswerPtr answer = _actorTaskStatusSnapshot.reuse(quest);
+	if (answer)
+		return answer;
+
+	uint64_t version;
+	std::vector<SharedRows> rows;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		version = _actorTaskStatusSnapshot.version();
+
+		rows.reserve(_runningActorInfos.size());
+		for (auto& pp: _runningActorInfos)
+			for (auto& pp2: pp.second)
+				for (auto& pp3: pp2.second)
+					rows.push_back(pp3.second.taskRows);
+	}
+	
+	FPAWriter aw(2, quest);
+	aw.param("fields", actorTaskStatusFields);
+	writeRows(aw, "rows", rows);
+
+	answer = aw.take();
+	_actorTaskStatusSnapshot.publish(version, quest, answer);
+	return answer;
+}
+
+void ControlCenterQuestProcessor::actorTaskFinish(const std::string& endpoint, const std::string& actor, int pid, int taskId)
+{
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		auto hostIter = _runningActorInfos.findEndpoint(endpoint);
+		if (hostIter != _runningActorInfos.end())
+		{
+			auto actorIter = hostIter->second.find(actor);
+			if (actorIter != hostIter->second.end())
+			{
+				auto pidIter = actorIter->second.find(pid);
+				if (pidIter != actorIter->second.end())
+				{
+					pidIter->second.taskMap.erase(taskId);
+					publishActorTasks(hostIter->first, actor, pid, pidIter->second);
+				}
+			}
+		}
+	}
+
+	//-- Subscriptions are closed after the queued status & results of the task are forwarded.
+	struct StatusMessage message;
+	message.taskId = taskId;
+	message.kind = StatusKind::Finished;
+	_statusIngest.push(message);
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::actorAction(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string actor = args->wantString("actor");
+	std::string endpoint = args->wantString("endpoint");
+	int pid = args->wantInt("pid");
+	std::string method = args->wantString("method");
+	std::string payload = args->wantString("payload");
+	std::string taskDesc = args->getString("taskDesc");
+
+	int taskId = 0;
+	QuestSenderPtr sender;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		auto hostIter = _runningActorInfos.findEndpoint(endpoint);
+		if (hostIter != _runningActorInfos.end())
+		{
+			auto actorIter = hostIter->second.find(actor);
+			if (actorIter != hostIter->second.end())
+			{
+				auto pidIter = actorIter->second.find(pid);
+				if (pidIter != actorIter->second.end())
+				{
+					sender = pidIter->second.sender;
+
+					taskId = globalTaskIdGen++;
+					pidIter->second.taskMap[taskId].push_back(method);
+					pidIter->second.taskMap[taskId].push_back(taskDesc);
+					publishActorTasks(hostIter->first, actor, pid, pidIter->second);
+				}
+			}
+		}
+
+		_monitorMap[taskId][ci.socket] = TaskSubscription(taskSubscriber(ci), nullptr);
+	}
+
+	if (sender)
+	{
+		FPQWriter qw(3, "action");
+		qw.param("taskId", taskId);
+		qw.param("method", method);
+		qw.param("payload", payload);
+
+		IAsyncAnswerPtr async = genAsyncAnswer(quest);
+		ControlCenterQuestProcessorPtr CCQP = shared_from_this();
+		bool status = sender->sendQuest(qw.take(), [async, taskId, endpoint, actor, pid, CCQP](FPAnswerPtr answer, int errorCode){
+			if (errorCode == FPNN_EC_OK)
+			{
+				FPAWriter aw(1, async->getQuest());
 				aw.param("taskId", taskId);
 
 				async->sendAnswer(aw.take());
@@ -1054,25 +1931,37 @@ class SystemCmdCallback
 	std::mutex _mutex;
 	IAsyncAnswerPtr _async;
 	std::map<std::string, int> _failedEndpoints;
+	std::map<std::string, std::vector<std::vector<int64_t>>> _results;
+	int _taskId;
+	ControlCenterQuestProcessorPtr _CCQP;
+
 public:
-	SystemCmdCallback(std::set<std::string> invalidEndpoints, IAsyncAnswerPtr async): _async(async)
+	SystemCmdCallback(std::set<std::string> invalidEndpoints, IAsyncAnswerPtr async, int taskId, ControlCenterQuestProcessorPtr ccqp):
+		_async(async), _taskId(taskId), _CCQP(ccqp)
 	{
 		for (auto& endpoint: invalidEndpoints)
 			_failedEndpoints[endpoint] = 0;
 	}
 	~SystemCmdCallback()
 	{
+		if (_taskId)
+			_CCQP->finishCmdOutput(_taskId);
+
 		if (_failedEndpoints.empty())
 		{
-			FPAWriter aw(1, _async->getQuest());
+			FPAWriter aw(3, _async->getQuest());
 			aw.param("ok", true);
+			aw.param("taskId", _taskId);
+			aw.param("results", _results);
 			_async->sendAnswer(aw.take());
 		}
 		else
 		{
-			FPAWriter aw(2, _async->getQuest());
+			FPAWriter aw(4, _async->getQuest());
 			aw.param("ok", false);
 			aw.param("failedEndpoints", _failedEndpoints);
+			aw.param("taskId", _taskId);
+			aw.param("results", _results);
 			_async->sendAnswer(aw.take());
 		}
 	}
@@ -1082,6 +1971,12 @@ public:
 		std::unique_lock<std::mutex> lck(_mutex);
 		_failedEndpoints[endpoint] = line;
 	}
+
+	void addResults(const std::string& endpoint, const std::vector<std::vector<int64_t>>& results)
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		_results[endpoint] = results;
+	}
 };
 
 FPAnswerPtr ControlCenterQuestProcessor::systemCmd(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
@@ -1091,14 +1986,42 @@ FPAnswerPtr ControlCenterQuestProcessor::systemCmd(const FPReaderPtr args, const
 	std::string region = args->getString("region", def);
 	std::set<std::string> endpoints = args->get("endpoints", std::set<std::string>());
 	std::vector<std::string> cmdLines = args->want("cmdLines", std::vector<std::string>());
+	bool stream = args->getBool("stream", false);
+	int parallel = (int)args->getInt("parallel", 1);
+	int timeout = (int)args->getInt("timeout", 0);
 
 	std::map<struct DeployHost, QuestSenderPtr> ipmap = fetchDeployerSenders(region, endpoints);
-	std::shared_ptr<SystemCmdCallback> allCB(new SystemCmdCallback(endpoints, genAsyncAnswer(quest)));
 
-	FPQWriter qw(1, "systemCmd");
+	int taskId = 0;
+	if (stream)
+	{
+		taskId = globalTaskIdGen++;
+
+		std::unique_lock<std::mutex> lck(_mutex);
+		struct CmdOutputTask& task = _cmdOutputMap[taskId];
+		task.requester = genQuestSender(ci);
+		for (auto& pp: ipmap)
+			task.endpoints.insert(pp.first.endpoint);
+	}
+
+	std::shared_ptr<SystemCmdCallback> allCB(new SystemCmdCallback(endpoints, genAsyncAnswer(quest), taskId, shared_from_this()));
+
+	FPQWriter qw(5, "systemCmd");
 	qw.param("cmdLines", cmdLines);
+	qw.param("parallel", parallel);
+	qw.param("timeout", timeout);
+	qw.param("stream", stream);
+	qw.param("taskId", taskId);
 	FPQuestPtr orgQuest = qw.take();
 
+	//-- Commands may run longer than the default quest timeout. 0: use default.
+	int questTimeout = 0;
+	if (timeout > 0)
+	{
+		int rounds = (parallel > 1) ? (int)((cmdLines.size() + parallel - 1) / parallel) : (int)cmdLines.size();
+		questTimeout = timeout * rounds + 5;
+	}
+
 	for (auto& pp: ipmap)
 	{
 		std::string endpoint = pp.first.endpoint;
@@ -1110,38 +2033,112 @@ FPAnswerPtr ControlCenterQuestProcessor::systemCmd(const FPReaderPtr args, const
 				FPAReader ar(answer);
 				if (!ar.wantBool("ok"))
 					allCB->addFailedCase(endpoint, ar.wantInt("failedLine"));
+
+				allCB->addResults(endpoint, ar.get("results", std::vector<std::vector<int64_t>>()));
 			}
-		});
+		}, questTimeout);
 		if (!status)
 			allCB->addFailedCase(endpoint, 0);
 	}
 
-	return nullptr;
+	return nullptr;
+}
+
+void ControlCenterQuestProcessor::finishCmdOutput(int taskId)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	_cmdOutputMap.erase(taskId);
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::systemCmdOutput(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	int taskId = args->wantInt("taskId");
+
+	QuestSenderPtr sender;
+	bool dispatched = true;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		auto iter = _cmdOutputMap.find(taskId);
+		if (iter != _cmdOutputMap.end())
+		{
+			struct ConnectionRecord& record = _connData[ci.socket];
+			dispatched = (record.role == ClientRole::Deployer
+				&& iter->second.endpoints.find(_connData.endpoint(record)) != iter->second.endpoints.end());
+
+			if (dispatched)
+				sender = iter->second.requester;
+		}
+	}
+
+	if (!dispatched)
+	{
+		LOG_WARN("Reject systemCmdOutput of task %d from %s, which is not a deployer the command was dispatched to.", taskId, ci.endpoint().c_str());
+		if (quest->isOneWay())
+			return nullptr;
+
+		return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidClientRoleCode, "Command was not dispatched to this connection.", "DATControlCenter");
+	}
+
+	if (sender)
+	{
+		FPQWriter qw(5, "systemCmdOutput", true);
+		qw.param("taskId", taskId);
+		qw.param("endpoint", ci.endpoint());
+		qw.param("idx", args->wantInt("idx"));
+		qw.param("stream", args->wantString("stream"));
+		qw.param("data", args->wantString("data"));
+
+		sender->sendQuest(qw.take(), [](FPAnswerPtr, int){});
+	}
+
+	if (quest->isOneWay())
+		return nullptr;
+
+	return FPAWriter::emptyAnswer(quest);
 }
 
+const int gc_maxLaunchVerifySec = 60;
+
 class LaunchActorCallback
 {
 	std::mutex _mutex;
 	IAsyncAnswerPtr _async;
 	std::set<std::string> _failedEndpoints;
+	std::map<struct DeployHost, std::vector<int>> _pids;
+	int _verifyTimeout;
+	ControlCenterQuestProcessorPtr _CCQP;
+
 public:
-	LaunchActorCallback(std::set<std::string> invalidEndpoints, IAsyncAnswerPtr async): _async(async)
+	LaunchActorCallback(std::set<std::string> invalidEndpoints, IAsyncAnswerPtr async, int verifyTimeout, ControlCenterQuestProcessorPtr ccqp):
+		_async(async), _verifyTimeout(verifyTimeout), _CCQP(ccqp)
 	{
 		_failedEndpoints = invalidEndpoints;
 	}
 	~LaunchActorCallback()
 	{
+		if (_verifyTimeout > 0 && _pids.size())
+		{
+			_CCQP->verifyLaunchedActors(_async, _failedEndpoints, _pids, _verifyTimeout);
+			return;
+		}
+
+		std::map<std::string, std::vector<int>> pids;
+		for (auto& pp: _pids)
+			pids[pp.first.endpoint] = pp.second;
+
 		if (_failedEndpoints.empty())
 		{
-			FPAWriter aw(1, _async->getQuest());
+			FPAWriter aw(2, _async->getQuest());
 			aw.param("ok", true);
+			aw.param("pids", pids);
 			_async->sendAnswer(aw.take());
 		}
 		else
 		{
-			FPAWriter aw(2, _async->getQuest());
+			FPAWriter aw(3, _async->getQuest());
 			aw.param("ok", false);
 			aw.param("failedEndpoints", _failedEndpoints);
+			aw.param("pids", pids);
 			_async->sendAnswer(aw.take());
 		}
 	}
@@ -1151,6 +2148,15 @@ public:
 		std::unique_lock<std::mutex> lck(_mutex);
 		_failedEndpoints.insert(endpoint);
 	}
+
+	void addPids(const struct DeployHost& host, const std::vector<int>& pids)
+	{
+		if (pids.empty())
+			return;
+
+		std::unique_lock<std::mutex> lck(_mutex);
+		_pids[host] = pids;
+	}
 };
 
 FPAnswerPtr ControlCenterQuestProcessor::launchActor(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
@@ -1161,19 +2167,40 @@ FPAnswerPtr ControlCenterQuestProcessor::launchActor(const FPReaderPtr args, con
 	std::string actor = args->wantString("actor");
 	std::set<std::string> endpoints = args->get("endpoints", std::set<std::string>());
 	std::string cmdLine = args->getString("cmdLine");
+	int instances = (int)args->getInt("instances", 1);
+	std::vector<int> cpuSet = args->get("cpuSet", std::vector<int>());
+	bool numaLocal = args->getBool("numaLocal", false);
+	std::vector<std::string> perInstanceArgs = args->get("perInstanceArgs", std::vector<std::string>());
+	bool restart = args->getBool("restart", false);
+	int maxRestarts = (int)args->getInt("maxRestarts", 5);
+	int verifyTimeout = (int)args->getInt("verifyTimeout", 10);
+	if (verifyTimeout > gc_maxLaunchVerifySec)
+		verifyTimeout = gc_maxLaunchVerifySec;
 
 	std::map<struct DeployHost, QuestSenderPtr> ipmap = fetchDeployerSenders(region, endpoints);
-	std::shared_ptr<LaunchActorCallback> allCB(new LaunchActorCallback(endpoints, genAsyncAnswer(quest)));
+	std::shared_ptr<LaunchActorCallback> allCB(new LaunchActorCallback(endpoints, genAsyncAnswer(quest), verifyTimeout, shared_from_this()));
 
-	FPQWriter qw(2, "launchActor");
+	FPQWriter qw(13, "launchActor");
 	qw.param("actor", actor);
 	qw.param("cmdLine", cmdLine);
+	qw.param("instances", instances);
+	qw.param("cpuSet", cpuSet);
+	qw.param("numaLocal", numaLocal);
+	qw.param("perInstanceArgs", perInstanceArgs);
+	qw.param("restart", restart);
+	qw.param("maxRestarts", maxRestarts);
+	qw.param("isolate", args->getBool("isolate", false));
+	qw.param("cpuQuota", args->getInt("cpuQuota", 0));
+	qw.param("cpuWeight", args->getInt("cpuWeight", 0));
+	qw.param("memoryMax", args->getInt("memoryMax", 0));
+	qw.param("ioMax", args->get("ioMax", std::vector<std::string>()));
 	FPQuestPtr orgQuest = qw.take();
 
 	for (auto& pp: ipmap)
 	{
+		struct DeployHost host = pp.first;
 		std::string endpoint = pp.first.endpoint;
-		bool status = pp.second->sendQuest(orgQuest, [endpoint, allCB](FPAnswerPtr answer, int errorCode){
+		bool status = pp.second->sendQuest(orgQuest, [host, endpoint, allCB](FPAnswerPtr answer, int errorCode){
 			if (errorCode != FPNN_EC_OK)
 				allCB->addFailedEndpoint(endpoint);
 			else
@@ -1181,6 +2208,8 @@ FPAnswerPtr ControlCenterQuestProcessor::launchActor(const FPReaderPtr args, con
 				FPAReader ar(answer);
 				if (!ar.wantBool("ok"))
 					allCB->addFailedEndpoint(endpoint);
+
+				allCB->addPids(host, ar.get("pids", std::vector<int>()));
 			}
 		});
 		if (!status)
@@ -1190,14 +2219,266 @@ FPAnswerPtr ControlCenterQuestProcessor::launchActor(const FPReaderPtr args, con
 	return nullptr;
 }
 
+static uint64_t actorPidKey(uint32_t hostId, int pid)
+{
+	return ((uint64_t)hostId << 32) | (uint32_t)pid;
+}
+
+//-- Under _mutex. After the endpoint is added into _runningActorInfos. Each index entry holds a reference of its host id.
+void ControlCenterQuestProcessor::indexActorPid(const std::string& endpoint, int pid)
+{
+	uint32_t hostId = _hostNames.hosts.intern(endpointHost(endpoint));
+	auto result = _actorPidIndex.insert(std::make_pair(actorPidKey(hostId, pid), (uint32_t)0));
+	if (!result.second)
+		_hostNames.hosts.release(hostId);
+
+	result.first->second = _hostNames.endpoints.find(endpoint);
+}
+
+//-- Under _mutex. Before the endpoint is released. Kept if the pid has been re-registered by another connection.
+void ControlCenterQuestProcessor::unindexActorPid(uint32_t endpointId, int pid)
+{
+	uint32_t hostId = _hostNames.hosts.find(endpointHost(_hostNames.endpoints.str(endpointId)));
+	if (hostId == 0)
+		return;
+
+	auto iter = _actorPidIndex.find(actorPidKey(hostId, pid));
+	if (iter == _actorPidIndex.end() || iter->second != endpointId)
+		return;
+
+	_actorPidIndex.erase(iter);
+	_hostNames.hosts.release(hostId);
+}
+
+//-- Under _mutex. Actor launched by the deployer: connects from the same host, but with different port.
+std::unordered_map<uint64_t, uint32_t>::iterator ControlCenterQuestProcessor::findActorPid(const std::string& deployerEndpoint, int pid)
+{
+	uint32_t hostId = _hostNames.hosts.find(endpointHost(deployerEndpoint));
+	if (hostId == 0)
+		return _actorPidIndex.end();
+
+	return _actorPidIndex.find(actorPidKey(hostId, pid));
+}
+
+//-- Under _mutex.
+std::map<struct DeployHost, std::vector<int>> ControlCenterQuestProcessor::unregisteredActors(const std::map<struct DeployHost, std::vector<int>>& launched)
+{
+	std::map<struct DeployHost, std::vector<int>> unregistered;
+
+	for (auto& pp: launched)
+		for (int pid: pp.second)
+		{
+			bool registered = false;
+			auto iter = findActorPid(pp.first.endpoint, pid);
+			if (iter != _actorPidIndex.end())
+			{
+				auto hostIter = _runningActorInfos.findEndpoint(iter->second);
+				registered = (hostIter != _runningActorInfos.end() && hostIter->first.region == pp.first.region);
+			}
+
+			if (!registered)
+				unregistered[pp.first].push_back(pid);
+		}
+
+	return unregistered;
+}
+
+static void answerLaunchVerification(const struct LaunchVerification& verification)
+{
+	std::map<std::string, std::vector<int>> pids;
+	for (auto& pp: verification.launched)
+		pids[pp.first.endpoint] = pp.second;
+
+	std::map<std::string, std::vector<int>> unregisteredPids;
+	for (auto& pp: verification.unregistered)
+		unregisteredPids[pp.first.endpoint] = pp.second;
+
+	const std::set<std::string>& failedEndpoints = verification.failedEndpoints;
+	bool ok = failedEndpoints.empty() && unregisteredPids.empty();
+	FPAWriter aw(2 + (failedEndpoints.empty() ? 0 : 1) + (unregisteredPids.empty() ? 0 : 1), verification.async->getQuest());
+	aw.param("ok", ok);
+	if (failedEndpoints.size())
+		aw.param("failedEndpoints", failedEndpoints);
+	aw.param("pids", pids);
+	if (unregisteredPids.size())
+		aw.param("unregistered", unregisteredPids);
+	verification.async->sendAnswer(aw.take());
+}
+
+//-- Launched actors are checked off by registerActor, the remained are answered as unregistered by the monitor cycle when expired.
+void ControlCenterQuestProcessor::verifyLaunchedActors(IAsyncAnswerPtr async, const std::set<std::string>& failedEndpoints,
+	const std::map<struct DeployHost, std::vector<int>>& launched, int timeoutSec)
+{
+	struct LaunchVerification verification;
+	verification.async = async;
+	verification.failedEndpoints = failedEndpoints;
+	verification.launched = launched;
+	verification.expireMsec = slack_mono_msec() + timeoutSec * 1000;
+
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		verification.unregistered = unregisteredActors(launched);
+		if (verification.unregistered.size())
+		{
+			_launchVerifications.push_back(verification);
+			return;
+		}
+	}
+
+	answerLaunchVerification(verification);
+}
+
+//-- Under _mutex.
+void ControlCenterQuestProcessor::verifyRegisteredActor(const std::string& region, const std::string& endpoint, int pid,
+	std::vector<struct LaunchVerification>& verified)
+{
+	std::string host = endpointHost(endpoint);
+	for (auto iter = _launchVerifications.begin(); iter != _launchVerifications.end(); )
+	{
+		std::map<struct DeployHost, std::vector<int>>& unregistered = iter->unregistered;
+		for (auto uiter = unregistered.begin(); uiter != unregistered.end(); )
+		{
+			std::vector<int>& pids = uiter->second;
+			if (uiter->first.region == region && endpointHost(uiter->first.endpoint) == host)
+				pids.erase(std::remove(pids.begin(), pids.end(), pid), pids.end());
+
+			if (pids.empty())
+				uiter = unregistered.erase(uiter);
+			else
+				uiter++;
+		}
+
+		if (unregistered.empty())
+		{
+			verified.push_back(*iter);
+			iter = _launchVerifications.erase(iter);
+		}
+		else
+			iter++;
+	}
+}
+
+void ControlCenterQuestProcessor::expireLaunchVerifications()
+{
+	std::vector<struct LaunchVerification> expired;
+	{
+		int64_t now = slack_mono_msec();
+
+		std::unique_lock<std::mutex> lck(_mutex);
+		for (auto iter = _launchVerifications.begin(); iter != _launchVerifications.end(); )
+		{
+			if (iter->expireMsec <= now)
+			{
+				expired.push_back(*iter);
+				iter = _launchVerifications.erase(iter);
+			}
+			else
+				iter++;
+		}
+	}
+
+	for (auto& verification: expired)
+		answerLaunchVerification(verification);
+}
+
+//-- Under _mutex.
+TaskSubscriberPtr ControlCenterQuestProcessor::taskSubscriber(const ConnectionInfo& ci)
+{
+	TaskSubscriberPtr& subscriber = _taskSubscribers[ci.socket];
+	if (!subscriber)
+		subscriber = std::make_shared<TaskSubscriber>(ci, genQuestSender(ci), _subscriberPolicy, _subscriberQueueSize, _subscriberWindow,
+			_subscriberMaxRate);
+
+	return subscriber;
+}
+
+//-- Under _mutex.
+void ControlCenterQuestProcessor::cancelSubscriber(int socket)
+{
+	auto iter = _taskSubscribers.find(socket);
+	if (iter == _taskSubscribers.end())
+		return;
+
+	LOG_WARN("Subscriber %s is too slow, its task subscriptions are cancelled.", iter->second->endpoint.c_str());
+
+	iter->second->close();
+	_taskSubscribers.erase(iter);
+
+	for (auto& pp: _monitorMap)
+		pp.second.erase(socket);
+}
+
 FPAnswerPtr ControlCenterQuestProcessor::monitorTasks(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
 	std::set<int> taskIds = args->want("taskIds", std::set<int>());
+
+	//-- Omitted options keep the values of the connection's current subscriber.
+	const intmax_t omitted = std::numeric_limits<intmax_t>::min();
+
+	OverflowPolicy overflowPolicy = _subscriberPolicy;
+	std::string overflow = args->getString("overflow");
+	if (overflow.size() && !TaskSubscriber::parsePolicy(overflow, overflowPolicy))
+		return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidSubscriptionCode, "Unknown overflow policy.", "DATControlCenter");
+
+	intmax_t queueSizeArg = args->getInt("queueSize", omitted);
+	if (queueSizeArg != omitted && (queueSizeArg <= 0 || queueSizeArg > (intmax_t)_subscriberMaxQueueSize))
+		return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidSubscriptionCode, "queueSize must be positive and not more than "
+			+ std::to_string(_subscriberMaxQueueSize) + ".", "DATControlCenter");
+
+	intmax_t maxRateArg = args->getInt("maxRate", omitted);
+	if (maxRateArg != omitted && (maxRateArg < 0 || maxRateArg > std::numeric_limits<int>::max()))
+		return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidSubscriptionCode, "maxRate must not be negative.", "DATControlCenter");
+
+	SubscriptionFilterPtr filter;
+	{
+		std::shared_ptr<struct SubscriptionFilter> options = std::make_shared<struct SubscriptionFilter>();
+		options->regions = args->get("regions", std::set<std::string>());
+		options->endpoints = args->get("endpoints", std::set<std::string>());
+		options->sampleEvery = (int)args->getInt("sampleEvery", 1);
+		options->resultsOnly = args->getBool("resultsOnly", false);
+
+		if (options->sampleEvery < 1)
+			return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidSubscriptionCode, "sampleEvery must be positive.", "DATControlCenter");
+
+		if (options->regions.size() || options->endpoints.size() || options->sampleEvery > 1 || options->resultsOnly)
+			filter = options;
+	}
+
 	QuestSenderPtr sender = genQuestSender(ci);
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
+		TaskSubscriberPtr& subscriber = _taskSubscribers[ci.socket];
+
+		OverflowPolicy policy = subscriber ? subscriber->policy : _subscriberPolicy;
+		size_t queueSize = subscriber ? subscriber->capacity : _subscriberQueueSize;
+		int maxRate = subscriber ? subscriber->maxRate : _subscriberMaxRate;
+
+		if (overflow.size())
+			policy = overflowPolicy;
+		if (queueSizeArg != omitted)
+			queueSize = (size_t)queueSizeArg;
+		if (maxRateArg != omitted)
+			maxRate = (int)maxRateArg;
+
+		if (!subscriber || subscriber->policy != policy || subscriber->capacity != queueSize || subscriber->maxRate != maxRate)
+		{
+			//-- Options changed: all tasks of the connection move to the new queue.
+			TaskSubscriberPtr old = subscriber;
+			subscriber = std::make_shared<TaskSubscriber>(ci, sender, policy, queueSize, _subscriberWindow, maxRate);
+			if (old)
+			{
+				old->close();
+				for (auto& pp: _monitorMap)
+				{
+					auto iter = pp.second.find(ci.socket);
+					if (iter != pp.second.end())
+						iter->second.subscriber = subscriber;
+				}
+			}
+		}
+
 		for (int taskId: taskIds)
-			_monitorMap[taskId][ci.socket] = sender;
+			_monitorMap[taskId][ci.socket] = TaskSubscription(subscriber, filter);
 	}
 
 	return FPAWriter::emptyAnswer(quest);
@@ -1212,40 +2493,30 @@ FPAnswerPtr ControlCenterQuestProcessor::registerDeployer(const FPReaderPtr args
 	int cpus = args->wantInt("cpus");
 	int64_t memories = args->wantInt("totalMemories");
 
-	std::map<std::string, int> idxmap = buildIdxMap(std::set<std::string>{"actor", "size", "md5", "mtime"}, fields);
+	struct DeployHost host;
+	host.region = region;
+	host.endpoint = endpoint;
+
+	std::map<std::string, struct ActorInfo> actorInfos;
+	parseDeployedActors(fields, rows, actorInfos);
+	std::vector<std::vector<std::string>> deployedActorRows;
+	appendDeployedActorRows(deployedActorRows, host, actorInfos);
 	QuestSenderPtr sender = genQuestSender(ci);
 
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
-		_connData[ci.socket]->registerRole(ClientRole::Deployer, region, endpoint);
-
-		const struct DeployHost& host = _connData[ci.socket]->_deployHost;
-		_deployerInfos[host].sender = sender;
-		_deployerInfos[host].cpuCount = cpus;
-		_deployerInfos[host].memoryCount = memories;
-
-		std::map<std::string, struct ActorInfo>& deployStatus = _deployerInfos[host].actorInfos;
-		deployStatus.clear();
-		for (auto& row: rows)
-		{
-			int idx = idxmap["actor"];
-			if (idx < 0)
-				continue;
-
-			struct ActorInfo& ai = deployStatus[row[idx]];
-
-			idx = idxmap["mtime"];
-			if (idx > -1)
-				ai.mtime = atoll(row[idx].c_str());
-
-			idx = idxmap["size"];
-			if (idx > -1)
-				ai.fileSize = atoll(row[idx].c_str());
-
-			idx = idxmap["md5"];
-			if (idx > -1)
-				ai.fileMd5 = row[idx];
-		}
+		_connData.registerRole(ci.socket, ClientRole::Deployer, region, endpoint);
+
+		struct DeoplyerInfo& info = _deployerInfos[host];
+		info.sender = sender;
+		info.cpuCount = cpus;
+		info.memoryCount = memories;
+		attachHistory(_detachedDeployerHistories, host, info.history);
+
+		info.actorInfos.swap(actorInfos);
+		info.deployedActorRows = shareRows(deployedActorRows);
+		_actorInfosSnapshot.touch();
+		publishMachineStatus("Deployer", host, info);
 	}
 	
 	return FPAWriter::emptyAnswer(quest);
@@ -1263,17 +2534,105 @@ FPAnswerPtr ControlCenterQuestProcessor::registerMonitor(const FPReaderPtr args,
 
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
-		_connData[ci.socket]->registerRole(ClientRole::Monitor, region, endpoint);
-
-		const struct DeployHost& host = _connData[ci.socket]->_deployHost;
-		_monitorInfos[host].sender = sender;
-		_monitorInfos[host].cpuCount = cpus;
-		_monitorInfos[host].memoryCount = memories;
+		_connData.registerRole(ci.socket, ClientRole::Monitor, region, endpoint);
+
+		struct DeployHost host;
+		host.region = region;
+		host.endpoint = endpoint;
+		struct MonitorInfo& info = _monitorInfos[host];
+		info.sender = sender;
+		info.cpuCount = cpus;
+		info.memoryCount = memories;
+		attachHistory(_detachedMonitorHistories, host, info.history);
+		publishMachineStatus("Monitor", host, info);
 	}
 	
 	return FPAWriter::emptyAnswer(quest);
 }
 
+FPAnswerPtr ControlCenterQuestProcessor::actorLifecycle(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string region = args->wantString("region");
+	std::string event = args->wantString("event");
+	std::string actor = args->wantString("actor");
+	int pid = args->wantInt("pid");
+
+	bool deployer;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		struct ConnectionRecord& record = _connData[ci.socket];
+		deployer = (record.role == ClientRole::Deployer && _connData.region(record) == region);
+	}
+
+	if (!deployer)
+	{
+		LOG_WARN("Reject actorLifecycle from %s, which is not a deployer registered in region %s.", ci.endpoint().c_str(), region.c_str());
+		if (quest->isOneWay())
+			return nullptr;
+
+		return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidClientRoleCode, "Only deployers can report actor lifecycle.", "DATControlCenter");
+	}
+
+	LOG_INFO("Actor %s on %s pid %d %s. exit code: %d, signal: %d, restart delay: %d ms.", actor.c_str(), ci.endpoint().c_str(),
+		(event == "exited") ? pid : (int)args->getInt("prevPid"), event.c_str(), (int)args->getInt("exitCode"),
+		(int)args->getInt("signal"), (int)args->getInt("restartDelay"));
+
+	if (event == "exited")
+	{
+		//-- Drop the dead actor at once, don't wait its connection timeout. Tasks on it are finished with this event.
+		std::string actorEndpoint;
+		std::set<int> taskIds;
+		{
+			std::unique_lock<std::mutex> lck(_mutex);
+			auto indexIter = findActorPid(ci.endpoint(), pid);
+			auto hostIter = (indexIter != _actorPidIndex.end()) ? _runningActorInfos.findEndpoint(indexIter->second) : _runningActorInfos.end();
+			if (hostIter != _runningActorInfos.end() && hostIter->first.region == region)
+			{
+				actorEndpoint = hostIter->first.endpoint;
+				for (auto actorIter = hostIter->second.begin(); actorIter != hostIter->second.end(); )
+				{
+					auto pidIter = actorIter->second.find(pid);
+					if (pidIter != actorIter->second.end())
+					{
+						for (auto& pp: pidIter->second.taskMap)
+							taskIds.insert(pp.first);
+
+						actorIter->second.erase(pidIter);
+						_actorTaskStatusSnapshot.touch();
+					}
+
+					if (actorIter->second.empty())
+						actorIter = hostIter->second.erase(actorIter);
+					else
+						++actorIter;
+				}
+
+				unindexActorPid(indexIter->second, pid);
+				if (hostIter->second.empty())
+					_runningActorInfos.erase(hostIter);
+			}
+		}
+
+		//-- Queued behind the task's status & results, which are in the same shard.
+		std::string payload = quest->json();
+		for (int taskId: taskIds)
+		{
+			struct StatusMessage message;
+			message.taskId = taskId;
+			message.kind = StatusKind::Lifecycle;
+			message.region = region;
+			message.endpoint = actorEndpoint;
+			message.payload = payload;
+			_statusIngest.push(message);
+		}
+	}
+
+	if (quest->isOneWay())
+		return nullptr;
+
+	return FPAWriter::emptyAnswer(quest);
+}
+
 FPAnswerPtr ControlCenterQuestProcessor::registerActor(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
 	std::string region = args->wantString("region");
@@ -1282,59 +2641,186 @@ FPAnswerPtr ControlCenterQuestProcessor::registerActor(const FPReaderPtr args, c
 	int pid = args->wantInt("pid");
 	std::map<int, std::vector<std::string>> executingTasks = args->get("executingTasks", std::map<int, std::vector<std::string>>());
 	QuestSenderPtr sender = genQuestSender(ci);
+	std::vector<struct LaunchVerification> verified;
 
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
-		_connData[ci.socket]->registerRole(ClientRole::Actor, region, endpoint);
-		_connData[ci.socket]->_actorName = name;
-		_connData[ci.socket]->_actorPid = pid;
+		_connData.registerRole(ci.socket, ClientRole::Actor, region, endpoint);
+		_connData.registerActor(ci.socket, name, pid);
 
-		const struct DeployHost& host = _connData[ci.socket]->_deployHost;
-		_runningActorInfos[host][name][pid].sender = sender;
+		struct DeployHost host;
+		host.region = region;
+		host.endpoint = endpoint;
+		struct ActorProcessInfo& info = _runningActorInfos[host][name][pid];
+		info.sender = sender;
 
-		_runningActorInfos[host][name][pid].taskMap.clear();
+		info.taskMap.clear();
 		
 		for (auto& pp: executingTasks)
-			_runningActorInfos[host][name][pid].taskMap[pp.first] = pp.second;
+			info.taskMap[pp.first] = pp.second;
+
+		publishActorTasks(host, name, pid, info);
+		indexActorPid(endpoint, pid);
+		verifyRegisteredActor(region, endpoint, pid, verified);
 	}
+
+	for (auto& verification: verified)
+		answerLaunchVerification(verification);
+
 	return FPAWriter::emptyAnswer(quest);
 }
 
-FPAnswerPtr ControlCenterQuestProcessor::forwardActorStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+void ControlCenterQuestProcessor::forwardActorStatus(const struct StatusMessage& message)
 {
-	int taskId = args->wantInt("taskId");
-	std::string region = args->wantString("region");
-	std::string payload = args->wantString("payload");
-
-	FPQWriter qw(4, quest->method());
-	qw.param("taskId", taskId);
-	qw.param("region", region);
-	qw.param("endpoint", ci.endpoint());
-	qw.param("payload", payload);
+	bool status = (message.kind == StatusKind::Status);
+	std::string host = endpointHost(message.endpoint);
 
+	std::vector<TaskSubscriberPtr> subscribers;
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
-		auto iter = _monitorMap.find(taskId);
-		if (iter != _monitorMap.end())
+		auto iter = _monitorMap.find(message.taskId);
+		if (iter == _monitorMap.end())
+			return;
+
+		subscribers.reserve(iter->second.size());
+		for (auto& pp: iter->second)
 		{
-			for (auto& pp: iter->second)
-				pp.second->sendQuest(qw.take(), [](FPAnswerPtr answer, int errorCode){
-					if (errorCode != FPNN_EC_OK)
-						LOG_ERROR("Forward 'actorStatus' or 'actorResult' error. Code: %d", errorCode);
-				}, 0);
+			struct TaskSubscription& subscription = pp.second;
+			const struct SubscriptionFilter* filter = subscription.filter.get();
+			if (filter)
+			{
+				bool accepted = filter->match(message.region, message.endpoint, host);
+				if (accepted && status)
+					accepted = !filter->resultsOnly && (subscription.statusCount++ % filter->sampleEvery) == 0;
+
+				if (!accepted)
+				{
+					subscription.subscriber->filtered();
+					continue;
+				}
+			}
+
+			subscribers.push_back(subscription.subscriber);
 		}
 	}
 
-	return FPAWriter::emptyAnswer(quest);
+	if (subscribers.empty())
+		return;
+
+	FPQWriter qw(4, message.method());
+	qw.param("taskId", message.taskId);
+	qw.param("region", message.region);
+	qw.param("endpoint", message.endpoint);
+	qw.param("payload", message.payload);
+	FPQuestPtr forwardQuest = qw.take();
+
+	for (auto& subscriber: subscribers)
+	{
+		if (subscriber->post(message.taskId, status, message.endpoint, forwardQuest))
+			continue;
+
+		std::unique_lock<std::mutex> lck(_mutex);
+		auto iter = _taskSubscribers.find(subscriber->socket);
+		if (iter != _taskSubscribers.end() && iter->second == subscriber)
+			cancelSubscriber(subscriber->socket);
+	}
+}
+
+//-- In the shard thread of the task.
+void ControlCenterQuestProcessor::dispatchActorStatus(struct StatusMessage& message)
+{
+	if (message.kind != StatusKind::Finished)
+		forwardActorStatus(message);
+
+	if (message.kind == StatusKind::Lifecycle || message.kind == StatusKind::Finished)
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		_monitorMap.erase(message.taskId);
+	}
 }
+
 FPAnswerPtr ControlCenterQuestProcessor::actorStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	return forwardActorStatus(args, quest, ci);
+	struct StatusMessage message;
+	message.taskId = args->wantInt("taskId");
+	message.kind = StatusKind::Status;
+	message.region = args->wantString("region");
+	message.endpoint = ci.endpoint();
+	message.payload = args->wantString("payload");
+
+	_statusIngest.push(message);
+	return FPAWriter::emptyAnswer(quest);
 }
 
 FPAnswerPtr ControlCenterQuestProcessor::actorResult(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	return forwardActorStatus(args, quest, ci);
+	struct StatusMessage message;
+	message.taskId = args->wantInt("taskId");
+	message.kind = StatusKind::Result;
+	message.region = args->wantString("region");
+	message.endpoint = ci.endpoint();
+	message.payload = args->wantString("payload");
+
+	if (!_statusIngest.push(message))
+		return FPAWriter::errorAnswer(quest, ErrorInfo::StatusIngestFullCode, "Status ingest is full, retry later.", "DATControlCenter");
+
+	return FPAWriter::emptyAnswer(quest);
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::actorStatusBatch(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string region = args->wantString("region");
+	std::string records = args->wantString("records");
+
+	if (args->getBool("zip", false))
+	{
+		if (!decompressRecords(records, args->wantInt("rawSize"), gc_maxRecordsRawLength))
+		{
+			LOG_ERROR("Decompress actor status batch from %s failed.", ci.endpoint().c_str());
+			if (quest->isOneWay())
+				return nullptr;
+
+			return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidTelemetryBatchCode, "Decompress telemetry batch failed.", "DATControlCenter");
+		}
+	}
+
+	FPReader reader(records);
+	std::vector<int> taskIds = reader.want("taskIds", std::vector<int>());
+	std::vector<int> kinds = reader.want("kinds", std::vector<int>());
+	std::vector<std::string> payloads = reader.want("payloads", std::vector<std::string>());
+
+	if (taskIds.size() != kinds.size() || taskIds.size() != payloads.size())
+	{
+		LOG_ERROR("Invalid actor status batch from %s.", ci.endpoint().c_str());
+		if (quest->isOneWay())
+			return nullptr;
+
+		return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidTelemetryBatchCode, "Telemetry batch is broken.", "DATControlCenter");
+	}
+
+	std::string endpoint = ci.endpoint();
+	std::vector<int> rejected;
+
+	for (size_t i = 0; i < taskIds.size(); i++)
+	{
+		struct StatusMessage message;
+		message.taskId = taskIds[i];
+		message.kind = kinds[i] ? StatusKind::Result : StatusKind::Status;
+		message.region = region;
+		message.endpoint = endpoint;
+		message.payload.swap(payloads[i]);
+		if (!_statusIngest.push(message))
+			rejected.push_back((int)i);
+	}
+
+	if (quest->isOneWay())
+		return nullptr;
+
+	if (rejected.empty())
+		return FPAWriter::emptyAnswer(quest);
+
+	LOG_WARN("Status ingest is full, %d result(s) from %s are rejected.", (int)rejected.size(), endpoint.c_str());
+	return FPAWriter(1, quest)("rejected", rejected);
 }
 
 FPAnswerPtr ControlCenterQuestProcessor::ping(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
@@ -1342,17 +2828,54 @@ FPAnswerPtr ControlCenterQuestProcessor::ping(const FPReaderPtr args, const FPQu
 	return FPAWriter::emptyAnswer(quest);
 }
 
+FPAnswerPtr ControlCenterQuestProcessor::statusIngestInfo(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::vector<std::vector<std::string>> rows;
+	_statusIngest.appendRows(rows);
+
+	FPAWriter aw(2, quest);
+	aw.param("fields", StatusIngest::fields());
+	aw.param("rows", rows);
+
+	return aw.take();
+}
+
+FPAnswerPtr ControlCenterQuestProcessor::taskSubscriberInfo(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::vector<std::pair<TaskSubscriberPtr, size_t>> subscribers;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		std::map<int, size_t> taskCounts;
+		for (auto& pp: _monitorMap)
+			for (auto& pp2: pp.second)
+				taskCounts[pp2.first]++;
+
+		for (auto& pp: _taskSubscribers)
+			subscribers.push_back(std::make_pair(pp.second, taskCounts[pp.first]));
+	}
+
+	std::vector<std::vector<std::string>> rows;
+	for (auto& pp: subscribers)
+		pp.first->appendRow(rows, pp.second);
+
+	FPAWriter aw(2, quest);
+	aw.param("fields", TaskSubscriber::fields());
+	aw.param("rows", rows);
+
+	return aw.take();
+}
+
 FPAnswerPtr ControlCenterQuestProcessor::monitorMachineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
 	bool monitor = args->wantBool("monitor");
 
 	{
 		std::unique_lock<std::mutex> lck(_mutex);
-		ConnectionPrivateDataPtr cpd = _connData[ci.socket];
+		struct ConnectionRecord& record = _connData[ci.socket];
 
-		if (monitor != cpd->_monitoringMachineStatus)
+		if (monitor != record.monitoringMachineStatus)
 		{
-			cpd->_monitoringMachineStatus = monitor;
+			record.monitoringMachineStatus = monitor;
 			if (monitor)
 				_monitorMachineStatus++;
 			else
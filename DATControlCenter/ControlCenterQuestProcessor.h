@@ -1,8 +1,16 @@
 #ifndef DAT_Control_Center_Quest_Processor_h
 #define DAT_Control_Center_Quest_Processor_h
 
+#include <list>
+#include <deque>
+#include <unordered_map>
 #include "TaskThreadPool.h"
 #include "IQuestProcessor.h"
+#include "ConnectionTable.h"
+#include "HostRegistry.h"
+#include "StatusSnapshot.h"
+#include "StatusIngest.h"
+#include "TaskSubscriber.h"
 
 using namespace fpnn;
 
@@ -14,37 +22,6 @@ struct ActorInfo
 	std::string desc;
 };
 
-struct DeployHost
-{
-	std::string region;
-	std::string endpoint;
-
-	bool operator< (const struct DeployHost& r) const
-	{
-		if (region < r.region)
-			return true;
-		else if (region == r.region)
-		{
-			if (endpoint < r.endpoint)
-				return true;
-		}
-		return false;
-	}
-
-	bool operator== (const struct DeployHost& r) const
-	{
-		return (region == r.region && endpoint == r.endpoint);
-	}
-};
-
-enum class ClientRole
-{
-	Controller,
-	Deployer,
-	Monitor,
-	Actor,
-};
-
 class ControlCenterQuestProcessor;
 typedef std::shared_ptr<ControlCenterQuestProcessor> ControlCenterQuestProcessorPtr;
 
@@ -68,30 +45,60 @@ struct UploadInfo
 };
 typedef std::shared_ptr<struct UploadInfo> UploadInfoPtr;
 
-struct ConnectionPrivateData
+//-- Allocated at the first uploadActor of a connection.
+struct ConnectionUpload
 {
 	std::mutex _mutex;
 	UploadInfoPtr _upload;
 
-	ClientRole _role;
-	struct DeployHost _deployHost;
-	std::string _actorName;
-	int _actorPid;
-	bool _monitoringMachineStatus;
-
-	ConnectionPrivateData(): _role(ClientRole::Controller), _actorPid(0), _monitoringMachineStatus(false) {}
-
-	void registerRole(ClientRole role, const std::string& region, const std::string& endpoint);
 	void wroteUploadSections();
 	bool fillUploadSection(const std::string& name, const std::string& desc, int sectionCount, int sectionNo,
 		std::string& content, QuestSenderPtr sender, ControlCenterQuestProcessorPtr ccqp);
 };
-typedef std::shared_ptr<struct ConnectionPrivateData> ConnectionPrivateDataPtr;
 
 struct ActorProcessInfo
 {
 	QuestSenderPtr sender;
 	std::map<int, std::vector<std::string>>	taskMap;	//-- map<task id, [method, desc]>
+	SharedRows taskRows;		//-- actorTaskStatus rows of taskMap.
+};
+
+struct MachineCpuStatus
+{
+	float util;
+	float user;
+	float system;
+	float iowait;
+	float irq;
+	float softirq;
+	float steal;
+	float maxCoreUtil;
+	int maxCore;
+	std::vector<std::vector<float>> cores;		//-- [[user, system, iowait, irq, softirq, steal, util]]
+
+	MachineCpuStatus(): util(0), user(0), system(0), iowait(0), irq(0), softirq(0), steal(0), maxCoreUtil(0), maxCore(-1) {}
+};
+
+struct MachineIoStatus
+{
+	std::map<std::string, float> pressure;				//-- PSI avg10: cpuSome, cpuFull, memorySome, memoryFull, ioSome, ioFull
+	std::map<std::string, std::vector<float>> disks;	//-- device: [readIops, writeIops, readBytes/s, writeBytes/s, awaitMsec, util]
+	std::map<std::string, int64_t> vmstat;				//-- majorFaults, swapIn, swapOut in last interval
+};
+
+struct MachineStatusRecord
+{
+	int64_t time;
+	float systemLoad;
+	int tcpCount;
+	int udpCount;
+	int64_t freeMemories;
+	uint64_t recvBytesDiff;
+	uint64_t sendBytesDiff;
+	struct MachineCpuStatus cpu;
+	std::map<std::string, int64_t> netStack;
+	struct MachineIoStatus io;
+	std::vector<std::vector<std::string>> processes;
 };
 
 struct MonitorInfo
@@ -107,15 +114,75 @@ struct MonitorInfo
 	uint64_t sendBytes;
 	uint64_t recvBytesDiff;
 	uint64_t sendBytesDiff;
+	struct MachineCpuStatus cpu;
+	std::map<std::string, int64_t> netStack;		//-- TCP/UDP stack counters delta in last interval, and timeWait.
+	struct MachineIoStatus io;
+	std::vector<std::vector<std::string>> processes;	//-- watched processes, rows as processStatus fields after host.
+	std::deque<struct MachineStatusRecord> history;
 	QuestSenderPtr sender;
+	SharedRows statusRows;		//-- machineStatus row.
 
 	MonitorInfo(): cpuCount(0), tcpCount(0), udpCount(0), systemLoad(0.0), delayInMsec(0), memoryCount(0), freeMemories(0),
 		recvBytes(0), sendBytes(0), recvBytesDiff(0), sendBytesDiff(0) {}
 };
 
+struct ActorCgroupInfo
+{
+	std::string actor;
+	std::string isolation;		//-- "cgroup" or "rlimit"
+	uint64_t usageUsec;
+	uint64_t nrPeriods;
+	uint64_t nrThrottled;
+	uint64_t throttledUsec;
+	double cpuUsage;			//-- cores
+	double throttledPercent;	//-- throttled periods / periods in last interval
+	uint64_t throttledUsecDiff;
+	uint64_t memoryCurrent;
+	uint64_t anonBytes;
+	uint64_t fileBytes;
+	uint64_t memoryHighEvents;
+	uint64_t memoryMaxEvents;
+	uint64_t oomKills;
+};
+
+struct BurstSampleResult
+{
+	std::string region;
+	int64_t startMsec;
+	std::vector<std::string> fields;
+	std::vector<std::vector<float>> columns;
+};
+
+struct BurstSampleTask
+{
+	int intervalMs;
+	int durationSec;
+	QuestSenderPtr requester;
+	std::set<std::string> pending;								//-- endpoints not uploaded.
+	std::map<std::string, struct BurstSampleResult> results;		//-- map<endpoint, result>
+};
+
+struct CmdOutputTask
+{
+	QuestSenderPtr requester;
+	std::set<std::string> endpoints;		//-- deployers the command was dispatched to.
+};
+
+//-- launchActor waiting for launched actors calling registerActor.
+struct LaunchVerification
+{
+	IAsyncAnswerPtr async;
+	std::set<std::string> failedEndpoints;
+	std::map<struct DeployHost, std::vector<int>> launched;
+	std::map<struct DeployHost, std::vector<int>> unregistered;
+	int64_t expireMsec;
+};
+
 struct DeoplyerInfo: public MonitorInfo
 {
 	std::map<std::string, struct ActorInfo> actorInfos;
+	std::map<int, struct ActorCgroupInfo> actorCgroups;		//-- map<pid, info>
+	SharedRows deployedActorRows;		//-- availableActors rows of actorInfos.
 };
 
 class ControlCenterQuestProcessor: public IQuestProcessor, public std::enable_shared_from_this<ControlCenterQuestProcessor>
@@ -130,25 +197,59 @@ class ControlCenterQuestProcessor: public IQuestProcessor, public std::enable_sh
 	std::string _tmpFileCachePath;
 	TaskThreadPool _taskPool;
 	std::map<std::string, struct ActorInfo> _actorInfos;
-	std::map<int, ConnectionPrivateDataPtr> _connData;
-
-	std::map<struct DeployHost, struct MonitorInfo> _monitorInfos;
-	std::map<struct DeployHost, struct DeoplyerInfo> _deployerInfos;
-	std::map<struct DeployHost, std::map<std::string, std::map<int, struct ActorProcessInfo>>> _runningActorInfos; //-- map<host, map<actor, map<pid, info>>>
-
-	std::map<int, std::map<int, QuestSenderPtr>> _monitorMap;	//-- map<taskId, map<socket, QuestSender>>
+	SharedRows _availableActorRows;
+	HostNames _hostNames;
+	ConnectionTable _connData;
+
+	HostRegistry<struct MonitorInfo> _monitorInfos;
+	HostRegistry<struct DeoplyerInfo> _deployerInfos;
+	std::map<struct DeployHost, std::deque<struct MachineStatusRecord>> _detachedDeployerHistories;	//-- key: region & host, for disconnected agents.
+	std::map<struct DeployHost, std::deque<struct MachineStatusRecord>> _detachedMonitorHistories;
+	HostRegistry<std::map<std::string, std::map<int, struct ActorProcessInfo>>> _runningActorInfos; //-- host -> map<actor, map<pid, info>>
+	std::unordered_map<uint64_t, uint32_t> _actorPidIndex;		//-- (host id, pid) -> endpoint id of _runningActorInfos, for deployers' events.
+
+	std::map<int, std::map<int, struct TaskSubscription>> _monitorMap;	//-- map<taskId, map<socket, subscription>>
+	std::map<int, TaskSubscriberPtr> _taskSubscribers;			//-- map<socket, subscriber>
+	OverflowPolicy _subscriberPolicy;
+	size_t _subscriberQueueSize;
+	size_t _subscriberMaxQueueSize;
+	int _subscriberWindow;
+	int _subscriberMaxRate;
+	std::map<int, struct CmdOutputTask> _cmdOutputMap;		//-- map<taskId, task>, for streamed systemCmd outputs.
+	std::map<int, struct BurstSampleTask> _burstSampleTasks;	//-- map<taskId, task>, latest tasks only.
+	std::list<struct LaunchVerification> _launchVerifications;
 	std::thread _deployerMonitorThread;
 	std::atomic<int> _monitorMachineStatus;
 
+	SnapshotPublisher _machineStatusSnapshot;
+	SnapshotPublisher _actorInfosSnapshot;
+	SnapshotPublisher _actorTaskStatusSnapshot;
+	StatusIngest _statusIngest;
+
 	void prepareActorCache();
 	void loadActorCache();
 	void persistentActorDesc();
 	void deployerMontiorCycle();
+	void expireLaunchVerifications();
 
 	FPAnswerPtr returnActorInfos(const FPQuestPtr quest);
-	void writeUploadActor(int socket, ConnectionPrivateData* idAddr);
+	//-- Under _mutex.
+	void publishAvailableActors();
+	void publishMachineStatus(const char* source, const struct DeployHost& host, struct MonitorInfo& info);
+	void publishActorTasks(const struct DeployHost& host, const std::string& actor, int pid, struct ActorProcessInfo& info);
+	void writeUploadActor(int socket, ConnectionUpload* idAddr);
 	std::map<struct DeployHost, QuestSenderPtr> fetchDeployerSenders(const std::string& region, std::set<std::string>& ips);
-	FPAnswerPtr forwardActorStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	std::map<struct DeployHost, QuestSenderPtr> fetchMonitorSenders(const std::string& region, std::set<std::string>& ips);
+	TaskSubscriberPtr taskSubscriber(const ConnectionInfo& ci);
+	void cancelSubscriber(int socket);
+	void forwardActorStatus(const struct StatusMessage& message);
+	void dispatchActorStatus(struct StatusMessage& message);
+	void indexActorPid(const std::string& endpoint, int pid);
+	void unindexActorPid(uint32_t endpointId, int pid);
+	std::unordered_map<uint64_t, uint32_t>::iterator findActorPid(const std::string& deployerEndpoint, int pid);
+	std::map<struct DeployHost, std::vector<int>> unregisteredActors(const std::map<struct DeployHost, std::vector<int>>& launched);
+	void verifyRegisteredActor(const std::string& region, const std::string& endpoint, int pid,
+		std::vector<struct LaunchVerification>& verified);
 
 public:
 	ControlCenterQuestProcessor();
@@ -167,15 +268,31 @@ public:
 	FPAnswerPtr launchActor(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr monitorTasks(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr monitorMachineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr statusIngestInfo(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr taskSubscriberInfo(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr actorCgroups(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr machineStatusHistory(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr machineCoreStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr netStackStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr diskStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr watchProcesses(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr processStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr burstSample(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr burstSampleResult(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 
 	//-- for deployer
 	FPAnswerPtr registerDeployer(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr registerMonitor(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr actorLifecycle(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr systemCmdOutput(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr burstSampleData(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr machineStatusBackfill(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 
 	//-- for actors
 	FPAnswerPtr registerActor(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr actorStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr actorResult(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr actorStatusBatch(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 
 	virtual void connected(const ConnectionInfo&);
 	virtual void connectionWillClose(const ConnectionInfo& connInfo, bool closeByError);
@@ -185,6 +302,13 @@ public:
 	void actorTaskFinish(const std::string& endpoint, const std::string& actor, int pid, int taskId);
 	void adjustMachineDelay(bool deployerRole, struct DeployHost host, int64_t cost);
 	void adjustMachineStatus(bool deployerRole, struct DeployHost host, int intervalSec, FPAReader& ar);
+	void updateMachineInfo(struct MonitorInfo& info, int intervalSec, FPAReader& ar);
+	void backfillMachineInfo(struct MonitorInfo& info, const std::vector<std::string>& records);
+	void finishCmdOutput(int taskId);
+	void cancelBurstSample(int taskId, const std::string& endpoint);
+	void adjustActorCgroups(struct DeoplyerInfo& info, int intervalSec, const std::vector<std::vector<std::string>>& rows);
+	void verifyLaunchedActors(IAsyncAnswerPtr async, const std::set<std::string>& failedEndpoints,
+		const std::map<struct DeployHost, std::vector<int>>& launched, int timeoutSec);
 	
 	QuestProcessorClassBasicPublicFuncs
 };
@@ -0,0 +1,191 @@
+#include "NetworkUtility.h"
+#include "ControlCenterTables.h"
+
+std::map<std::string, int> buildIdxMap(const std::set<std::string>& hopeFields, const std::vector<std::string>& fileds)
+{
+	std::set<std::string> remain = hopeFields;
+	std::map<std::string, int> idxmap;
+	for (size_t i = 0; i < fileds.size(); i++)
+	{
+		idxmap[fileds[i]] = i;
+		remain.erase(fileds[i]);
+	}
+
+	for (auto& lost: remain)
+		idxmap[lost] = -1;
+
+	return idxmap;
+}
+
+void parseDeployedActors(const std::vector<std::string>& fields, const std::vector<std::vector<std::string>>& rows,
+	std::map<std::string, struct ActorInfo>& actorInfos)
+{
+	std::map<std::string, int> idxmap = buildIdxMap(std::set<std::string>{"actor", "size", "md5", "mtime"}, fields);
+
+	actorInfos.clear();
+	for (auto& row: rows)
+	{
+		int idx = idxmap["actor"];
+		if (idx < 0)
+			continue;
+
+		struct ActorInfo& ai = actorInfos[row[idx]];
+
+		idx = idxmap["mtime"];
+		if (idx > -1)
+			ai.mtime = atoll(row[idx].c_str());
+
+		idx = idxmap["size"];
+		if (idx > -1)
+			ai.fileSize = atoll(row[idx].c_str());
+
+		idx = idxmap["md5"];
+		if (idx > -1)
+			ai.fileMd5 = row[idx];
+	}
+}
+
+void appendAvailableActorRows(std::vector<std::vector<std::string>>& rows, const std::map<std::string, struct ActorInfo>& actorInfos)
+{
+	for (auto& pp: actorInfos)
+	{
+		rows.push_back(std::vector<std::string>());
+		std::vector<std::string>& row = rows.back();
+
+		row.push_back(pp.first);
+		row.push_back(std::to_string(pp.second.fileSize));
+		row.push_back(std::to_string(pp.second.mtime));
+		row.push_back(pp.second.fileMd5);
+		row.push_back(pp.second.desc);
+	}
+}
+
+void appendDeployedActorRows(std::vector<std::vector<std::string>>& rows, const struct DeployHost& deployHost,
+	const std::map<std::string, struct ActorInfo>& actorInfos)
+{
+	for (auto& pp: actorInfos)
+	{
+		rows.push_back(std::vector<std::string>());
+		std::vector<std::string>& row = rows.back();
+
+		row.push_back(deployHost.region);
+		row.push_back(deployHost.endpoint);
+		row.push_back(pp.first);
+		row.push_back(std::to_string(pp.second.fileSize));
+		row.push_back(std::to_string(pp.second.mtime));
+		row.push_back(pp.second.fileMd5);
+	}
+
+	if (actorInfos.empty())
+		rows.push_back(std::vector<std::string>{deployHost.region, deployHost.endpoint, "", "", "", ""});
+}
+
+void appendActorTaskRows(std::vector<std::vector<std::string>>& rows, const struct DeployHost& deployHost, const std::string& actorName,
+	int pid, const std::map<int, std::vector<std::string>>& taskMap)
+{
+	for (auto& pp: taskMap)
+		rows.push_back(std::vector<std::string>{deployHost.region, deployHost.endpoint, actorName, std::to_string(pid),
+			std::to_string(pp.first), pp.second[0], pp.second[1]});
+
+	if (taskMap.empty())
+		rows.push_back(std::vector<std::string>{deployHost.region, deployHost.endpoint, actorName, std::to_string(pid), "", "", ""});
+}
+
+void appendIoStatus(std::vector<std::string>& row, const struct MachineIoStatus& io)
+{
+	const char* pressureNames[] = {"cpuSome", "memorySome", "memoryFull", "ioSome", "ioFull"};
+	for (auto name: pressureNames)
+	{
+		auto iter = io.pressure.find(name);
+		row.push_back((iter != io.pressure.end()) ? std::to_string(iter->second) : std::string("N/A"));
+	}
+
+	const char* vmNames[] = {"majorFaults", "swapIn", "swapOut"};
+	for (auto name: vmNames)
+	{
+		auto iter = io.vmstat.find(name);
+		row.push_back((iter != io.vmstat.end()) ? std::to_string(iter->second) : std::string("N/A"));
+	}
+
+	float iops = 0, readBytes = 0, writeBytes = 0, maxUtil = 0;
+	std::string maxDisk;
+	for (auto& pp: io.disks)
+	{
+		if (pp.second.size() < 6)
+			continue;
+
+		iops += pp.second[0] + pp.second[1];
+		readBytes += pp.second[2];
+		writeBytes += pp.second[3];
+		if (maxDisk.empty() || pp.second[5] > maxUtil)
+		{
+			maxUtil = pp.second[5];
+			maxDisk = pp.first;
+		}
+	}
+
+	row.push_back(std::to_string(iops));
+	row.push_back(std::to_string((int64_t)readBytes));
+	row.push_back(std::to_string((int64_t)writeBytes));
+	row.push_back(std::to_string(maxUtil));
+	row.push_back(maxDisk);
+}
+
+void appendCpuStatus(std::vector<std::string>& row, const struct MachineCpuStatus& cpu)
+{
+	row.push_back(std::to_string(cpu.util));
+	row.push_back(std::to_string(cpu.user));
+	row.push_back(std::to_string(cpu.system));
+	row.push_back(std::to_string(cpu.iowait));
+	row.push_back(std::to_string(cpu.irq));
+	row.push_back(std::to_string(cpu.softirq));
+	row.push_back(std::to_string(cpu.steal));
+	row.push_back(std::to_string(cpu.maxCoreUtil));
+	row.push_back(std::to_string(cpu.maxCore));
+}
+
+void appendMachineStatusRow(std::vector<std::vector<std::string>>& rows, const char* source, const struct DeployHost& deployHost,
+	const struct MonitorInfo& info)
+{
+	std::string host;
+	int port;
+
+	if (!parseAddress(deployHost.endpoint, host, port))
+		host = deployHost.endpoint;
+
+	rows.push_back(std::vector<std::string>());
+	std::vector<std::string>& row = rows.back();
+
+	row.push_back(source);
+	row.push_back(deployHost.region);
+	row.push_back(host);
+
+	row.push_back(std::to_string(info.delayInMsec));
+	row.push_back(std::to_string(info.cpuCount));
+	row.push_back(std::to_string(info.systemLoad));
+
+	row.push_back(std::to_string(info.memoryCount));
+	row.push_back(std::to_string(info.freeMemories));
+	row.push_back(std::to_string(info.tcpCount));
+	row.push_back(std::to_string(info.udpCount));
+
+	row.push_back(std::to_string(info.recvBytesDiff));
+	row.push_back(std::to_string(info.sendBytesDiff));
+
+	appendCpuStatus(row, info.cpu);
+	appendIoStatus(row, info.io);
+}
+
+bool fetchFilledSection(std::map<int, std::string>& sections, int& no, std::string& section)
+{
+	for (auto& sp: sections)
+	{
+		if (sp.second.length())
+		{
+			section.swap(sp.second);
+			no = sp.first;
+			return true;
+		}
+	}
+	return false;
+}
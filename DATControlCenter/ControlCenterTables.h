@@ -0,0 +1,35 @@
+#ifndef DAT_Control_Center_Tables_h
+#define DAT_Control_Center_Tables_h
+
+#include "ControlCenterQuestProcessor.h"
+
+/*
+	Parsers & table builders of control center. They neither lock nor touch connections,
+	so they are also linked by DATBenchmark/DATControlCenterBenchmark.
+*/
+
+//-- Index of each field. Field not in fileds is -1.
+std::map<std::string, int> buildIdxMap(const std::set<std::string>& hopeFields, const std::vector<std::string>& fileds);
+
+//-- rows of registerDeployer, fields: actor, size, md5, mtime.
+void parseDeployedActors(const std::vector<std::string>& fields, const std::vector<std::vector<std::string>>& rows,
+	std::map<std::string, struct ActorInfo>& actorInfos);
+
+//-- Rows of availableActors & deployedActors in availableActors answer.
+void appendAvailableActorRows(std::vector<std::vector<std::string>>& rows, const std::map<std::string, struct ActorInfo>& actorInfos);
+void appendDeployedActorRows(std::vector<std::vector<std::string>>& rows, const struct DeployHost& deployHost,
+	const std::map<std::string, struct ActorInfo>& actorInfos);
+
+//-- Rows of actorTaskStatus for an actor process: a row for each task, or a row without task.
+void appendActorTaskRows(std::vector<std::vector<std::string>>& rows, const struct DeployHost& deployHost, const std::string& actorName,
+	int pid, const std::map<int, std::vector<std::string>>& taskMap);
+
+void appendIoStatus(std::vector<std::string>& row, const struct MachineIoStatus& io);
+void appendCpuStatus(std::vector<std::string>& row, const struct MachineCpuStatus& cpu);
+void appendMachineStatusRow(std::vector<std::vector<std::string>>& rows, const char* source, const struct DeployHost& deployHost,
+	const struct MonitorInfo& info);
+
+//-- Take the first received section. Return false if no section received.
+bool fetchFilledSection(std::map<int, std::string>& sections, int& no, std::string& section);
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef DAT_Host_Registry_h
+#define DAT_Host_Registry_h
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "StringInterner.h"
+
+struct DeployHost
+{
+	std::string region;
+	std::string endpoint;
+
+	bool operator< (const struct DeployHost& r) const
+	{
+		if (region < r.region)
+			return true;
+		else if (region == r.region)
+		{
+			if (endpoint < r.endpoint)
+				return true;
+		}
+		return false;
+	}
+
+	bool operator== (const struct DeployHost& r) const
+	{
+		return (region == r.region && endpoint == r.endpoint);
+	}
+};
+
+/*
+	Flat registry of agents & actors, keyed by the interned endpoint id.
+
+	An endpoint (ip:port of a connection) belongs to one region, so the endpoint id alone locates an entry:
+	a lookup is an index into a vector, without string compares. Entries are stored contiguously,
+	erase() moves the last entry into the hole, so the iteration order is not sorted.
+	Iterators & references are invalid after operator[] or erase(), except the iterator returned by erase().
+	Not thread safe: used under ControlCenterQuestProcessor::_mutex.
+*/
+template <typename T>
+class HostRegistry
+{
+public:
+	typedef std::pair<struct DeployHost, T> value_type;
+	typedef typename std::vector<value_type>::iterator iterator;
+	typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+private:
+	HostNames& _names;
+	std::vector<value_type> _entries;
+	std::vector<uint32_t> _regionIds;		//-- parallel to _entries.
+	std::vector<uint32_t> _endpointIds;		//-- parallel to _entries.
+	std::vector<uint32_t> _slots;			//-- endpoint id -> entry index + 1. 0: absent.
+
+	uint32_t slotOf(uint32_t endpointId) const
+	{
+		return (endpointId < _slots.size()) ? _slots[endpointId] : 0;
+	}
+
+public:
+	explicit HostRegistry(HostNames& names): _names(names) {}
+	HostRegistry(const HostRegistry&) = delete;
+	~HostRegistry()
+	{
+		for (size_t i = 0; i < _entries.size(); i++)
+		{
+			_names.regions.release(_regionIds[i]);
+			_names.endpoints.release(_endpointIds[i]);
+		}
+	}
+
+	iterator begin() { return _entries.begin(); }
+	iterator end() { return _entries.end(); }
+	const_iterator begin() const { return _entries.begin(); }
+	const_iterator end() const { return _entries.end(); }
+	size_t size() const { return _entries.size(); }
+	bool empty() const { return _entries.empty(); }
+
+	iterator findEndpoint(uint32_t endpointId)
+	{
+		uint32_t slot = slotOf(endpointId);
+		return slot ? _entries.begin() + (slot - 1) : _entries.end();
+	}
+
+	iterator findEndpoint(const std::string& endpoint)
+	{
+		uint32_t endpointId = _names.endpoints.find(endpoint);
+		if (endpointId == 0 && endpoint.size())
+			return _entries.end();
+
+		return findEndpoint(endpointId);
+	}
+
+	iterator find(const struct DeployHost& host)
+	{
+		iterator iter = findEndpoint(host.endpoint);
+		if (iter != _entries.end() && iter->first.region != host.region)
+			return _entries.end();
+
+		return iter;
+	}
+
+	//-- An endpoint re-registered with another region moves to the new region.
+	T& operator[](const struct DeployHost& host)
+	{
+		uint32_t endpointId = _names.endpoints.intern(host.endpoint);
+		uint32_t slot = slotOf(endpointId);
+		if (slot)
+		{
+			_names.endpoints.release(endpointId);
+
+			size_t index = slot - 1;
+			if (_entries[index].first.region != host.region)
+			{
+				uint32_t regionId = _names.regions.intern(host.region);
+				_names.regions.release(_regionIds[index]);
+				_regionIds[index] = regionId;
+				_entries[index].first.region = host.region;
+			}
+			return _entries[index].second;
+		}
+
+		if (endpointId >= _slots.size())
+			_slots.resize(endpointId + 1, 0);
+
+		_entries.push_back(value_type(host, T()));
+		_regionIds.push_back(_names.regions.intern(host.region));
+		_endpointIds.push_back(endpointId);
+		_slots[endpointId] = (uint32_t)_entries.size();
+		return _entries.back().second;
+	}
+
+	iterator erase(iterator iter)
+	{
+		size_t index = iter - _entries.begin();
+		size_t last = _entries.size() - 1;
+
+		_slots[_endpointIds[index]] = 0;
+		_names.regions.release(_regionIds[index]);
+		_names.endpoints.release(_endpointIds[index]);
+
+		if (index != last)
+		{
+			_entries[index] = std::move(_entries[last]);
+			_regionIds[index] = _regionIds[last];
+			_endpointIds[index] = _endpointIds[last];
+			_slots[_endpointIds[index]] = (uint32_t)index + 1;
+		}
+
+		_entries.pop_back();
+		_regionIds.pop_back();
+		_endpointIds.pop_back();
+		return _entries.begin() + index;
+	}
+
+	size_t erase(const struct DeployHost& host)
+	{
+		iterator iter = find(host);
+		if (iter == _entries.end())
+			return 0;
+
+		erase(iter);
+		return 1;
+	}
+};
+
+#endif
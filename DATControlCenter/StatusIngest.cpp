@@ -0,0 +1,214 @@
+#include <chrono>
+#include "StatusIngest.h"
+
+const std::string& StatusMessage::method() const
+{
+	static const std::string statusMethod("actorStatus");
+	static const std::string resultMethod("actorResult");
+	static const std::string lifecycleMethod("actorLifecycle");
+
+	switch (kind)
+	{
+		case StatusKind::Result: return resultMethod;
+		case StatusKind::Lifecycle: return lifecycleMethod;
+		default: return statusMethod;
+	}
+}
+
+StatusRing::StatusRing(size_t capacity): _enqueuePos(0), _dequeuePos(0)
+{
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+
+	_slots.reset(new struct Slot[size]);
+	for (size_t i = 0; i < size; i++)
+		_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+	_mask = size - 1;
+}
+
+bool StatusRing::push(struct StatusMessage& message, size_t limit)
+{
+	uint64_t pos = _enqueuePos.load(std::memory_order_relaxed);
+	while (true)
+	{
+		if (pos - _dequeuePos.load(std::memory_order_relaxed) >= limit)
+			return false;
+
+		struct Slot& slot = _slots[pos & _mask];
+		uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+		int64_t diff = (int64_t)(sequence - pos);
+
+		if (diff == 0)
+		{
+			if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				slot.message = std::move(message);
+				slot.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+			return false;
+		else
+			pos = _enqueuePos.load(std::memory_order_relaxed);
+	}
+}
+
+bool StatusRing::pop(struct StatusMessage& message)
+{
+	uint64_t pos = _dequeuePos.load(std::memory_order_relaxed);
+	struct Slot& slot = _slots[pos & _mask];
+	if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+		return false;
+
+	message = std::move(slot.message);
+	slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+	_dequeuePos.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+size_t StatusRing::depth() const
+{
+	uint64_t dequeuePos = _dequeuePos.load(std::memory_order_acquire);
+	uint64_t enqueuePos = _enqueuePos.load(std::memory_order_acquire);
+	return (enqueuePos > dequeuePos) ? (size_t)(enqueuePos - dequeuePos) : 0;
+}
+
+void StatusIngest::start(int threads, size_t capacity, Dispatcher dispatcher)
+{
+	if (threads < 1)
+		threads = 1;
+
+	_dispatcher = dispatcher;
+	_running = true;
+
+	for (int i = 0; i < threads; i++)
+		_shards.emplace_back(new struct Shard(capacity));
+
+	for (auto& shard: _shards)
+		shard->thread = std::thread(&StatusIngest::dispatchCycle, this, shard.get());
+}
+
+void StatusIngest::stop()
+{
+	if (!_running.exchange(false))
+		return;
+
+	for (auto& shard: _shards)
+	{
+		{
+			std::unique_lock<std::mutex> lck(shard->mutex);
+			shard->cond.notify_one();
+		}
+		shard->thread.join();
+	}
+}
+
+bool StatusIngest::push(struct StatusMessage& message)
+{
+	struct Shard* shard = _shards[(unsigned int)message.taskId % _shards.size()].get();
+	size_t capacity = shard->ring.capacity();
+	size_t limit = (message.kind == StatusKind::Status) ? capacity - capacity / 8 : capacity;
+
+	if (shard->overflowing.load(std::memory_order_acquire) || !shard->ring.push(message, limit))
+	{
+		if (message.kind != StatusKind::Status)
+			return appendOverflow(shard, message);
+
+		shard->dropped++;
+		return true;
+	}
+
+	shard->enqueued++;
+
+	size_t depth = shard->ring.depth();
+	size_t maxDepth = shard->maxDepth.load(std::memory_order_relaxed);
+	while (depth > maxDepth && !shard->maxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed));
+
+	//-- Pairs with the fence in dispatchCycle(): either the consumer sees the message, or we see it sleeping.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (shard->sleeping.load(std::memory_order_relaxed))
+	{
+		std::unique_lock<std::mutex> lck(shard->mutex);
+		shard->cond.notify_one();
+	}
+	return true;
+}
+
+bool StatusIngest::appendOverflow(struct Shard* shard, struct StatusMessage& message)
+{
+	std::unique_lock<std::mutex> lck(shard->mutex);
+	if (message.kind == StatusKind::Result && shard->overflow.size() >= shard->ring.capacity())
+	{
+		shard->rejected++;
+		return false;
+	}
+
+	shard->overflow.push_back(std::move(message));
+	shard->overflowing.store(true, std::memory_order_release);
+	shard->overflowed++;
+	shard->cond.notify_one();
+	return true;
+}
+
+void StatusIngest::dispatchCycle(struct Shard* shard)
+{
+	struct StatusMessage message;
+	std::deque<struct StatusMessage> overflow;
+	while (_running)
+	{
+		if (shard->ring.pop(message))
+		{
+			_dispatcher(message);
+			shard->dispatched++;
+			continue;
+		}
+
+		//-- Ring is drained, including slots claimed but not filled yet: messages in it are older than the overflow list.
+		if (shard->overflowing.load(std::memory_order_acquire) && shard->ring.depth() == 0)
+		{
+			{
+				std::unique_lock<std::mutex> lck(shard->mutex);
+				overflow.swap(shard->overflow);
+				shard->overflowing.store(false, std::memory_order_release);
+			}
+
+			for (auto& overflowed: overflow)
+			{
+				_dispatcher(overflowed);
+				shard->dispatched++;
+			}
+			overflow.clear();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lck(shard->mutex);
+		shard->sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (_running && shard->ring.depth() == 0 && !shard->overflowing.load(std::memory_order_relaxed))
+			shard->cond.wait_for(lck, std::chrono::milliseconds(100));
+
+		shard->sleeping.store(false, std::memory_order_relaxed);
+	}
+}
+
+const std::vector<std::string>& StatusIngest::fields()
+{
+	static const std::vector<std::string> ingestFields{"shard", "capacity", "depth", "maxDepth", "enqueued", "dispatched", "dropped", "overflowed", "rejected"};
+	return ingestFields;
+}
+
+void StatusIngest::appendRows(std::vector<std::vector<std::string>>& rows) const
+{
+	for (size_t i = 0; i < _shards.size(); i++)
+	{
+		const struct Shard* shard = _shards[i].get();
+		rows.push_back(std::vector<std::string>{ std::to_string(i), std::to_string(shard->ring.capacity()),
+			std::to_string(shard->ring.depth()), std::to_string(shard->maxDepth.load()), std::to_string(shard->enqueued.load()),
+			std::to_string(shard->dispatched.load()), std::to_string(shard->dropped.load()), std::to_string(shard->overflowed.load()),
+			std::to_string(shard->rejected.load()) });
+	}
+}
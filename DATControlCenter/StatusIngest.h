@@ -0,0 +1,126 @@
+#ifndef DAT_Status_Ingest_h
+#define DAT_Status_Ingest_h
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+enum class StatusKind: uint8_t
+{
+	Status,
+	Result,
+	Lifecycle,		//-- actor exited, the last message of its tasks.
+	Finished,		//-- action answered. Not forwarded, only closes the task's subscriptions.
+};
+
+struct StatusMessage
+{
+	int taskId;
+	StatusKind kind;
+	std::string region;
+	std::string endpoint;
+	std::string payload;
+
+	StatusMessage(): taskId(0), kind(StatusKind::Status) {}
+
+	//-- Method of the forwarded quest.
+	const std::string& method() const;
+};
+
+/*
+	Bounded multi-producer single-consumer ring, lock free.
+	Each slot carries a sequence: pos when free for the producer of pos, pos + 1 when filled.
+*/
+class StatusRing
+{
+	struct Slot
+	{
+		std::atomic<uint64_t> sequence;
+		struct StatusMessage message;
+	};
+
+	std::unique_ptr<struct Slot[]> _slots;
+	uint64_t _mask;
+	char _padding0[64];		//-- producers & consumer positions in separate cache lines.
+	std::atomic<uint64_t> _enqueuePos;
+	char _padding1[64];
+	std::atomic<uint64_t> _dequeuePos;
+
+public:
+	//-- capacity is rounded up to a power of 2.
+	explicit StatusRing(size_t capacity);
+
+	//-- Fails when depth reaches limit. message is moved only when succeeded.
+	bool push(struct StatusMessage& message, size_t limit);
+	//-- Consumer only.
+	bool pop(struct StatusMessage& message);
+
+	size_t capacity() const { return (size_t)_mask + 1; }
+	size_t depth() const;
+};
+
+/*
+	actorStatus/actorResult ingest. Workers enqueue and answer at once,
+	shard threads forward in order of each task, since a task is always in the same shard.
+	Status is dropped when a shard is 7/8 full, leaving the rest to results & lifecycle events.
+	When the ring is full, results & lifecycle events go to the overflow list of the shard,
+	and all messages after them too until the list is drained, so nothing overtakes them.
+	The overflow list holds at most ring capacity results, further results are rejected, and the actor should retry them.
+	Actor exits & task finishes come from deployers & CC itself, bounded by running actors & actions, and are always queued.
+*/
+class StatusIngest
+{
+public:
+	typedef std::function<void (struct StatusMessage&)> Dispatcher;
+
+private:
+	struct Shard
+	{
+		StatusRing ring;
+		std::atomic<uint64_t> enqueued;
+		std::atomic<uint64_t> dispatched;
+		std::atomic<uint64_t> dropped;
+		std::atomic<uint64_t> overflowed;		//-- results & lifecycle events, when the ring is full.
+		std::atomic<uint64_t> rejected;			//-- results, when the overflow list is full too.
+		std::atomic<size_t> maxDepth;
+		std::atomic<bool> sleeping;
+		std::atomic<bool> overflowing;
+		std::mutex mutex;
+		std::condition_variable cond;
+		std::deque<struct StatusMessage> overflow;		//-- guarded by mutex.
+		std::thread thread;
+
+		explicit Shard(size_t capacity): ring(capacity), enqueued(0), dispatched(0), dropped(0), overflowed(0), rejected(0),
+			maxDepth(0), sleeping(false), overflowing(false) {}
+	};
+
+	std::vector<std::unique_ptr<struct Shard>> _shards;
+	std::atomic<bool> _running;
+	Dispatcher _dispatcher;
+
+	bool appendOverflow(struct Shard* shard, struct StatusMessage& message);
+	void dispatchCycle(struct Shard* shard);
+
+public:
+	StatusIngest(): _running(false) {}
+	~StatusIngest() { stop(); }
+
+	void start(int threads, size_t capacity, Dispatcher dispatcher);
+	void stop();
+
+	//-- Never blocks. Status may be dropped silently. Returns false when a result is rejected.
+	bool push(struct StatusMessage& message);
+
+	static const std::vector<std::string>& fields();
+	//-- One row per shard.
+	void appendRows(std::vector<std::vector<std::string>>& rows) const;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "StatusSnapshot.h"
+
+void writeRows(FPAWriter& aw, const char* name, const std::vector<SharedRows>& parts)
+{
+	size_t count = 0;
+	for (auto& part: parts)
+		if (part)
+			count += part->size();
+
+	aw.paramArray(name, count);
+	for (auto& part: parts)
+	{
+		if (!part)
+			continue;
+
+		for (auto& row: *part)
+			aw.param(row);
+	}
+}
+
+FPAnswerPtr SnapshotPublisher::reuse(const FPQuestPtr quest)
+{
+	//-- Payload is encoded as msgpack.
+	if (quest->isJson())
+		return nullptr;
+
+	StatusSnapshotPtr snapshot = std::atomic_load(&_snapshot);
+	if (!snapshot || snapshot->version != version())
+		return nullptr;
+
+	FPAnswerPtr answer = FPAWriter::emptyAnswer(quest);
+	answer->setPayload(snapshot->payload);
+	return answer;
+}
+
+void SnapshotPublisher::publish(uint64_t version, const FPQuestPtr quest, const FPAnswerPtr answer)
+{
+	if (quest->isJson())
+		return;
+
+	StatusSnapshotPtr current = std::atomic_load(&_snapshot);
+	if (current && current->version >= version)
+		return;
+
+	std::shared_ptr<struct StatusSnapshot> snapshot = std::make_shared<struct StatusSnapshot>();
+	snapshot->version = version;
+	snapshot->payload = answer->payload();
+	std::atomic_store(&_snapshot, StatusSnapshotPtr(snapshot));
+}
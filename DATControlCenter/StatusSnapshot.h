@@ -0,0 +1,54 @@
+#ifndef DAT_Status_Snapshot_h
+#define DAT_Status_Snapshot_h
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FPWriter.h"
+
+using namespace fpnn;
+
+/*
+	Snapshots of read-only status queries: machineStatus, availableActors, actorTaskStatus.
+
+	Writers rebuild the rows of the changed entry only, publish them as an immutable SharedRows,
+	and touch() the version, all under ControlCenterQuestProcessor::_mutex.
+	A reader takes the version & collects SharedRows pointers under the lock, then encodes without the lock.
+	The encoded payload is published, and reused by later readers until the version changes.
+*/
+typedef std::shared_ptr<const std::vector<std::vector<std::string>>> SharedRows;
+
+inline SharedRows shareRows(std::vector<std::vector<std::string>>& rows)
+{
+	return std::make_shared<const std::vector<std::vector<std::string>>>(std::move(rows));
+}
+
+//-- Write parts as one array of rows. Empty parts are skipped.
+void writeRows(FPAWriter& aw, const char* name, const std::vector<SharedRows>& parts);
+
+struct StatusSnapshot
+{
+	uint64_t version;
+	std::string payload;
+};
+typedef std::shared_ptr<const struct StatusSnapshot> StatusSnapshotPtr;
+
+class SnapshotPublisher
+{
+	std::atomic<uint64_t> _version;
+	StatusSnapshotPtr _snapshot;		//-- std::atomic_load & std::atomic_store only.
+
+public:
+	SnapshotPublisher(): _version(1) {}
+
+	void touch() { _version.fetch_add(1, std::memory_order_release); }
+	uint64_t version() const { return _version.load(std::memory_order_acquire); }
+
+	//-- Answer with the published payload if nothing changed since. Otherwise returns nullptr.
+	FPAnswerPtr reuse(const FPQuestPtr quest);
+	//-- version: read with the rows under the lock.
+	void publish(uint64_t version, const FPQuestPtr quest, const FPAnswerPtr answer);
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "StringInterner.h"
+
+StringInterner::StringInterner()
+{
+	auto iter = _ids.emplace(std::string(), 0).first;
+
+	struct Entry entry;
+	entry.str = &(iter->first);
+	entry.refs = 1;
+	_entries.push_back(entry);
+}
+
+uint32_t StringInterner::intern(const std::string& str)
+{
+	auto iter = _ids.find(str);
+	if (iter != _ids.end())
+	{
+		if (iter->second)
+			_entries[iter->second].refs++;
+
+		return iter->second;
+	}
+
+	uint32_t id;
+	if (_freeIds.size())
+	{
+		id = _freeIds.back();
+		_freeIds.pop_back();
+	}
+	else
+	{
+		id = (uint32_t)_entries.size();
+		_entries.push_back(Entry());
+	}
+
+	iter = _ids.emplace(str, id).first;
+	_entries[id].str = &(iter->first);
+	_entries[id].refs = 1;
+	return id;
+}
+
+void StringInterner::release(uint32_t id)
+{
+	if (id == 0 || id >= _entries.size() || _entries[id].refs == 0)
+		return;
+
+	if (--_entries[id].refs)
+		return;
+
+	_ids.erase(_ids.find(*_entries[id].str));
+	_entries[id].str = nullptr;
+	_freeIds.push_back(id);
+}
+
+uint32_t StringInterner::find(const std::string& str) const
+{
+	auto iter = _ids.find(str);
+	return (iter == _ids.end()) ? 0 : iter->second;
+}
+
+size_t StringInterner::memoryBytes() const
+{
+	//-- Node: next pointer, key, value & cached hash.
+	size_t nodeBytes = sizeof(void*) + sizeof(std::string) + sizeof(uint32_t) + sizeof(size_t);
+	size_t bytes = _ids.bucket_count() * sizeof(void*) + _ids.size() * nodeBytes;
+	for (auto& pp: _ids)
+		if (pp.first.capacity() > 15)
+			bytes += pp.first.capacity() + 1;
+
+	bytes += _entries.capacity() * sizeof(struct Entry) + _freeIds.capacity() * sizeof(uint32_t);
+	return bytes;
+}
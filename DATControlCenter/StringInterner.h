@@ -0,0 +1,52 @@
+#ifndef DAT_String_Interner_h
+#define DAT_String_Interner_h
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+/*
+	Dense ids of strings, reference counted. Id 0 is the empty string and never released.
+	Ids of released strings are reused, so the table is bounded by the live connections,
+	although every actor connection brings its own endpoint.
+*/
+class StringInterner
+{
+	struct Entry
+	{
+		const std::string* str;
+		uint32_t refs;
+	};
+
+	std::unordered_map<std::string, uint32_t> _ids;
+	std::vector<struct Entry> _entries;
+	std::vector<uint32_t> _freeIds;
+
+public:
+	StringInterner();
+
+	//-- Add a reference.
+	uint32_t intern(const std::string& str);
+	void release(uint32_t id);
+
+	//-- Without reference. Returns 0 if not interned.
+	uint32_t find(const std::string& str) const;
+	const std::string& str(uint32_t id) const { return *_entries[id].str; }
+
+	size_t size() const { return _ids.size(); }
+	size_t memoryBytes() const;
+};
+
+//-- Names shared by connections & host registries of control center. Used under ControlCenterQuestProcessor::_mutex.
+struct HostNames
+{
+	StringInterner regions;
+	StringInterner endpoints;
+	StringInterner actorNames;
+	StringInterner hosts;			//-- ip of actor endpoints, for the actor pid index.
+
+	size_t memoryBytes() const { return regions.memoryBytes() + endpoints.memoryBytes() + actorNames.memoryBytes() + hosts.memoryBytes(); }
+};
+
+#endif
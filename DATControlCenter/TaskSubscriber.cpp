@@ -0,0 +1,227 @@
+#include <atomic>
+#include "msec.h"
+#include "FPLog.h"
+#include "TaskSubscriber.h"
+
+bool SubscriptionFilter::match(const std::string& region, const std::string& endpoint, const std::string& host) const
+{
+	if (regions.size() && regions.find(region) == regions.end())
+		return false;
+
+	if (endpoints.empty())
+		return true;
+
+	return endpoints.find(endpoint) != endpoints.end() || endpoints.find(host) != endpoints.end();
+}
+
+TaskSubscriber::TaskSubscriber(const ConnectionInfo& ci, QuestSenderPtr sender, OverflowPolicy policy_, size_t capacity_, int window_,
+	int maxRate_): _sender(sender), _frontSequence(0), _maxQueued(0), _inflight(0), _closed(false), _tokens(maxRate_),
+	_refillMsec(slack_mono_msec()), _sent(0), _dropped(0), _coalesced(0), _throttled(0), _filtered(0),
+	socket(ci.socket), endpoint(ci.endpoint()), policy(policy_), capacity(capacity_ ? capacity_ : 1), window(window_ > 0 ? window_ : 1),
+	maxRate(maxRate_ > 0 ? maxRate_ : 0)
+{
+}
+
+bool TaskSubscriber::parsePolicy(const std::string& name, OverflowPolicy& policy)
+{
+	if (name == "dropOldest")
+		policy = OverflowPolicy::DropOldest;
+	else if (name == "keepLatest")
+		policy = OverflowPolicy::KeepLatest;
+	else if (name == "disconnect")
+		policy = OverflowPolicy::Disconnect;
+	else
+		return false;
+
+	return true;
+}
+
+const char* TaskSubscriber::policyName(OverflowPolicy policy)
+{
+	switch (policy)
+	{
+		case OverflowPolicy::KeepLatest: return "keepLatest";
+		case OverflowPolicy::Disconnect: return "disconnect";
+		default: return "dropOldest";
+	}
+}
+
+void TaskSubscriber::popFront(bool dropped)
+{
+	struct PendingQuest& front = _queue.front();
+	if (front.status && policy == OverflowPolicy::KeepLatest)
+	{
+		auto iter = _latestStatus.find(std::make_pair(front.taskId, front.endpoint));
+		if (iter != _latestStatus.end() && iter->second == _frontSequence)
+			_latestStatus.erase(iter);
+	}
+
+	if (dropped)
+		_dropped++;
+
+	_queue.pop_front();
+	_frontSequence++;
+}
+
+//-- Token bucket of one second burst.
+bool TaskSubscriber::takeToken()
+{
+	int64_t now = slack_mono_msec();
+	if (now > _refillMsec)
+	{
+		_tokens += (double)(now - _refillMsec) * maxRate / 1000;
+		if (_tokens > maxRate)
+			_tokens = maxRate;
+
+		_refillMsec = now;
+	}
+
+	if (_tokens < 1)
+		return false;
+
+	_tokens -= 1;
+	return true;
+}
+
+//-- States of a sent quest. Only a counted quest releases its window slot when answered,
+//-- so a callback of a failed send, or an answer arrived before counted, doesn't decrease _inflight.
+enum SendState: int { SendPending, SendCounted, SendAnswered };
+
+//-- Sent under _mutex, so quests of a task are kept in order.
+bool TaskSubscriber::sendLocked(const FPQuestPtr quest)
+{
+	std::weak_ptr<TaskSubscriber> weakSelf = shared_from_this();
+	std::shared_ptr<std::atomic<int>> state = std::make_shared<std::atomic<int>>(SendPending);
+	bool status = _sender->sendQuest(quest, [weakSelf, state](FPAnswerPtr answer, int errorCode){
+		if (errorCode != FPNN_EC_OK)
+			LOG_ERROR("Forward 'actorStatus' or 'actorResult' error. Code: %d", errorCode);
+
+		if (state->exchange(SendAnswered) != SendCounted)
+			return;
+
+		TaskSubscriberPtr self = weakSelf.lock();
+		if (self)
+			self->answered();
+	}, 0);
+
+	if (!status)
+	{
+		_dropped++;
+		return false;
+	}
+
+	int expected = SendPending;
+	if (state->compare_exchange_strong(expected, SendCounted))
+		_inflight++;
+
+	_sent++;
+	return true;
+}
+
+void TaskSubscriber::answered()
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	_inflight--;
+
+	while (!_closed && _queue.size() && _inflight < window)
+	{
+		FPQuestPtr quest = _queue.front().quest;
+		popFront(false);
+		sendLocked(quest);
+	}
+}
+
+bool TaskSubscriber::post(int taskId, bool status, const std::string& sourceEndpoint, const FPQuestPtr quest)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	if (_closed)
+		return false;
+
+	if (status && maxRate && !takeToken())
+	{
+		_throttled++;
+		return true;
+	}
+
+	if (_queue.empty() && _inflight < window)
+	{
+		sendLocked(quest);
+		return true;
+	}
+
+	if (policy == OverflowPolicy::KeepLatest)
+	{
+		auto iter = _latestStatus.find(std::make_pair(taskId, sourceEndpoint));
+		if (iter != _latestStatus.end())
+		{
+			if (status)
+			{
+				_queue[iter->second - _frontSequence].quest = quest;
+				_coalesced++;
+				return true;
+			}
+
+			//-- Status after the result is not moved before it.
+			_latestStatus.erase(iter);
+		}
+	}
+
+	if (_queue.size() >= capacity)
+	{
+		if (policy == OverflowPolicy::Disconnect)
+		{
+			_dropped += _queue.size() + 1;
+			_queue.clear();
+			_latestStatus.clear();
+			_closed = true;
+			return false;
+		}
+
+		popFront(true);
+	}
+
+	if (status && policy == OverflowPolicy::KeepLatest)
+		_latestStatus[std::make_pair(taskId, sourceEndpoint)] = _frontSequence + _queue.size();
+
+	struct PendingQuest pending;
+	pending.taskId = taskId;
+	pending.status = status;
+	pending.endpoint = sourceEndpoint;
+	pending.quest = quest;
+	_queue.push_back(pending);
+
+	if (_queue.size() > _maxQueued)
+		_maxQueued = _queue.size();
+
+	return true;
+}
+
+void TaskSubscriber::close()
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	_closed = true;
+	_queue.clear();
+	_latestStatus.clear();
+}
+
+void TaskSubscriber::filtered()
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	_filtered++;
+}
+
+const std::vector<std::string>& TaskSubscriber::fields()
+{
+	static const std::vector<std::string> subscriberFields{"endpoint", "tasks", "policy", "capacity", "window",
+		"maxRate", "queued", "maxQueued", "inflight", "sent", "dropped", "coalesced", "throttled", "filtered"};
+	return subscriberFields;
+}
+
+void TaskSubscriber::appendRow(std::vector<std::vector<std::string>>& rows, size_t taskCount)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	rows.push_back(std::vector<std::string>{ endpoint, std::to_string(taskCount), policyName(policy), std::to_string(capacity),
+		std::to_string(window), std::to_string(maxRate), std::to_string(_queue.size()), std::to_string(_maxQueued),
+		std::to_string(_inflight), std::to_string(_sent), std::to_string(_dropped), std::to_string(_coalesced),
+		std::to_string(_throttled), std::to_string(_filtered) });
+}
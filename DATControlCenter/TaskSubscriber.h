@@ -0,0 +1,106 @@
+#ifndef DAT_Task_Subscriber_h
+#define DAT_Task_Subscriber_h
+
+#include <map>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IQuestProcessor.h"
+
+using namespace fpnn;
+
+enum class OverflowPolicy: uint8_t
+{
+	DropOldest,
+	KeepLatest,		//-- queued status of a (task, endpoint) is replaced by the newer one; drop oldest when still full.
+	Disconnect,		//-- subscriptions of the connection are cancelled.
+};
+
+//-- Options of monitorTasks, for the tasks subscribed in the same call. Results are never sampled.
+struct SubscriptionFilter
+{
+	std::set<std::string> regions;
+	std::set<std::string> endpoints;		//-- actor endpoints or hosts.
+	int sampleEvery;						//-- forward 1 of every N status.
+	bool resultsOnly;
+
+	SubscriptionFilter(): sampleEvery(1), resultsOnly(false) {}
+
+	bool match(const std::string& region, const std::string& endpoint, const std::string& host) const;
+};
+typedef std::shared_ptr<const struct SubscriptionFilter> SubscriptionFilterPtr;
+
+/*
+	Forwarded actorStatus/actorResult of a monitorTasks connection.
+	At most window quests are waiting for answers, the others wait in a queue bounded by capacity,
+	so a slow controller holds a bounded memory in CC, instead of FPNN send buffer without limit.
+*/
+class TaskSubscriber: public std::enable_shared_from_this<TaskSubscriber>
+{
+	struct PendingQuest
+	{
+		int taskId;
+		bool status;
+		std::string endpoint;
+		FPQuestPtr quest;
+	};
+
+	std::mutex _mutex;
+	QuestSenderPtr _sender;
+	std::deque<struct PendingQuest> _queue;
+	std::map<std::pair<int, std::string>, uint64_t> _latestStatus;	//-- KeepLatest: (task, endpoint) -> sequence of queued status.
+	uint64_t _frontSequence;		//-- sequence of _queue.front()
+	size_t _maxQueued;
+	int _inflight;
+	bool _closed;
+	double _tokens;				//-- status allowed by maxRate.
+	int64_t _refillMsec;
+	uint64_t _sent;
+	uint64_t _dropped;
+	uint64_t _coalesced;
+	uint64_t _throttled;
+	uint64_t _filtered;
+
+	void popFront(bool dropped);
+	bool takeToken();
+	bool sendLocked(const FPQuestPtr quest);
+	void answered();
+
+public:
+	const int socket;
+	const std::string endpoint;
+	const OverflowPolicy policy;
+	const size_t capacity;
+	const int window;
+	const int maxRate;			//-- status per second. 0: unlimited.
+
+	TaskSubscriber(const ConnectionInfo& ci, QuestSenderPtr sender, OverflowPolicy policy, size_t capacity, int window, int maxRate);
+
+	//-- Returns false when overflowed with Disconnect policy, or already closed.
+	bool post(int taskId, bool status, const std::string& endpoint, const FPQuestPtr quest);
+	void close();
+	//-- Count a message not matched by the subscription filter.
+	void filtered();
+
+	static bool parsePolicy(const std::string& name, OverflowPolicy& policy);
+	static const char* policyName(OverflowPolicy policy);
+
+	static const std::vector<std::string>& fields();
+	void appendRow(std::vector<std::vector<std::string>>& rows, size_t taskCount);
+};
+typedef std::shared_ptr<TaskSubscriber> TaskSubscriberPtr;
+
+struct TaskSubscription
+{
+	TaskSubscriberPtr subscriber;
+	SubscriptionFilterPtr filter;		//-- nullptr: all messages.
+	uint64_t statusCount;				//-- matched status, for sampleEvery. Guarded by ControlCenterQuestProcessor::_mutex.
+
+	TaskSubscription(): statusCount(0) {}
+	TaskSubscription(TaskSubscriberPtr subscriber_, SubscriptionFilterPtr filter_): subscriber(subscriber_), filter(filter_), statusCount(0) {}
+};
+
+#endif
@@ -0,0 +1,364 @@
+#include <set>
+#include <iostream>
+#include <fstream>
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "msgpack.hpp"
+#include "FPWriter.h"
+#include "StringUtil.h"
+#include "../../DATQuestCorpus.h"
+
+using namespace std;
+using namespace fpnn;
+using namespace QuestCorpusFormat;
+
+/*
+	Spec file: one quest per line, fields separated by TAB. Empty lines and lines begin with '#' are ignored.
+
+		weight	method	json-params	[slots]
+
+	weight: non-negative integer, at most 4294967295. 0: never selected in weighted mode.
+
+	slots: comma separated, each slot is one of:
+		name:int
+		name:double
+		name:str:width		(width: 1 - 255)
+
+	Slot must be a top-level param. If json-params doesn't contain it, it will be appended with zero value.
+*/
+
+struct SlotSpec
+{
+	std::string name;
+	uint8_t type;
+	uint8_t width;
+};
+
+class CorpusBuilder
+{
+	std::string _payloads;
+	std::string _stringPool;
+	std::vector<CorpusRecordIndex> _records;
+	std::vector<CorpusSlot> _slots;
+	std::vector<std::string> _slotNames;
+	uint64_t _totalWeight;
+
+	uint16_t slotNameIndex(const std::string& name);
+	bool parseSlots(const std::string& spec, std::vector<SlotSpec>& slots);
+	bool encodePayload(const std::string& json, const std::vector<SlotSpec>& slots, std::string& payload, std::vector<CorpusSlot>& slotPos);
+
+public:
+	CorpusBuilder(): _totalWeight(0) {}
+
+	bool addRecord(const std::string& line, int lineNo);
+	bool save(const std::string& path);
+	size_t count() { return _records.size(); }
+};
+
+uint16_t CorpusBuilder::slotNameIndex(const std::string& name)
+{
+	for (size_t i = 0; i < _slotNames.size(); i++)
+		if (_slotNames[i] == name)
+			return (uint16_t)i;
+
+	_slotNames.push_back(name);
+	return (uint16_t)(_slotNames.size() - 1);
+}
+
+bool CorpusBuilder::parseSlots(const std::string& spec, std::vector<SlotSpec>& slots)
+{
+	std::vector<std::string> items;
+	StringUtil::split(spec, ",", items);
+
+	for (auto& item: items)
+	{
+		std::vector<std::string> parts;
+		StringUtil::split(item, ":", parts);
+		if (parts.size() < 2)
+			return false;
+
+		SlotSpec slot;
+		slot.name = StringUtil::trim(parts[0]);
+		slot.width = 0;
+
+		std::string type = StringUtil::trim(parts[1]);
+		if (type == "int")
+			slot.type = IntSlot;
+		else if (type == "double")
+			slot.type = DoubleSlot;
+		else if (type == "str" && parts.size() == 3)
+		{
+			int width = atoi(parts[2].c_str());
+			if (width <= 0 || width > 255)
+				return false;
+
+			slot.type = StringSlot;
+			slot.width = (uint8_t)width;
+		}
+		else
+			return false;
+
+		slots.push_back(slot);
+	}
+	return true;
+}
+
+bool CorpusBuilder::encodePayload(const std::string& json, const std::vector<SlotSpec>& slots,
+	std::string& payload, std::vector<CorpusSlot>& slotPos)
+{
+	FPWriter pw(json);
+	std::string raw = pw.raw();
+
+	msgpack::object_handle oh = msgpack::unpack(raw.data(), raw.size());
+	const msgpack::object& obj = oh.get();
+	if (obj.type != msgpack::type::MAP)
+		return false;
+
+	std::set<std::string> pendingSlots;
+	for (auto& slot: slots)
+		pendingSlots.insert(slot.name);
+
+	for (uint32_t i = 0; i < obj.via.map.size; i++)
+		if (obj.via.map.ptr[i].key.type == msgpack::type::STR)
+			pendingSlots.erase(obj.via.map.ptr[i].key.as<std::string>());
+
+	msgpack::sbuffer sbuf;
+	msgpack::packer<msgpack::sbuffer> pk(sbuf);
+	pk.pack_map(obj.via.map.size + (uint32_t)pendingSlots.size());
+
+	auto packSlot = [&](const SlotSpec& slot) {
+		char buf[2 + 255];
+		size_t len = slotEncodedLength(slot.type, slot.width);
+
+		if (slot.type == IntSlot)
+			encodeIntSlot(buf, 0);
+		else if (slot.type == DoubleSlot)
+			encodeDoubleSlot(buf, 0);
+		else
+			encodeStringSlot(buf, slot.width, "", 0);
+
+		CorpusSlot cs;
+		cs.payloadPos = (uint32_t)sbuf.size();
+		cs.nameIdx = slotNameIndex(slot.name);
+		cs.type = slot.type;
+		cs.width = slot.width;
+		slotPos.push_back(cs);
+
+		sbuf.write(buf, len);
+	};
+
+	for (uint32_t i = 0; i < obj.via.map.size; i++)
+	{
+		const msgpack::object_kv& kv = obj.via.map.ptr[i];
+		pk.pack(kv.key);
+
+		const SlotSpec* slot = NULL;
+		if (kv.key.type == msgpack::type::STR)
+		{
+			std::string key = kv.key.as<std::string>();
+			for (auto& spec: slots)
+				if (spec.name == key)
+				{
+					slot = &spec;
+					break;
+				}
+		}
+
+		if (slot == NULL)
+		{
+			pk.pack(kv.val);
+			continue;
+		}
+
+		packSlot(*slot);
+	}
+
+	for (auto& spec: slots)
+		if (pendingSlots.find(spec.name) != pendingSlots.end())
+		{
+			pk.pack(spec.name);
+			packSlot(spec);
+		}
+
+	payload.assign(sbuf.data(), sbuf.size());
+	return true;
+}
+
+bool CorpusBuilder::addRecord(const std::string& line, int lineNo)
+{
+	std::vector<std::string> fields;
+	StringUtil::split(line, "\t", fields);
+	if (fields.size() < 3 || fields.size() > 4)
+	{
+		cout<<"[Error] Line "<<lineNo<<": require 3 or 4 TAB separated fields."<<endl;
+		return false;
+	}
+
+	const char* weightBegin = fields[0].c_str();
+	char* weightEnd = NULL;
+	errno = 0;
+	long weight = strtol(weightBegin, &weightEnd, 10);
+	if (weightEnd == weightBegin || *weightEnd != '\0' || errno == ERANGE || weight < 0 || (unsigned long)weight > UINT32_MAX)
+	{
+		cout<<"[Error] Line "<<lineNo<<": invalid weight "<<fields[0]<<"."<<endl;
+		return false;
+	}
+
+	std::vector<SlotSpec> slots;
+	if (fields.size() == 4 && !parseSlots(fields[3], slots))
+	{
+		cout<<"[Error] Line "<<lineNo<<": invalid slots spec."<<endl;
+		return false;
+	}
+
+	std::string payload;
+	std::vector<CorpusSlot> slotPos;
+	try
+	{
+		if (!encodePayload(fields[2], slots, payload, slotPos))
+		{
+			cout<<"[Error] Line "<<lineNo<<": params must be a json object."<<endl;
+			return false;
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		cout<<"[Error] Line "<<lineNo<<": invalid json params. "<<ex.what()<<endl;
+		return false;
+	}
+
+	CorpusRecordIndex record;
+	memset(&record, 0, sizeof(record));
+
+	record.weight = (uint32_t)weight;
+	record.payloadOffset = _payloads.length();
+	record.payloadLength = (uint32_t)payload.length();
+	record.methodOffset = _stringPool.length();
+	record.methodLength = (uint32_t)fields[1].length();
+	record.slotBegin = (uint32_t)_slots.size();
+	record.slotCount = (uint32_t)slotPos.size();
+
+	_payloads.append(payload);
+	_stringPool.append(fields[1]);
+	_slots.insert(_slots.end(), slotPos.begin(), slotPos.end());
+	_records.push_back(record);
+	_totalWeight += record.weight;
+
+	return true;
+}
+
+bool CorpusBuilder::save(const std::string& path)
+{
+	std::vector<CorpusSlotName> slotNames;
+	for (auto& name: _slotNames)
+	{
+		CorpusSlotName sn;
+		sn.offset = _stringPool.length();
+		sn.length = (uint32_t)name.length();
+		sn.reserved = 0;
+		slotNames.push_back(sn);
+
+		_stringPool.append(name);
+	}
+
+	const uint64_t payloadBase = sizeof(CorpusFileHeader);
+	const uint64_t stringPoolBase = payloadBase + _payloads.length();
+	uint64_t indexOffset = stringPoolBase + _stringPool.length();
+	size_t padding = (8 - indexOffset % 8) % 8;
+	indexOffset += padding;
+
+	for (auto& record: _records)
+	{
+		record.payloadOffset += payloadBase;
+		record.methodOffset += stringPoolBase;
+	}
+	for (auto& sn: slotNames)
+		sn.offset += stringPoolBase;
+
+	CorpusFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.recordCount = (uint32_t)_records.size();
+	header.slotCount = (uint32_t)_slots.size();
+	header.slotNameCount = (uint32_t)slotNames.size();
+	header.recordIndexOffset = indexOffset;
+	header.slotOffset = header.recordIndexOffset + _records.size() * sizeof(CorpusRecordIndex);
+	header.slotNameOffset = header.slotOffset + _slots.size() * sizeof(CorpusSlot);
+	header.totalWeight = _totalWeight;
+
+	std::string content((const char*)&header, sizeof(header));
+	content.append(_payloads);
+	content.append(_stringPool);
+	content.append(padding, '\0');
+	content.append((const char*)_records.data(), _records.size() * sizeof(CorpusRecordIndex));
+	content.append((const char*)_slots.data(), _slots.size() * sizeof(CorpusSlot));
+	content.append((const char*)slotNames.data(), slotNames.size() * sizeof(CorpusSlotName));
+
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (fd == -1)
+		return false;
+
+	size_t offset = 0;
+	while (offset < content.length())
+	{
+		ssize_t bytes = write(fd, content.data() + offset, content.length() - offset);
+		if (bytes < 0)
+		{
+			close(fd);
+			return false;
+		}
+		offset += (size_t)bytes;
+	}
+
+	close(fd);
+	return true;
+}
+
+int main(int argc, const char* argv[])
+{
+	if (argc != 3)
+	{
+		cout<<"Usage: "<<argv[0]<<" spec-file corpus-file"<<endl;
+		return 0;
+	}
+
+	std::ifstream fin(argv[1]);
+	if (!fin.is_open())
+	{
+		cout<<"[Error] Open spec file "<<argv[1]<<" failed."<<endl;
+		return -1;
+	}
+
+	CorpusBuilder builder;
+	std::string line;
+	int lineNo = 0;
+	while (std::getline(fin, line))
+	{
+		lineNo += 1;
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		if (!builder.addRecord(line, lineNo))
+			return -1;
+	}
+
+	if (builder.count() == 0)
+	{
+		cout<<"[Error] No quest in spec file."<<endl;
+		return -1;
+	}
+
+	if (!builder.save(argv[2]))
+	{
+		cout<<"[Error] Write corpus file "<<argv[2]<<" failed."<<endl;
+		return -1;
+	}
+
+	cout<<"Corpus "<<argv[2]<<" built. "<<builder.count()<<" quest(s)."<<endl;
+	return 0;
+}
@@ -66,6 +66,33 @@ void showMachineStatus(TCPClientPtr client)
 	}
 }
 
+void showActorCgroups(TCPClientPtr client)
+{
+	FPAnswerPtr answer = client->sendQuest(FPQWriter::emptyQuest("actorCgroups"));
+	FPAReader ar(answer);
+	if (ar.status())
+		return;
+
+	std::vector<std::string> fields = ar.want("fields", std::vector<std::string>());
+	std::vector<std::vector<std::string>> rows = ar.want("rows", std::vector<std::vector<std::string>>());
+	if (rows.empty())
+		return;
+
+	int memIdx = findIndex("memory", fields);
+	int anonIdx = findIndex("anon", fields);
+	int fileIdx = findIndex("file", fields);
+
+	for (auto& row: rows)
+	{
+		row[memIdx] = formatBytesQuantity(atoll(row[memIdx].c_str()), 2);
+		row[anonIdx] = formatBytesQuantity(atoll(row[anonIdx].c_str()), 2);
+		row[fileIdx] = formatBytesQuantity(atoll(row[fileIdx].c_str()), 2);
+	}
+
+	cout<<endl;
+	printTable(fields, rows);
+}
+
 bool openMonitor(TCPClientPtr client)
 {
 	FPQWriter qw(1, "monitorMachineStatus");
@@ -100,6 +127,7 @@ int main(int argc, const char* argv[])
 	while (true)
 	{
 		showMachineStatus(client);
+		showActorCgroups(client);
 		cout<<endl;
 		sleep(2);
 	}
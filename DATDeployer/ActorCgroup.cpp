@@ -0,0 +1,170 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <iostream>
+#include "ActorCgroup.h"
+
+using namespace std;
+
+const char* gc_cgroup2Mount = "/sys/fs/cgroup";
+const char* gc_actorCgroupSlice = "DATActors";
+
+//-- Set up on the first isolated launch, so deployers which never isolate actors leave the cgroup hierarchy untouched.
+bool ActorCgroups::prepare()
+{
+	if (_prepared)
+		return _available;
+
+	_prepared = true;
+
+	std::string controllers(gc_cgroup2Mount);
+	controllers.append("/cgroup.controllers");
+	if (access(controllers.c_str(), R_OK) != 0)
+		return false;
+
+	_root.assign(gc_cgroup2Mount).append("/").append(gc_actorCgroupSlice);
+	if (mkdir(_root.c_str(), 0755) != 0 && errno != EEXIST)
+	{
+		cout<<"[Error] Create cgroup "<<_root<<" failed. errno: "<<errno<<". Fall back to rlimits."<<endl;
+		return false;
+	}
+
+	//-- Controllers must be enabled in every ancestor's subtree_control. Failures are tolerated: limits which
+	//-- cannot be applied are reported by create().
+	std::string rootSubtree(gc_cgroup2Mount);
+	writeFile(rootSubtree.append("/cgroup.subtree_control"), "+cpu +memory +io");
+	writeFile(_root + "/cgroup.subtree_control", "+cpu +memory +io");
+
+	_available = true;
+	return true;
+}
+
+bool ActorCgroups::writeFile(const std::string& path, const std::string& content)
+{
+	int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	ssize_t rev = write(fd, content.data(), content.size());
+	close(fd);
+	return (rev == (ssize_t)content.size());
+}
+
+std::string ActorCgroups::create(const std::string& actor, const CgroupLimits& limits)
+{
+	if (!prepare())
+		return std::string();
+
+	std::string path(_root);
+	path.append("/").append(actor).append("-").append(std::to_string(getpid())).append("-").append(std::to_string(_seq++));
+	if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+	{
+		cout<<"[Error] Create cgroup "<<path<<" failed. errno: "<<errno<<endl;
+		return std::string();
+	}
+
+	bool ok = true;
+	if (limits.cpuQuota > 0)
+		ok &= writeFile(path + "/cpu.max", std::to_string(limits.cpuQuota * 1000).append(" 100000"));
+
+	if (limits.cpuWeight > 0)
+		ok &= writeFile(path + "/cpu.weight", std::to_string(limits.cpuWeight));
+
+	if (limits.memoryMax > 0)
+		ok &= writeFile(path + "/memory.max", std::to_string(limits.memoryMax));
+
+	for (auto& line: limits.ioMax)
+		ok &= writeFile(path + "/io.max", line);
+
+	if (!ok)
+	{
+		cout<<"[Error] Apply limits on cgroup "<<path<<" failed. Fall back to rlimits."<<endl;
+		rmdir(path.c_str());
+		return std::string();
+	}
+
+	return path;
+}
+
+void ActorCgroups::remove(const std::string& path)
+{
+	if (path.size() && rmdir(path.c_str()) != 0)
+		cout<<"[Error] Remove cgroup "<<path<<" failed. errno: "<<errno<<endl;
+}
+
+static bool readSmallFile(const std::string& path, char* buf, size_t size)
+{
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	ssize_t len = read(fd, buf, size - 1);
+	close(fd);
+	if (len < 0)
+		return false;
+
+	buf[len] = '\0';
+	return true;
+}
+
+//-- Parse "key value\n" lines. keys & targets are paired.
+static void parseKeyedFile(const char* buf, const char* const* keys, uint64_t** targets, int count)
+{
+	const char* line = buf;
+	while (*line)
+	{
+		const char* space = strchr(line, ' ');
+		const char* end = strchr(line, '\n');
+		if (end == NULL)
+			end = line + strlen(line);
+
+		if (space && space < end)
+		{
+			size_t keyLen = space - line;
+			for (int i = 0; i < count; i++)
+				if (strlen(keys[i]) == keyLen && strncmp(line, keys[i], keyLen) == 0)
+				{
+					*targets[i] = strtoull(space + 1, NULL, 10);
+					break;
+				}
+		}
+
+		line = (*end) ? end + 1 : end;
+	}
+}
+
+bool ActorCgroups::readStat(const std::string& path, struct CgroupStat& stat)
+{
+	char buf[8192];
+
+	if (!readSmallFile(path + "/cpu.stat", buf, sizeof(buf)))
+		return false;
+	{
+		const char* keys[] = {"usage_usec", "nr_periods", "nr_throttled", "throttled_usec"};
+		uint64_t* targets[] = {&stat.usageUsec, &stat.nrPeriods, &stat.nrThrottled, &stat.throttledUsec};
+		parseKeyedFile(buf, keys, targets, 4);
+	}
+
+	if (readSmallFile(path + "/memory.current", buf, sizeof(buf)))
+		stat.memoryCurrent = strtoull(buf, NULL, 10);
+
+	if (readSmallFile(path + "/memory.stat", buf, sizeof(buf)))
+	{
+		const char* keys[] = {"anon", "file"};
+		uint64_t* targets[] = {&stat.anonBytes, &stat.fileBytes};
+		parseKeyedFile(buf, keys, targets, 2);
+	}
+
+	if (readSmallFile(path + "/memory.events", buf, sizeof(buf)))
+	{
+		const char* keys[] = {"high", "max", "oom_kill"};
+		uint64_t* targets[] = {&stat.memoryHighEvents, &stat.memoryMaxEvents, &stat.oomKills};
+		parseKeyedFile(buf, keys, targets, 3);
+	}
+
+	return true;
+}
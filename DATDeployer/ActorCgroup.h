@@ -0,0 +1,62 @@
+#ifndef DAT_Actor_Cgroup_h
+#define DAT_Actor_Cgroup_h
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct CgroupLimits
+{
+	int cpuQuota;					//-- percent of one CPU. 0: unlimited.
+	int cpuWeight;					//-- 1 ~ 10000, cgroup default 100. 0: not set.
+	int64_t memoryMax;				//-- bytes. 0: unlimited.
+	std::vector<std::string> ioMax;	//-- io.max lines, e.g. "8:0 rbps=104857600 wbps=52428800"
+
+	CgroupLimits(): cpuQuota(0), cpuWeight(0), memoryMax(0) {}
+};
+
+struct CgroupStat
+{
+	uint64_t usageUsec;
+	uint64_t nrPeriods;
+	uint64_t nrThrottled;
+	uint64_t throttledUsec;
+	uint64_t memoryCurrent;
+	uint64_t anonBytes;
+	uint64_t fileBytes;
+	uint64_t memoryHighEvents;
+	uint64_t memoryMaxEvents;
+	uint64_t oomKills;
+
+	CgroupStat(): usageUsec(0), nrPeriods(0), nrThrottled(0), throttledUsec(0), memoryCurrent(0), anonBytes(0), fileBytes(0),
+		memoryHighEvents(0), memoryMaxEvents(0), oomKills(0) {}
+};
+
+/*
+	cgroup v2 slices for launched actors: <cgroup2 mount>/DATActors/<actor>-<seq>.
+	If cgroup v2 is unavailable (not mounted, no permission, controllers not delegated), create() returns empty path,
+	and launcher falls back to rlimits.
+	The slice is created by the first create(). Not thread safe: used under ActorLauncher::_mutex.
+*/
+class ActorCgroups
+{
+	std::string _root;
+	bool _prepared;
+	bool _available;
+	int _seq;
+
+	bool prepare();
+	static bool writeFile(const std::string& path, const std::string& content);
+
+public:
+	ActorCgroups(): _prepared(false), _available(false), _seq(0) {}
+
+	//-- false until the first create().
+	bool available() const { return _available; }
+	std::string create(const std::string& actor, const CgroupLimits& limits);
+	void remove(const std::string& path);
+
+	static bool readStat(const std::string& path, struct CgroupStat& stat);
+};
+
+#endif
@@ -0,0 +1,475 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <sys/signalfd.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <cmath>
+#include <iostream>
+#include "msec.h"
+#include "StringUtil.h"
+#include "ActorLauncher.h"
+
+using namespace std;
+using namespace fpnn;
+
+const int gc_mpolPreferred = 1;		//-- MPOL_PREFERRED in <numaif.h>. Avoid depending on libnuma.
+const int gc_restartBaseDelayMsec = 1000;
+const int gc_restartMaxDelayMsec = 30 * 1000;
+const int64_t gc_restartResetRuntimeMsec = 60 * 1000;		//-- actor ran longer than this is considered healthy, backoff is reset.
+
+void ActorLauncher::blockChildSignal()
+{
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	pthread_sigmask(SIG_BLOCK, &mask, NULL);
+}
+
+bool ActorLauncher::start(ActorLifecycleReporter reporter)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	if (_running)
+		return true;
+
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+
+	_signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (_signalFd < 0)
+	{
+		cout<<"[Error] Create signalfd for actor supervisor failed. errno: "<<errno<<endl;
+		return false;
+	}
+
+	_reporter = reporter;
+	_running = true;
+	_supervisorThread = std::thread(&ActorLauncher::superviseCycle, this);
+	return true;
+}
+
+void ActorLauncher::stop()
+{
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		if (!_running)
+			return;
+
+		_running = false;
+	}
+
+	_supervisorThread.join();
+	close(_signalFd);
+	_signalFd = -1;
+}
+
+int ActorLauncher::restartDelay(int restarts)
+{
+	int64_t delay = (int64_t)gc_restartBaseDelayMsec << (restarts < 16 ? restarts : 16);
+	return (delay < gc_restartMaxDelayMsec) ? (int)delay : gc_restartMaxDelayMsec;
+}
+
+std::vector<int> ActorLauncher::availableCPUs()
+{
+	std::vector<int> cpus;
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) == 0)
+	{
+		for (int i = 0; i < CPU_SETSIZE; i++)
+			if (CPU_ISSET(i, &set))
+				cpus.push_back(i);
+	}
+
+	if (cpus.empty())
+	{
+		long count = sysconf(_SC_NPROCESSORS_ONLN);
+		for (long i = 0; i < count; i++)
+			cpus.push_back((int)i);
+	}
+
+	return cpus;
+}
+
+int ActorLauncher::cpuNumaNode(int cpu)
+{
+	std::string path("/sys/devices/system/cpu/cpu");
+	path.append(std::to_string(cpu));
+
+	DIR* dir = opendir(path.c_str());
+	if (dir == NULL)
+		return -1;
+
+	int node = -1;
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9')
+		{
+			node = atoi(entry->d_name + 4);
+			break;
+		}
+	}
+	closedir(dir);
+	return node;
+}
+
+std::vector<std::vector<int>> ActorLauncher::divideCPUs(const std::vector<int>& cpus, int instances)
+{
+	std::vector<std::vector<int>> parts(instances);
+	if (cpus.empty())
+		return parts;
+
+	if ((int)cpus.size() < instances)
+	{
+		//-- Not enough CPUs. Instances have to share.
+		for (int i = 0; i < instances; i++)
+			parts[i].push_back(cpus[i % cpus.size()]);
+
+		return parts;
+	}
+
+	size_t base = cpus.size() / instances;
+	size_t remain = cpus.size() % instances;
+	size_t offset = 0;
+	for (int i = 0; i < instances; i++)
+	{
+		size_t count = base + (((size_t)i < remain) ? 1 : 0);
+		parts[i].assign(cpus.begin() + offset, cpus.begin() + offset + count);
+		offset += count;
+	}
+
+	return parts;
+}
+
+int ActorLauncher::spawn(const struct ChildProcess& child)
+{
+	//-- Prepare all things before fork. Only async-signal-safe functions can be called in child.
+	std::vector<char*> argv;
+	argv.push_back(const_cast<char*>(child.path.c_str()));
+	for (auto& arg: child.args)
+		argv.push_back(const_cast<char*>(arg.c_str()));
+	argv.push_back(NULL);
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu: child.cpus)
+		CPU_SET(cpu, &set);
+
+	int numaNode = child.numaNode;
+	unsigned long nodeMask = (numaNode >= 0 && numaNode < (int)(sizeof(unsigned long) * 8)) ? (1UL << numaNode) : 0;
+
+	struct rlimit rl;
+	int maxFd = 65536;
+	if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY && (int)rl.rlim_cur < maxFd)
+		maxFd = (int)rl.rlim_cur;
+
+	std::string cgroupProcs;
+	if (child.cgroupPath.size())
+		cgroupProcs = child.cgroupPath + "/cgroup.procs";
+
+	//-- rlimit fallback. Kernel cpu weight grows about 1.25 times per nice level.
+	bool fallback = child.isolate && cgroupProcs.empty();
+	struct rlimit memLimit;
+	memLimit.rlim_cur = memLimit.rlim_max = (rlim_t)child.limits.memoryMax;
+	int niceValue = 0;
+	if (fallback && child.limits.cpuWeight > 0)
+	{
+		niceValue = (int)std::lround(std::log(100.0 / child.limits.cpuWeight) / std::log(1.25));
+		niceValue = (niceValue < -20) ? -20 : ((niceValue > 19) ? 19 : niceValue);
+	}
+
+	sigset_t emptyMask;
+	sigemptyset(&emptyMask);
+
+	pid_t pid = fork();
+	if (pid != 0)
+		return (int)pid;
+
+	//-- child
+	sigprocmask(SIG_SETMASK, &emptyMask, NULL);
+	setsid();
+
+	if (cgroupProcs.size())
+	{
+		//-- "0" means the writing process itself. Join cgroup before exec, so all actor's threads & memory are accounted.
+		int fd = open(cgroupProcs.c_str(), O_WRONLY);
+		if (fd < 0 || write(fd, "0", 1) != 1)
+			fallback = true;
+		if (fd >= 0)
+			close(fd);
+	}
+
+	if (fallback)
+	{
+		if (child.limits.memoryMax > 0)
+			setrlimit(RLIMIT_AS, &memLimit);
+		if (niceValue)
+			setpriority(PRIO_PROCESS, 0, niceValue);
+	}
+
+	if (child.cpus.size())
+		sched_setaffinity(0, sizeof(set), &set);
+
+	if (nodeMask)
+		syscall(SYS_set_mempolicy, gc_mpolPreferred, &nodeMask, sizeof(nodeMask) * 8);
+
+	//-- Don't leak deployer's connections and epoll fds into actor.
+	for (int fd = 3; fd < maxFd; fd++)
+		close(fd);
+
+	execv(child.path.c_str(), argv.data());
+	_exit(127);
+}
+
+bool ActorLauncher::launch(const std::string& actor, const std::string& path, const std::string& cmdLine,
+	const LaunchOptions& options, std::vector<int>& pids)
+{
+	if (options.instances > maxInstances)
+	{
+		cout<<"[Error] Launch actor "<<actor<<" failed. Too many instances: "<<options.instances<<endl;
+		return false;
+	}
+
+	std::vector<std::string> baseArgs;
+	StringUtil::split(cmdLine, " \t", baseArgs);
+
+	int instances = (options.instances > 0) ? options.instances : 1;
+	bool pinning = (instances > 1 || options.cpuSet.size());
+
+	std::vector<std::vector<int>> cpuParts(instances);
+	if (pinning)
+		cpuParts = divideCPUs(options.cpuSet.size() ? options.cpuSet : availableCPUs(), instances);
+
+	bool allOk = true;
+	for (int i = 0; i < instances; i++)
+	{
+		struct ChildProcess child;
+		child.actor = actor;
+		child.path = path;
+		child.args = baseArgs;
+		child.cpus = cpuParts[i];
+		child.numaNode = -1;
+		child.restart = options.restart;
+		child.maxRestarts = options.maxRestarts;
+		child.restarts = 0;
+		child.isolate = options.isolate;
+		child.limits = options.limits;
+
+		if ((size_t)i < options.perInstanceArgs.size())
+			StringUtil::split(options.perInstanceArgs[i], " \t", child.args);
+
+		if (options.numaLocal && child.cpus.size())
+			child.numaNode = cpuNumaNode(child.cpus[0]);
+
+		//-- Hold the lock across fork, so that supervisor cannot reap the child before it is recorded.
+		std::unique_lock<std::mutex> lck(_mutex);
+		if (child.isolate)
+			child.cgroupPath = _cgroups.create(actor, child.limits);
+
+		int pid = spawn(child);
+		if (pid < 0)
+		{
+			cout<<"[Error] Launch actor "<<actor<<" instance "<<i<<" failed. errno: "<<errno<<endl;
+			_cgroups.remove(child.cgroupPath);
+			allOk = false;
+			continue;
+		}
+
+		child.startMsec = slack_mono_msec();
+		_children[pid] = child;
+		pids.push_back(pid);
+	}
+
+	return allOk;
+}
+
+void ActorLauncher::report(const struct ActorLifecycleEvent& event)
+{
+	if (event.event == "exited")
+		cout<<"[Info] Actor "<<event.actor<<" pid "<<event.pid<<" exited. code: "<<event.exitCode<<", signal: "<<event.signal
+			<<", runtime: "<<event.runtimeMsec<<" ms, restart in "<<event.restartDelayMsec<<" ms."<<endl;
+
+	if (_reporter)
+		_reporter(event);
+}
+
+void ActorLauncher::superviseCycle()
+{
+	struct pollfd pfd;
+	pfd.fd = _signalFd;
+	pfd.events = POLLIN;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lck(_mutex);
+			if (!_running)
+				return;
+		}
+
+		pfd.revents = 0;
+		int rev = poll(&pfd, 1, 200);
+		if (rev > 0 && (pfd.revents & POLLIN))
+		{
+			//-- SIGCHLDs are merged. Drain all, then check every known child.
+			struct signalfd_siginfo info[16];
+			while (read(_signalFd, info, sizeof(info)) > 0)
+				continue;
+		}
+
+		reapChildren();
+		restartDueChildren();
+	}
+}
+
+void ActorLauncher::reapChildren()
+{
+	std::vector<struct ActorLifecycleEvent> events;
+	int64_t now = slack_mono_msec();
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		for (auto it = _children.begin(); it != _children.end(); )
+		{
+			int status;
+			struct rusage usage;
+			if (wait4(it->first, &status, WNOHANG, &usage) != it->first)
+			{
+				++it;
+				continue;
+			}
+
+			struct ActorLifecycleEvent event;
+			event.event = "exited";
+			event.actor = it->second.actor;
+			event.pid = it->first;
+			event.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+			event.signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+			event.runtimeMsec = now - it->second.startMsec;
+			event.utimeMsec = usage.ru_utime.tv_sec * 1000 + usage.ru_utime.tv_usec / 1000;
+			event.stimeMsec = usage.ru_stime.tv_sec * 1000 + usage.ru_stime.tv_usec / 1000;
+			event.maxRSSKB = usage.ru_maxrss;
+
+			struct ChildProcess& child = it->second;
+			if (event.runtimeMsec >= gc_restartResetRuntimeMsec)
+				child.restarts = 0;
+
+			bool cleanExit = (event.exitCode == 0 && event.signal == 0);
+			if (child.restart && !cleanExit && (child.maxRestarts < 0 || child.restarts < child.maxRestarts))
+			{
+				struct PendingRestart pending;
+				pending.prevPid = it->first;
+				pending.dueMsec = now + restartDelay(child.restarts);
+				pending.child = child;
+				pending.child.restarts += 1;
+
+				event.restartDelayMsec = (int)(pending.dueMsec - now);
+				_pendingRestarts.push_back(pending);
+			}
+			else
+				_cgroups.remove(child.cgroupPath);
+			event.restarts = child.restarts;
+
+			events.push_back(event);
+			it = _children.erase(it);
+		}
+	}
+
+	for (auto& event: events)
+		report(event);
+}
+
+void ActorLauncher::restartDueChildren()
+{
+	std::vector<struct ActorLifecycleEvent> events;
+	int64_t now = slack_mono_msec();
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		for (size_t i = 0; i < _pendingRestarts.size(); )
+		{
+			struct PendingRestart& pending = _pendingRestarts[i];
+			if (pending.dueMsec > now)
+			{
+				i++;
+				continue;
+			}
+
+			struct ActorLifecycleEvent event;
+			event.actor = pending.child.actor;
+			event.prevPid = pending.prevPid;
+			event.restarts = pending.child.restarts;
+
+			int pid = spawn(pending.child);
+			if (pid < 0)
+			{
+				cout<<"[Error] Restart actor "<<pending.child.actor<<" (previous pid "<<pending.prevPid<<") failed. errno: "<<errno<<endl;
+				event.event = "restartFailed";
+				_cgroups.remove(pending.child.cgroupPath);
+			}
+			else
+			{
+				event.event = "restarted";
+				event.pid = pid;
+				pending.child.startMsec = now;
+				_children[pid] = pending.child;
+			}
+
+			events.push_back(event);
+			_pendingRestarts[i] = _pendingRestarts.back();
+			_pendingRestarts.pop_back();
+		}
+	}
+
+	for (auto& event: events)
+		report(event);
+}
+
+void ActorLauncher::isolationStatus(std::vector<std::vector<std::string>>& rows)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	for (auto& pp: _children)
+	{
+		if (!pp.second.isolate)
+			continue;
+
+		struct CgroupStat stat;
+		bool cgroup = pp.second.cgroupPath.size() && ActorCgroups::readStat(pp.second.cgroupPath, stat);
+
+		rows.push_back(std::vector<std::string>());
+		std::vector<std::string>& row = rows.back();
+
+		row.push_back(pp.second.actor);
+		row.push_back(std::to_string(pp.first));
+		row.push_back(cgroup ? "cgroup" : "rlimit");
+		row.push_back(std::to_string(stat.usageUsec));
+		row.push_back(std::to_string(stat.nrPeriods));
+		row.push_back(std::to_string(stat.nrThrottled));
+		row.push_back(std::to_string(stat.throttledUsec));
+		row.push_back(std::to_string(stat.memoryCurrent));
+		row.push_back(std::to_string(stat.anonBytes));
+		row.push_back(std::to_string(stat.fileBytes));
+		row.push_back(std::to_string(stat.memoryHighEvents));
+		row.push_back(std::to_string(stat.memoryMaxEvents));
+		row.push_back(std::to_string(stat.oomKills));
+	}
+}
+
+void ActorLauncher::launchedActors(std::map<int, std::string>& actors)
+{
+	std::unique_lock<std::mutex> lck(_mutex);
+	for (auto& pp: _children)
+		actors[pp.first] = pp.second.actor;
+}
@@ -0,0 +1,125 @@
+#ifndef DAT_Actor_Launcher_h
+#define DAT_Actor_Launcher_h
+
+#include <mutex>
+#include <map>
+#include <string>
+#include <vector>
+#include <thread>
+#include <functional>
+#include "ActorCgroup.h"
+
+struct LaunchOptions
+{
+	int instances;
+	bool numaLocal;
+	std::vector<int> cpuSet;						//-- empty: all CPUs which deployer can run on.
+	std::vector<std::string> perInstanceArgs;		//-- appended to instance i's command line.
+	bool restart;									//-- restart instance with backoff when it exited.
+	int maxRestarts;								//-- < 0: unlimited.
+	bool isolate;									//-- put each instance into its own cgroup with limits.
+	struct CgroupLimits limits;
+
+	LaunchOptions(): instances(1), numaLocal(false), restart(false), maxRestarts(5), isolate(false) {}
+};
+
+struct ActorLifecycleEvent
+{
+	std::string event;		//-- "exited", "restarted", "restartFailed"
+	std::string actor;
+	int pid;
+	int prevPid;			//-- for "restarted".
+	int exitCode;			//-- -1 if killed by signal.
+	int signal;
+	int64_t runtimeMsec;
+	int64_t utimeMsec;
+	int64_t stimeMsec;
+	int64_t maxRSSKB;
+	int restarts;
+	int restartDelayMsec;	//-- for "exited": 0 means won't be restarted.
+
+	ActorLifecycleEvent(): pid(0), prevPid(0), exitCode(0), signal(0), runtimeMsec(0), utimeMsec(0), stimeMsec(0),
+		maxRSSKB(0), restarts(0), restartDelayMsec(0) {}
+};
+
+typedef std::function<void (const struct ActorLifecycleEvent&)> ActorLifecycleReporter;
+
+/*
+	Launch actors by fork/exec directly, without shell.
+	When launching multiple instances, cpu set is divided into disjoint parts, and each instance is pinned on one part.
+	Isolated instances are placed into their own cgroup v2 slices; if cgroup is unavailable, memory limit falls back to
+	RLIMIT_AS, and cpu weight falls back to nice value. cpu quota & io limits have no fallback.
+
+	Launched actors are supervised as children: SIGCHLD is consumed by signalfd in the supervisor thread,
+	and only the launched pids are reaped by wait4(), so system() called by other threads is not disturbed.
+	SIGCHLD MUST be blocked in all threads before any thread created. (Call blockChildSignal() at the beginning of main().)
+*/
+class ActorLauncher
+{
+	struct ChildProcess
+	{
+		std::string actor;
+		std::string path;
+		std::vector<std::string> args;
+		std::vector<int> cpus;
+		int numaNode;
+		bool restart;
+		int maxRestarts;
+		int restarts;
+		int64_t startMsec;
+		bool isolate;
+		struct CgroupLimits limits;
+		std::string cgroupPath;
+	};
+
+	struct PendingRestart
+	{
+		int prevPid;
+		int64_t dueMsec;
+		struct ChildProcess child;
+	};
+
+	std::mutex _mutex;
+	std::map<int, struct ChildProcess> _children;		//-- map<pid, child>
+	std::vector<struct PendingRestart> _pendingRestarts;
+	ActorCgroups _cgroups;
+
+	int _signalFd;
+	bool _running;
+	std::thread _supervisorThread;
+	ActorLifecycleReporter _reporter;
+
+	static std::vector<int> availableCPUs();
+	static int cpuNumaNode(int cpu);
+	static std::vector<std::vector<int>> divideCPUs(const std::vector<int>& cpus, int instances);
+	static int restartDelay(int restarts);
+
+	int spawn(const struct ChildProcess& child);
+	void superviseCycle();
+	void reapChildren();
+	void restartDueChildren();
+	void report(const struct ActorLifecycleEvent& event);
+
+public:
+	static const int maxInstances = 256;
+
+	ActorLauncher(): _signalFd(-1), _running(false) {}
+	~ActorLauncher() { stop(); }
+
+	static void blockChildSignal();
+
+	bool start(ActorLifecycleReporter reporter);
+	void stop();
+
+	bool launch(const std::string& actor, const std::string& path, const std::string& cmdLine,
+		const LaunchOptions& options, std::vector<int>& pids);
+
+	//-- row: actor, pid, isolation ("cgroup", "rlimit"), usageUsec, nrPeriods, nrThrottled, throttledUsec,
+	//--	memoryCurrent, anon, file, memoryHighEvents, memoryMaxEvents, oomKills
+	void isolationStatus(std::vector<std::vector<std::string>>& rows);
+
+	//-- map<pid, actor name> of running launched actors.
+	void launchedActors(std::map<int, std::string>& actors);
+};
+
+#endif
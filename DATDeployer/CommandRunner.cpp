@@ -0,0 +1,222 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <spawn.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <list>
+#include <iostream>
+#include "msec.h"
+#include "CommandRunner.h"
+
+extern char **environ;
+
+using namespace std;
+using namespace fpnn;
+
+const size_t gc_commandOutputChunkSize = 16 * 1024;
+
+struct RunningCommand
+{
+	size_t idx;
+	pid_t pid;
+	int fds[2];			//-- 0: stdout, 1: stderr
+	int64_t startMsec;
+	int64_t deadlineMsec;
+};
+
+static pid_t spawnCommand(const std::string& cmdLine, int& outFd, int& errFd)
+{
+	int outPipe[2], errPipe[2];
+	if (pipe2(outPipe, O_CLOEXEC | O_NONBLOCK) != 0)
+		return -1;
+
+	if (pipe2(errPipe, O_CLOEXEC | O_NONBLOCK) != 0)
+	{
+		close(outPipe[0]);
+		close(outPipe[1]);
+		return -1;
+	}
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+	posix_spawn_file_actions_adddup2(&actions, outPipe[1], 1);
+	posix_spawn_file_actions_adddup2(&actions, errPipe[1], 2);
+
+	//-- Deployer blocks SIGCHLD for the actor supervisor. Commands run with an empty mask in their own process group,
+	//-- so that timeout can kill the whole pipeline.
+	sigset_t emptyMask;
+	sigemptyset(&emptyMask);
+
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setsigmask(&attr, &emptyMask);
+	posix_spawnattr_setpgroup(&attr, 0);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETPGROUP);
+
+	char* argv[] = { const_cast<char*>("/bin/sh"), const_cast<char*>("-c"), const_cast<char*>(cmdLine.c_str()), NULL };
+
+	pid_t pid;
+	int rev = posix_spawn(&pid, "/bin/sh", &actions, &attr, argv, environ);
+
+	posix_spawnattr_destroy(&attr);
+	posix_spawn_file_actions_destroy(&actions);
+	close(outPipe[1]);
+	close(errPipe[1]);
+
+	if (rev != 0)
+	{
+		close(outPipe[0]);
+		close(errPipe[0]);
+		errno = rev;
+		return -1;
+	}
+
+	outFd = outPipe[0];
+	errFd = errPipe[0];
+	return pid;
+}
+
+//-- return false when fd reaches EOF or error.
+static bool drainOutput(struct RunningCommand& cmd, int which, char* buf, CommandOutputCallback& outputCallback)
+{
+	while (true)
+	{
+		ssize_t len = read(cmd.fds[which], buf, gc_commandOutputChunkSize);
+		if (len > 0)
+		{
+			if (outputCallback)
+				outputCallback(cmd.idx, which == 1, buf, (size_t)len);
+			continue;
+		}
+
+		if (len < 0 && (errno == EAGAIN || errno == EINTR))
+			return true;
+
+		close(cmd.fds[which]);
+		cmd.fds[which] = -1;
+		return false;
+	}
+}
+
+bool CommandRunner::run(const std::vector<std::string>& cmdLines, int parallel, int timeoutSec,
+	CommandOutputCallback outputCallback, std::vector<struct CommandResult>& results)
+{
+	bool sequential = (parallel <= 1);
+	if (sequential)
+		parallel = 1;
+
+	results.clear();
+	results.resize(cmdLines.size());
+
+	std::vector<char> buffer(gc_commandOutputChunkSize);
+	std::list<struct RunningCommand> running;
+	size_t next = 0;
+	bool stop = false;
+	bool allOk = true;
+
+	while (true)
+	{
+		while (!stop && next < cmdLines.size() && (int)running.size() < parallel)
+		{
+			struct RunningCommand cmd;
+			cmd.idx = next++;
+			cmd.startMsec = slack_mono_msec();
+			cmd.deadlineMsec = (timeoutSec > 0) ? cmd.startMsec + timeoutSec * 1000 : 0;
+			cmd.pid = spawnCommand(cmdLines[cmd.idx], cmd.fds[0], cmd.fds[1]);
+			if (cmd.pid < 0)
+			{
+				cout<<"[Error] Spawn system command "<<cmdLines[cmd.idx]<<" failed. errno: "<<errno<<endl;
+				allOk = false;
+				stop = sequential;
+				continue;
+			}
+
+			results[cmd.idx].started = true;
+			running.push_back(cmd);
+		}
+
+		if (running.empty())
+			break;
+
+		//-- poll outputs
+		std::vector<struct pollfd> pfds;
+		std::vector<std::pair<struct RunningCommand*, int>> owners;
+		int64_t now = slack_mono_msec();
+		int waitMsec = 100;
+		for (auto& cmd: running)
+		{
+			for (int i = 0; i < 2; i++)
+			{
+				if (cmd.fds[i] < 0)
+					continue;
+
+				struct pollfd pfd;
+				pfd.fd = cmd.fds[i];
+				pfd.events = POLLIN;
+				pfd.revents = 0;
+				pfds.push_back(pfd);
+				owners.push_back(std::make_pair(&cmd, i));
+			}
+
+			if (cmd.deadlineMsec && cmd.deadlineMsec - now < waitMsec)
+				waitMsec = (cmd.deadlineMsec > now) ? (int)(cmd.deadlineMsec - now) : 0;
+		}
+
+		if (pfds.size())
+		{
+			if (poll(pfds.data(), pfds.size(), waitMsec) > 0)
+			{
+				for (size_t i = 0; i < pfds.size(); i++)
+					if (pfds[i].revents)
+						drainOutput(*owners[i].first, owners[i].second, buffer.data(), outputCallback);
+			}
+		}
+		else
+			usleep(waitMsec * 1000);
+
+		//-- timeout & reap
+		now = slack_mono_msec();
+		for (auto it = running.begin(); it != running.end(); )
+		{
+			struct CommandResult& result = results[it->idx];
+			if (it->deadlineMsec && now >= it->deadlineMsec && !result.timedOut)
+			{
+				result.timedOut = true;
+				kill(-it->pid, SIGKILL);
+			}
+
+			int status;
+			if (waitpid(it->pid, &status, WNOHANG) != it->pid)
+			{
+				++it;
+				continue;
+			}
+
+			//-- Background processes started by the command may still hold the pipes. Don't wait them.
+			for (int i = 0; i < 2; i++)
+				if (it->fds[i] >= 0 && drainOutput(*it, i, buffer.data(), outputCallback))
+				{
+					close(it->fds[i]);
+					it->fds[i] = -1;
+				}
+
+			result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+			result.signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+			result.costMsec = now - it->startMsec;
+
+			if (result.exitCode != 0 || result.timedOut)
+			{
+				allOk = false;
+				stop = sequential;
+			}
+
+			it = running.erase(it);
+		}
+	}
+
+	return allOk;
+}
@@ -0,0 +1,36 @@
+#ifndef DAT_Command_Runner_h
+#define DAT_Command_Runner_h
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <functional>
+
+struct CommandResult
+{
+	bool started;
+	bool timedOut;
+	int exitCode;			//-- -1 if killed by signal or not started.
+	int signal;
+	int64_t costMsec;
+
+	CommandResult(): started(false), timedOut(false), exitCode(-1), signal(0), costMsec(0) {}
+};
+
+//-- idx: command index, errStream: data comes from stderr.
+typedef std::function<void (size_t idx, bool errStream, const char* data, size_t len)> CommandOutputCallback;
+
+/*
+	Run shell command lines by posix_spawn("/bin/sh -c"), capture stdout & stderr through pipes.
+	parallel <= 1: commands are executed in order, and stop at the first failed command (as the old system() loop).
+	parallel > 1: at most parallel commands are executed at the same time, all commands are executed.
+	timeoutSec > 0: the command's process group is killed when it runs over timeoutSec.
+*/
+class CommandRunner
+{
+public:
+	static bool run(const std::vector<std::string>& cmdLines, int parallel, int timeoutSec,
+		CommandOutputCallback outputCallback, std::vector<struct CommandResult>& results);
+};
+
+#endif
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <iostream>
 #include <unistd.h>
 #include <sys/sysinfo.h>
@@ -24,10 +25,14 @@ class Deployer
 	std::string _cachePath;
 
 	std::shared_ptr<DeployQuestProcessor> _processor;
+	std::atomic<bool> _everRegistered;
 
 	void loadActorCache(std::vector<std::vector<std::string>>& rows);
+	void reportActorLifecycle(const struct ActorLifecycleEvent& event);
 
 public:
+	Deployer(): _everRegistered(false) {}
+
 	bool init(const std::string& endpoint, const std::string& cachePath)
 	{
 		_region = ServerInfo::getServerRegionName();
@@ -39,7 +44,9 @@ public:
 		_cachePath = _processor->cachePath();
 		_client->setQuestProcessor(_processor);
 
-		return true;
+		return _processor->startSupervisor([this](const struct ActorLifecycleEvent& event){
+			reportActorLifecycle(event);
+		});
 	}
 
 	void check()
@@ -48,6 +55,10 @@ public:
 
 		if (!_client->connected())
 		{
+			//-- Keep sampling while disconnected, backfilled after re-registered.
+			if (_everRegistered)
+				_processor->recordOfflineStatus();
+
 			_client->connect();
 			registerDeployer();
 		}
@@ -116,15 +127,44 @@ void Deployer::registerDeployer()
 	qw.param("totalMemories", info.totalram);
 
 	TCPClientPtr client = _client;
-	_client->sendQuest(qw.take(), [client](FPAnswerPtr answer, int errorCode){
+	std::shared_ptr<DeployQuestProcessor> processor = _processor;
+	_client->sendQuest(qw.take(), [this, client, processor](FPAnswerPtr answer, int errorCode){
 		if (errorCode != FPNN_EC_OK)
 		{
 			cout<<"[Error] Register deployer self exception. error code: "<<errorCode<<endl;
 			client->close();
+			return;
 		}
+
+		_everRegistered = true;
+		processor->backfillMachineStatus(client);
 	});
 }
 
+void Deployer::reportActorLifecycle(const struct ActorLifecycleEvent& event)
+{
+	if (!_client->connected())
+		return;
+
+	FPQWriter qw(13, "actorLifecycle", true);
+	qw.param("region", _region);
+	qw.param("event", event.event);
+	qw.param("actor", event.actor);
+	qw.param("pid", event.pid);
+	qw.param("prevPid", event.prevPid);
+	qw.param("exitCode", event.exitCode);
+	qw.param("signal", event.signal);
+	qw.param("runtime", event.runtimeMsec);
+	qw.param("utime", event.utimeMsec);
+	qw.param("stime", event.stimeMsec);
+	qw.param("maxRSS", event.maxRSSKB);
+	qw.param("restarts", event.restarts);
+	qw.param("restartDelay", event.restartDelayMsec);
+
+	if (!_client->sendQuest(qw.take(), [](FPAnswerPtr, int){}))
+		cout<<"[Error] Report lifecycle of actor "<<event.actor<<" pid "<<event.pid<<" failed."<<endl;
+}
+
 Deployer gc_Deployer;
 
 void updateActorInfos(const std::string& name, const std::string& tmpPath)
@@ -135,6 +175,8 @@ void updateActorInfos(const std::string& name, const std::string& tmpPath)
 
 int main(int argc, const char* argv[])
 {
+	//-- Before any thread created. SIGCHLD is consumed by the actor supervisor's signalfd.
+	ActorLauncher::blockChildSignal();
 	ignoreSignals();
 	ClientEngine::configAnswerCallbackThreadPool(2, 1, 2, 4);
 	ClientEngine::configQuestProcessThreadPool(0, 1, 2, 10, 0);
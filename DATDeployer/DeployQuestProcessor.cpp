@@ -2,14 +2,13 @@
 #include <stdlib.h>
 #include <sys/types.h>
 #include <sys/stat.h>
-#include <sys/sysinfo.h>
 #include <string.h>
 #include <fcntl.h>
-#include <fstream>
 #include <iostream>
 #include "StringUtil.h"
 #include "ClientEngine.h"
 #include "FileSystemUtil.h"
+#include "CommandRunner.h"
 #include "DeployQuestProcessor.h"
 
 using namespace std;
@@ -231,150 +230,145 @@ FPAnswerPtr DeployQuestProcessor::deployActor(const FPReaderPtr args, const FPQu
 
 class SystemCmds: public ITaskThreadPool::ITask
 {
-	size_t _idx;
 	IAsyncAnswerPtr _async;
 	std::vector<std::string> _cmds;
+	int _parallel;
+	int _timeout;
+	int _taskId;
+	QuestSenderPtr _sender;		//-- for streaming outputs. nullptr: outputs are discarded.
 
-public:
-	SystemCmds(IAsyncAnswerPtr async, std::vector<std::string>& cmds): _idx(0), _async(async)
+	void sendOutput(size_t idx, bool errStream, const char* data, size_t len)
 	{
-		_cmds.swap(cmds);
+		FPQWriter qw(4, "systemCmdOutput", true);
+		qw.param("taskId", _taskId);
+		qw.param("idx", idx);
+		qw.param("stream", errStream ? "stderr" : "stdout");
+		qw.paramBinary("data", data, len);
+
+		_sender->sendQuest(qw.take(), [](FPAnswerPtr, int){});
 	}
-	virtual ~SystemCmds()
+
+public:
+	SystemCmds(IAsyncAnswerPtr async, std::vector<std::string>& cmds, int parallel, int timeout, int taskId, QuestSenderPtr sender):
+		_async(async), _parallel(parallel), _timeout(timeout), _taskId(taskId), _sender(sender)
 	{
-		if (_idx == _cmds.size())
-			_async->sendAnswer(FPAWriter(1, _async->getQuest())("ok", true));
-		else
-			_async->sendAnswer(FPAWriter(2, _async->getQuest())("ok", false)("failedLine", _idx));
+		_cmds.swap(cmds);
 	}
 
 	virtual void run()
 	{
-		for (; _idx < _cmds.size(); _idx++)
-			if (system(_cmds[_idx].c_str()) == -1)
-				return;
+		CommandOutputCallback outputCallback;
+		if (_sender)
+			outputCallback = [this](size_t idx, bool errStream, const char* data, size_t len) {
+				sendOutput(idx, errStream, data, len);
+			};
+
+		std::vector<struct CommandResult> results;
+		bool ok = CommandRunner::run(_cmds, _parallel, _timeout, outputCallback, results);
+
+		//-- row: [exitCode, signal, timedOut, costMsec], exitCode is -1 for not started command.
+		size_t failedLine = _cmds.size();
+		std::vector<std::vector<int64_t>> rows;
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const struct CommandResult& result = results[i];
+			if (failedLine == _cmds.size() && (!result.started || result.exitCode != 0 || result.timedOut))
+				failedLine = i;
+
+			rows.push_back(std::vector<int64_t>{ result.exitCode, result.signal, result.timedOut ? 1 : 0, result.costMsec });
+		}
+
+		if (ok)
+			_async->sendAnswer(FPAWriter(2, _async->getQuest())("ok", true)("results", rows));
+		else
+			_async->sendAnswer(FPAWriter(3, _async->getQuest())("ok", false)("failedLine", failedLine)("results", rows));
 	}
 };
 
 FPAnswerPtr DeployQuestProcessor::systemCmd(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
 	std::vector<std::string> cmdLines = args->want("cmdLines", std::vector<std::string>());
-	ClientEngine::wakeUpQuestProcessThreadPool(std::make_shared<SystemCmds>(genAsyncAnswer(quest), cmdLines));
+	int parallel = (int)args->getInt("parallel", 1);
+	int timeout = (int)args->getInt("timeout", 0);
+	int taskId = (int)args->getInt("taskId", 0);
+
+	QuestSenderPtr sender;
+	if (args->getBool("stream", false))
+		sender = genQuestSender(ci);
+
+	ClientEngine::wakeUpQuestProcessThreadPool(std::make_shared<SystemCmds>(genAsyncAnswer(quest), cmdLines, parallel, timeout, taskId, sender));
 	return nullptr;
 }
+
 FPAnswerPtr DeployQuestProcessor::launchActor(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
 	std::string actor = args->wantString("actor");
 	std::string cmdLine = args->getString("cmdLine");
 
-	std::string path = _cachePath + "/" + actor;
+	LaunchOptions options;
+	options.instances = (int)args->getInt("instances", 1);
+	options.cpuSet = args->get("cpuSet", std::vector<int>());
+	options.numaLocal = args->getBool("numaLocal", false);
+	options.perInstanceArgs = args->get("perInstanceArgs", std::vector<std::string>());
+	options.restart = args->getBool("restart", false);
+	options.maxRestarts = (int)args->getInt("maxRestarts", 5);
+	options.isolate = args->getBool("isolate", false);
+	options.limits.cpuQuota = (int)args->getInt("cpuQuota", 0);
+	options.limits.cpuWeight = (int)args->getInt("cpuWeight", 0);
+	options.limits.memoryMax = args->getInt("memoryMax", 0);
+	options.limits.ioMax = args->get("ioMax", std::vector<std::string>());
 
-	if (access(path.c_str(), X_OK) != 0)
-		return FPAWriter(1, quest)("ok", false);
+	std::string path = _cachePath + "/" + actor;
 
-	if (cmdLine.size())
-		path.append(" ").append(cmdLine);
+	if (options.instances > ActorLauncher::maxInstances || access(path.c_str(), X_OK) != 0)
+		return FPAWriter(2, quest)("ok", false)("pids", std::vector<int>());
 
-	path.append(" &");
-	system(path.c_str());
+	std::vector<int> pids;
+	bool ok = _launcher.launch(actor, path, cmdLine, options, pids);
 
-	return FPAWriter(1, quest)("ok", true);
+	return FPAWriter(2, quest)("ok", ok)("pids", pids);
 }
 
 
-int getConnNum(const char *protoLetter)
+FPAnswerPtr DeployQuestProcessor::machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	std::ifstream fin("/proc/net/sockstat");
-	if (fin.is_open()) {
-		char line[1024];
-		while(fin.getline(line, sizeof(line))){
-			if (strncmp(protoLetter, line, 4))
-				continue;
-
-			std::string sLine(line);
-			std::vector<std::string> items;
-			StringUtil::split(sLine, " ", items);
-			if(items.size() > 2)
-			{
-				fin.close();
-				return stoi(items[2]);			// number of inused TCP connections
-			}
-		}
-		fin.close();
-	}
-	return -1;
-}
+	struct MachineSample sample;
+	_collector.sample(sample);
 
-int getTCPConnNum()
-{
-	return getConnNum("TCP:");
-}
+	std::vector<std::vector<std::string>> actorCgroups;
+	_launcher.isolationStatus(actorCgroups);
 
-int getUDPConnNum()
-{
-	return getConnNum("UDP:");
-}
+	std::map<int, std::string> actors;
+	if (_watchActors)
+		_launcher.launchedActors(actors);
 
-float getCPULoad()
-{
-	std::stringstream msgstr;
-	std::ifstream fin("/proc/loadavg");
-	if (fin.is_open()) {
-		char line[1024];
-		fin.getline(line, sizeof(line));
-		std::string sLine(line);
-		std::vector<std::string> items;
-		StringUtil::split(sLine, " ", items);
-		fin.close();
-		try {
-			float res = stof(items[0]);		// load average within 1 miniute
-			return res;
-		} catch(std::exception& e) {
-			LOG_ERROR("failed to convert string to float, the string: %s", items[0].c_str());
-			return -1;
-		}
+	std::vector<std::vector<std::string>> processes;
+	if (actors.size() || _processCollector.watching())
+	{
+		std::vector<struct ProcessSample> samples;
+		_processCollector.sample(actors, samples);
+		processStatusRows(samples, processes);
 	}
-	return -1;			// cannot open the file
+
+	FPAWriter aw(gc_machineSampleFieldCount + 2, quest);
+	writeMachineSample(aw, sample);
+	aw.param("actorCgroups", actorCgroups);
+	aw.param("processes", processes);
+	return aw.take();
 }
 
-void getNetworkStatus(uint64_t& recvBytes, uint64_t& sendBytes)
+FPAnswerPtr DeployQuestProcessor::watchProcesses(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	recvBytes = 0;
-	sendBytes = 0;
-
-	std::ifstream fin("/proc/net/dev");
-	if (fin.is_open())
-	{
-		char line[1024];
-		while(fin.getline(line, sizeof(line)))
-		{
-			std::string sLine(line);
-			std::vector<std::string> items;
-			StringUtil::split(sLine, " ", items);
+	std::set<int> pids = args->get("pids", std::set<int>());
+	std::vector<std::string> names = args->get("names", std::vector<std::string>());
 
-			if (items.empty())
-				continue;
+	_processCollector.setWatchList(pids, names);
+	_watchActors = args->getBool("actors", false);
 
-			if (strncmp("eth", items[0].c_str(), 3) == 0
-				|| strncmp("ens", items[0].c_str(), 3) == 0
-				|| strncmp("eno", items[0].c_str(), 3) == 0
-				|| strncmp("enp", items[0].c_str(), 3) == 0)
-			{
-				recvBytes += std::stoull(items[1]);
-				sendBytes += std::stoull(items[9]);
-			}
-		}
-		fin.close();
-	}
+	return FPAWriter::emptyAnswer(quest);
 }
 
-FPAnswerPtr DeployQuestProcessor::machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+FPAnswerPtr DeployQuestProcessor::burstSample(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	struct sysinfo info;
-	sysinfo(&info);
-
-	uint64_t recvBytes, sendBytes;
-	getNetworkStatus(recvBytes, sendBytes);
-
-	return FPAWriter(6, quest)("sysLoad", getCPULoad())("tcpConn", getTCPConnNum())("udpConn", getUDPConnNum())("freeMemories", info.freeram)("RX", recvBytes)("TX", sendBytes);
-}
\ No newline at end of file
+	return _burstSampler.burstSample(args, quest, genQuestSender(ci));
+}
@@ -1,7 +1,13 @@
 #ifndef DAT_Deployer_Quest_Processor_h
 #define DAT_Deployer_Quest_Processor_h
 
+#include <atomic>
 #include "IQuestProcessor.h"
+#include "ActorLauncher.h"
+#include "ProcCollector.h"
+#include "ProcessCollector.h"
+#include "BurstSampler.h"
+#include "MachineStatusBackfill.h"
 
 using namespace fpnn;
 
@@ -42,11 +48,17 @@ class DeployQuestProcessor: public IQuestProcessor
 	std::string _cachePath;
 	std::string _tmpFileCachePath;
 	UploadInfoPtr _uploadInfos;
+	ActorLauncher _launcher;
+	ProcCollector _collector;
+	ProcessCollector _processCollector;
+	BurstSampler _burstSampler;
+	MachineStatusBackfill _backfill;
+	std::atomic<bool> _watchActors;
 
 	void prepareCachePath(const std::string& cachePath);
 
 public:
-	DeployQuestProcessor(const std::string& cachePath)
+	DeployQuestProcessor(const std::string& cachePath): _watchActors(false)
 	{
 		prepareCachePath(cachePath);
 
@@ -54,6 +66,8 @@ public:
 		registerMethod("systemCmd", &DeployQuestProcessor::systemCmd);
 		registerMethod("launchActor", &DeployQuestProcessor::launchActor);
 		registerMethod("machineStatus", &DeployQuestProcessor::machineStatus);
+		registerMethod("watchProcesses", &DeployQuestProcessor::watchProcesses);
+		registerMethod("burstSample", &DeployQuestProcessor::burstSample);
 		registerMethod("ping", &DeployQuestProcessor::ping);
 
 		_uploadInfos.reset(new UploadInfo());
@@ -63,6 +77,8 @@ public:
 	FPAnswerPtr systemCmd(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr launchActor(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr watchProcesses(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr burstSample(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr ping(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 	{
 		return FPAWriter::emptyAnswer(quest);
@@ -70,6 +86,9 @@ public:
 
 	std::string cachePath() { return _cachePath; }
 	void checkUploadTimeout() { _uploadInfos->checkUploadTimeout(); }
+	bool startSupervisor(ActorLifecycleReporter reporter) { return _launcher.start(reporter); }
+	void recordOfflineStatus() { _backfill.record(_collector); }
+	void backfillMachineStatus(TCPClientPtr client) { _backfill.backfill(client); }
 
 	QuestProcessorClassBasicPublicFuncs
 };
@@ -12,6 +12,14 @@ namespace ErrorInfo
 	const int ActorHostBusyCode = errorBase + 1;
 	const int FileUploadTaskExistCode = errorBase + 2;
 	const int ActorIsNotExistCode = errorBase + 3;
+	const int InvalidTelemetryBatchCode = errorBase + 4;
+	const int BurstSampleTaskNotExistCode = errorBase + 5;
+	const int InjectedErrorCode = errorBase + 6;
+	const int TargetMethodNotExistCode = errorBase + 7;
+	const int InvalidTargetProfileCode = errorBase + 8;
+	const int InvalidSubscriptionCode = errorBase + 9;
+	const int InvalidClientRoleCode = errorBase + 10;
+	const int StatusIngestFullCode = errorBase + 11;
 }
 
 #endif
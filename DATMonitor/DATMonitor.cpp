@@ -1,3 +1,4 @@
+#include <atomic>
 #include <iostream>
 #include <unistd.h>
 #include <sys/sysinfo.h>
@@ -13,8 +14,12 @@ class Monitor
 {
 	TCPClientPtr _client;
 	std::string _region;
+	std::shared_ptr<MonitorQuestProcessor> _processor;
+	std::atomic<bool> _everRegistered;
 
 public:
+	Monitor(): _everRegistered(false) {}
+
 	bool init(int argc, const char* argv[])
 	{
 		if (argc < 2 || argc > 3)
@@ -29,7 +34,8 @@ public:
 		if (!_client)
 			return false;
 
-		_client->setQuestProcessor(std::make_shared<MonitorQuestProcessor>());
+		_processor = std::make_shared<MonitorQuestProcessor>();
+		_client->setQuestProcessor(_processor);
 		return true;
 	}
 
@@ -39,6 +45,10 @@ public:
 		{
 			if (!_client->connected())
 			{
+				//-- Keep sampling while disconnected, backfilled after re-registered.
+				if (_everRegistered)
+					_processor->recordOfflineStatus();
+
 				_client->connect();
 				registerMonitor();
 			}
@@ -57,12 +67,17 @@ public:
 		qw.param("totalMemories", info.totalram);
 
 		TCPClientPtr client = _client;
-		_client->sendQuest(qw.take(), [client](FPAnswerPtr answer, int errorCode){
+		std::shared_ptr<MonitorQuestProcessor> processor = _processor;
+		_client->sendQuest(qw.take(), [this, client, processor](FPAnswerPtr answer, int errorCode){
 			if (errorCode != FPNN_EC_OK)
 			{
 				cout<<"[Error] Register monitor self exception. error code: "<<errorCode<<endl;
 				client->close();
+				return;
 			}
+
+			_everRegistered = true;
+			processor->backfillMachineStatus(client);
 		});
 	}
 };	
@@ -1,103 +1,38 @@
-#include <sys/sysinfo.h>
-#include <string.h>
-#include <fstream>
-#include "StringUtil.h"
+#include <iostream>
 #include "MonitorQuestProcessor.h"
 
 using namespace std;
 
-int getConnNum(const char *protoLetter)
+FPAnswerPtr MonitorQuestProcessor::machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	std::ifstream fin("/proc/net/sockstat");
-	if (fin.is_open()) {
-		char line[1024];
-		while(fin.getline(line, sizeof(line))){
-			if (strncmp(protoLetter, line, 4))
-				continue;
+	struct MachineSample sample;
+	_collector.sample(sample);
 
-			std::string sLine(line);
-			std::vector<std::string> items;
-			StringUtil::split(sLine, " ", items);
-			if(items.size() > 2)
-			{
-				fin.close();
-				return stoi(items[2]);			// number of inused TCP connections
-			}
-		}
-		fin.close();
+	std::vector<std::vector<std::string>> processes;
+	if (_processCollector.watching())
+	{
+		std::vector<struct ProcessSample> samples;
+		_processCollector.sample(std::map<int, std::string>(), samples);
+		processStatusRows(samples, processes);
 	}
-	return -1;
-}
 
-int getTCPConnNum()
-{
-	return getConnNum("TCP:");
+	FPAWriter aw(gc_machineSampleFieldCount + 1, quest);
+	writeMachineSample(aw, sample);
+	aw.param("processes", processes);
+	return aw.take();
 }
 
-int getUDPConnNum()
+//-- Monitor doesn't launch actors, so "actors" is ignored.
+FPAnswerPtr MonitorQuestProcessor::watchProcesses(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	return getConnNum("UDP:");
-}
+	std::set<int> pids = args->get("pids", std::set<int>());
+	std::vector<std::string> names = args->get("names", std::vector<std::string>());
 
-float getCPULoad()
-{
-	std::ifstream fin("/proc/loadavg");
-	if (fin.is_open()) {
-		char line[1024];
-		fin.getline(line, sizeof(line));
-		std::string sLine(line);
-		std::vector<std::string> items;
-		StringUtil::split(sLine, " ", items);
-		fin.close();
-		try {
-			float res = stof(items[0]);		// load average within 1 miniute
-			return res;
-		} catch(std::exception& e) {
-			LOG_ERROR("failed to convert string to float, the string: %s", items[0].c_str());
-			return -1;
-		}
-	}
-	return -1;			// cannot open the file
+	_processCollector.setWatchList(pids, names);
+	return FPAWriter::emptyAnswer(quest);
 }
 
-void getNetworkStatus(uint64_t& recvBytes, uint64_t& sendBytes)
+FPAnswerPtr MonitorQuestProcessor::burstSample(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 {
-	recvBytes = 0;
-	sendBytes = 0;
-
-	std::ifstream fin("/proc/net/dev");
-	if (fin.is_open())
-	{
-		char line[1024];
-		while(fin.getline(line, sizeof(line)))
-		{
-			std::string sLine(line);
-			std::vector<std::string> items;
-			StringUtil::split(sLine, " ", items);
-
-			if (items.empty())
-				continue;
-
-			if (strncmp("eth", items[0].c_str(), 3) == 0
-				|| strncmp("ens", items[0].c_str(), 3) == 0
-				|| strncmp("eno", items[0].c_str(), 3) == 0
-				|| strncmp("enp", items[0].c_str(), 3) == 0)
-			{
-				recvBytes += std::stoull(items[1]);
-				sendBytes += std::stoull(items[9]);
-			}
-		}
-		fin.close();
-	}
+	return _burstSampler.burstSample(args, quest, genQuestSender(ci));
 }
-
-FPAnswerPtr MonitorQuestProcessor::machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
-{
-	struct sysinfo info;
-	sysinfo(&info);
-
-	uint64_t recvBytes, sendBytes;
-	getNetworkStatus(recvBytes, sendBytes);
-
-	return FPAWriter(6, quest)("sysLoad", getCPULoad())("tcpConn", getTCPConnNum())("udpConn", getUDPConnNum())("freeMemories", info.freeram)("RX", recvBytes)("TX", sendBytes);
-}
\ No newline at end of file
@@ -2,6 +2,10 @@
 #define DAT_Monitor_Quest_Processor_h
 
 #include "IQuestProcessor.h"
+#include "ProcCollector.h"
+#include "ProcessCollector.h"
+#include "BurstSampler.h"
+#include "MachineStatusBackfill.h"
 
 using namespace fpnn;
 
@@ -9,19 +13,31 @@ class MonitorQuestProcessor: public IQuestProcessor
 {
 	QuestProcessorClassPrivateFields(MonitorQuestProcessor)
 
+	ProcCollector _collector;
+	ProcessCollector _processCollector;
+	BurstSampler _burstSampler;
+	MachineStatusBackfill _backfill;
+
 public:
 	MonitorQuestProcessor()
 	{
 		registerMethod("machineStatus", &MonitorQuestProcessor::machineStatus);
+		registerMethod("watchProcesses", &MonitorQuestProcessor::watchProcesses);
+		registerMethod("burstSample", &MonitorQuestProcessor::burstSample);
 		registerMethod("ping", &MonitorQuestProcessor::ping);
 	}
 
 	FPAnswerPtr machineStatus(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr watchProcesses(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr burstSample(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
 	FPAnswerPtr ping(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
 	{
 		return FPAWriter::emptyAnswer(quest);
 	}
 
+	void recordOfflineStatus() { _backfill.record(_collector); }
+	void backfillMachineStatus(TCPClientPtr client) { _backfill.backfill(client); }
+
 	QuestProcessorClassBasicPublicFuncs
 };
 
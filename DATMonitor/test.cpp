@@ -1,111 +1,63 @@
 #include <unistd.h>
-#include <sys/sysinfo.h>
-#include <string.h>
-#include <fstream>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 #include <iostream>
-#include "StringUtil.h"
 #include "FormattedPrint.h"
+#include "ProcCollector.h"
 
 using namespace fpnn;
 
-int getConnNum()
+static int64_t cpuUsec()
 {
-	std::ifstream fin("/proc/net/sockstat");
-	if (fin.is_open()) {
-		char line[1024];
-		while(fin.getline(line, sizeof(line))){
-			if (strncmp("TCP:", line, 4))
-				continue;
-
-			std::string sLine(line);
-			std::vector<std::string> items;
-			StringUtil::split(sLine, " ", items);
-			if(items.size() > 2)
-			{
-				fin.close();
-				return stoi(items[2]);			// number of inused TCP connections
-			}
-		}
-		fin.close();
-	}
-	return -1;
-}
-
-float getCPULoad()
-{
-	std::ifstream fin("/proc/loadavg");
-	if (fin.is_open()) {
-		char line[1024];
-		fin.getline(line, sizeof(line));
-		std::string sLine(line);
-		std::vector<std::string> items;
-		StringUtil::split(sLine, " ", items);
-		fin.close();
-		try {
-			float res = stof(items[0]);		// load average within 1 miniute
-			return res;
-		} catch(std::exception& e) {
-			std::cout<<"failed to convert string to float, the string: "<<items[0].c_str()<<std::endl;
-			return -1;
-		}
-	}
-	return -1;			// cannot open the file
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
 }
 
-void getNetworkStatus(uint64_t& recvBytes, uint64_t& sendBytes)
+/*
+	Usage: ./test [sample_interval_msec]
+	Samples at the interval (default: 100 ms), prints every 2 seconds with the collector's own cpu usage.
+*/
+int main(int argc, const char* argv[])
 {
-	recvBytes = 0;
-	sendBytes = 0;
-
-	std::ifstream fin("/proc/net/dev");
-	if (fin.is_open())
-	{
-		char line[1024];
-		while(fin.getline(line, sizeof(line)))
-		{
-			std::string sLine(line);
-			std::vector<std::string> items;
-			StringUtil::split(sLine, " ", items);
-
-			if (items.empty())
-				continue;
+	using namespace std;
 
-			if (strncmp("eth", items[0].c_str(), 3))
-				continue;
+	int intervalMsec = (argc > 1) ? atoi(argv[1]) : 100;
+	if (intervalMsec <= 0)
+		intervalMsec = 100;
 
-			recvBytes += std::stoull(items[1]);
-			sendBytes += std::stoull(items[9]);
-		}
-		fin.close();
-	}
-}
+	const int printSeconds = 2;
+	int samplesPerPrint = printSeconds * 1000 / intervalMsec;
+	if (samplesPerPrint == 0)
+		samplesPerPrint = 1;
 
-int main()
-{
-	using namespace std;
+	ProcCollector collector;
+	struct MachineSample sample;
+	collector.sample(sample);
 
-	int sleepSeconds = 2;
-	uint64_t _RX = 0, _TX = 0;
+	uint64_t _RX = sample.recvBytes, _TX = sample.sendBytes;
 	while (true)
 	{
-		struct sysinfo info;
-		sysinfo(&info);
-
-		uint64_t RX, TX;
-		getNetworkStatus(RX, TX);
+		int64_t cpuBegin = cpuUsec();
+		for (int i = 0; i < samplesPerPrint; i++)
+		{
+			usleep(intervalMsec * 1000);
+			collector.sample(sample);
+		}
+		int64_t cpuCost = cpuUsec() - cpuBegin;
 
-		uint64_t diffRX = (RX - _RX)/sleepSeconds;
-		uint64_t diffTX = (TX - _TX)/sleepSeconds;
+		uint64_t diffRX = (sample.recvBytes - _RX)/printSeconds;
+		uint64_t diffTX = (sample.sendBytes - _TX)/printSeconds;
 
-		_RX = RX;
-		_TX = TX;
+		_RX = sample.recvBytes;
+		_TX = sample.sendBytes;
 
-		cout<<"sys load: "<<getCPULoad()<<", conn: "<<getConnNum()<<", freeMemories: "<<fpnn::formatBytesQuantity(info.freeram);
+		cout<<"sys load: "<<sample.sysLoad<<", tcp: "<<sample.tcpConn<<", udp: "<<sample.udpConn<<", freeMemories: "<<fpnn::formatBytesQuantity(sample.freeMemories);
 		cout<<", RX: "<<fpnn::formatBytesQuantity(diffRX)<<"("<<diffRX<<")";
-		cout<<", TX: "<<fpnn::formatBytesQuantity(diffTX)<<"("<<diffTX<<")"<<endl;
-
-		sleep(sleepSeconds);
+		cout<<", TX: "<<fpnn::formatBytesQuantity(diffTX)<<"("<<diffTX<<")";
+		cout<<", collector cpu: "<<(cpuCost * 100.0 / (printSeconds * 1000000.0))<<"%, "<<(cpuCost / samplesPerPrint)<<" usec/sample"<<endl;
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,127 @@
+#ifndef DAT_Quest_Corpus_h
+#define DAT_Quest_Corpus_h
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+/*
+	Pre-encoded quest corpus file format.
+
+	All integers are in native byte order: corpus files are built and replayed on the same architecture.
+
+	+------------------------+
+	| CorpusFileHeader       |
+	+------------------------+
+	| payloads (msgpack)     |  <- record payloadOffset
+	+------------------------+
+	| string pool            |  <- record methodOffset, slot name offset
+	+------------------------+
+	| CorpusRecordIndex[]    |  <- header.recordIndexOffset
+	+------------------------+
+	| CorpusSlot[]           |  <- header.slotOffset
+	+------------------------+
+	| CorpusSlotName[]       |  <- header.slotNameOffset
+	+------------------------+
+
+	Slot is a top-level payload field which encoded in fixed width, so it can be patched in place per send.
+*/
+
+namespace QuestCorpusFormat
+{
+	const char magic[8] = {'D', 'A', 'T', 'Q', 'C', 'R', 'P', '1'};
+	const uint32_t version = 1;
+
+	enum SlotType
+	{
+		IntSlot = 1,			//-- msgpack int 64: 0xd3 + 8 bytes big endian
+		DoubleSlot = 2,			//-- msgpack float 64: 0xcb + 8 bytes big endian
+		StringSlot = 3,			//-- msgpack str 8: 0xd9 + 1 byte length + fixed width body, right-padded with spaces
+	};
+
+	struct CorpusFileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t recordCount;
+		uint32_t slotCount;
+		uint32_t slotNameCount;
+		uint64_t recordIndexOffset;
+		uint64_t slotOffset;
+		uint64_t slotNameOffset;
+		uint64_t totalWeight;
+	};
+
+	struct CorpusRecordIndex
+	{
+		uint64_t payloadOffset;
+		uint64_t methodOffset;
+		uint32_t payloadLength;
+		uint32_t methodLength;
+		uint32_t weight;
+		uint32_t slotBegin;
+		uint32_t slotCount;
+		uint32_t reserved;
+	};
+
+	struct CorpusSlot
+	{
+		uint32_t payloadPos;		//-- position of the value marker byte in record payload.
+		uint16_t nameIdx;
+		uint8_t type;
+		uint8_t width;				//-- string body width. Unused for numeric slots.
+	};
+
+	struct CorpusSlotName
+	{
+		uint64_t offset;
+		uint32_t length;
+		uint32_t reserved;
+	};
+
+	inline void writeBigEndian64(char* dest, uint64_t value)
+	{
+		for (int i = 7; i >= 0; i--)
+		{
+			dest[i] = (char)(value & 0xFF);
+			value >>= 8;
+		}
+	}
+
+	//-- Encoded length of a slot value, including the msgpack marker.
+	inline size_t slotEncodedLength(uint8_t type, uint8_t width)
+	{
+		if (type == StringSlot)
+			return 2 + width;
+
+		return 9;
+	}
+
+	inline void encodeIntSlot(char* pos, int64_t value)
+	{
+		pos[0] = (char)0xd3;
+		writeBigEndian64(pos + 1, (uint64_t)value);
+	}
+
+	inline void encodeDoubleSlot(char* pos, double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		pos[0] = (char)0xcb;
+		writeBigEndian64(pos + 1, bits);
+	}
+
+	inline void encodeStringSlot(char* pos, uint8_t width, const char* value, size_t length)
+	{
+		if (length > width)
+			length = width;
+
+		pos[0] = (char)0xd9;
+		pos[1] = (char)width;
+		memcpy(pos + 2, value, length);
+		memset(pos + 2 + length, ' ', width - length);
+	}
+}
+
+#endif
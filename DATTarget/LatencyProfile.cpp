@@ -0,0 +1,142 @@
+#include <cmath>
+#include <iostream>
+#include "Setting.h"
+#include "LatencyProfile.h"
+
+using namespace std;
+
+bool LatencyProfile::parseDistribution(const std::string& name, Distribution& distribution)
+{
+	if (name == "fixed")
+		distribution = Fixed;
+	else if (name == "lognormal")
+		distribution = Lognormal;
+	else if (name == "bimodal")
+		distribution = Bimodal;
+	else
+		return false;
+
+	return true;
+}
+
+std::string LatencyProfile::distributionName() const
+{
+	switch (distribution)
+	{
+		case Lognormal: return "lognormal";
+		case Bimodal: return "bimodal";
+		default: return "fixed";
+	}
+}
+
+bool LatencyProfile::load(const std::string& name)
+{
+	std::string prefix("DATTarget.method.");
+	prefix.append(name).append(".");
+
+	std::string latency = Setting::getString(prefix + "latency", distributionName());
+	if (!parseDistribution(latency, distribution))
+	{
+		cout<<"[Error] Unknown latency distribution "<<latency<<" of method "<<name<<endl;
+		return false;
+	}
+
+	fixedMsec = Setting::getReal(prefix + "fixedMsec", fixedMsec);
+	medianMsec = Setting::getReal(prefix + "medianMsec", medianMsec);
+	sigma = Setting::getReal(prefix + "sigma", sigma);
+	fastMsec = Setting::getReal(prefix + "fastMsec", fastMsec);
+	slowMsec = Setting::getReal(prefix + "slowMsec", slowMsec);
+	slowRatio = Setting::getReal(prefix + "slowRatio", slowRatio);
+	stallPeriodSec = (int)Setting::getInt(prefix + "stallPeriodSec", stallPeriodSec);
+	stallMsec = (int)Setting::getInt(prefix + "stallMsec", stallMsec);
+	errorRate = Setting::getReal(prefix + "errorRate", errorRate);
+	errorCode = (int)Setting::getInt(prefix + "errorCode", errorCode);
+	payloadBytes = (int)Setting::getInt(prefix + "payloadBytes", payloadBytes);
+
+	std::string reason;
+	if (!validate(reason))
+	{
+		cout<<"[Error] Invalid latency profile of method "<<name<<": "<<reason<<endl;
+		return false;
+	}
+	return true;
+}
+
+bool LatencyProfile::update(const FPReaderPtr args, std::string& reason)
+{
+	std::string latency = args->getString("latency", distributionName());
+	if (!parseDistribution(latency, distribution))
+	{
+		reason = "Unknown latency distribution.";
+		return false;
+	}
+
+	fixedMsec = args->getDouble("fixedMsec", fixedMsec);
+	medianMsec = args->getDouble("medianMsec", medianMsec);
+	sigma = args->getDouble("sigma", sigma);
+	fastMsec = args->getDouble("fastMsec", fastMsec);
+	slowMsec = args->getDouble("slowMsec", slowMsec);
+	slowRatio = args->getDouble("slowRatio", slowRatio);
+	stallPeriodSec = (int)args->getInt("stallPeriodSec", stallPeriodSec);
+	stallMsec = (int)args->getInt("stallMsec", stallMsec);
+	errorRate = args->getDouble("errorRate", errorRate);
+	errorCode = (int)args->getInt("errorCode", errorCode);
+	payloadBytes = (int)args->getInt("payloadBytes", payloadBytes);
+	return validate(reason);
+}
+
+//-- Negated comparisons also reject NaN.
+bool LatencyProfile::validate(std::string& reason) const
+{
+	if (!(errorRate >= 0 && errorRate <= 1))
+		reason = "errorRate must be in [0, 1].";
+	else if (!(slowRatio >= 0 && slowRatio <= 1))
+		reason = "slowRatio must be in [0, 1].";
+	else if (distribution == Lognormal && !(sigma > 0))
+		reason = "sigma must be positive.";
+	else if (payloadBytes < 0)
+		reason = "payloadBytes must not be negative.";
+	else if (stallPeriodSec < 0 || stallMsec < 0)
+		reason = "stallPeriodSec & stallMsec must not be negative.";
+	else
+		return true;
+
+	return false;
+}
+
+int64_t LatencyProfile::sampleUsec(std::mt19937_64& random) const
+{
+	double msec = fixedMsec;
+	if (distribution == Lognormal)
+	{
+		std::lognormal_distribution<double> lognormal(std::log(medianMsec > 0 ? medianMsec : 0.001), sigma);
+		msec = lognormal(random);
+	}
+	else if (distribution == Bimodal)
+	{
+		std::bernoulli_distribution slow(slowRatio);
+		msec = slow(random) ? slowMsec : fastMsec;
+	}
+
+	return (msec > 0) ? (int64_t)(msec * 1000) : 0;
+}
+
+int64_t LatencyProfile::stallUsec(int64_t sinceStartUsec) const
+{
+	if (stallPeriodSec <= 0 || stallMsec <= 0)
+		return 0;
+
+	int64_t periodUsec = (int64_t)stallPeriodSec * 1000000;
+	int64_t offset = sinceStartUsec % periodUsec;
+	int64_t stall = (int64_t)stallMsec * 1000;
+	return (offset < stall) ? stall - offset : 0;
+}
+
+bool LatencyProfile::sampleError(std::mt19937_64& random) const
+{
+	if (errorRate <= 0)
+		return false;
+
+	std::bernoulli_distribution error(errorRate);
+	return error(random);
+}
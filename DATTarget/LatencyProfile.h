@@ -0,0 +1,64 @@
+#ifndef DAT_Latency_Profile_h
+#define DAT_Latency_Profile_h
+
+#include <random>
+#include <string>
+#include "FPReader.h"
+#include "../DATErrorInfo.h"
+
+using namespace fpnn;
+
+/*
+	Injected behaviour of a DATTarget method.
+
+	latency:
+		fixed:      fixedMsec.
+		lognormal:  median medianMsec, shape sigma.
+		bimodal:    fastMsec, or slowMsec with probability slowRatio.
+	Scheduled stalls: every stallPeriodSec, the method stalls stallMsec, quests arrived in a stall wait until it ends,
+	as a GC pause or a blocked disk does. Stalls are aligned to server start.
+	errorRate: probability to answer errorCode, after the latency.
+	payloadBytes: size of the binary payload in answer.
+*/
+struct LatencyProfile
+{
+	enum Distribution
+	{
+		Fixed,
+		Lognormal,
+		Bimodal,
+	};
+
+	Distribution distribution;
+	double fixedMsec;
+	double medianMsec;
+	double sigma;
+	double fastMsec;
+	double slowMsec;
+	double slowRatio;
+	int stallPeriodSec;
+	int stallMsec;
+	double errorRate;
+	int errorCode;
+	int payloadBytes;
+
+	LatencyProfile(): distribution(Fixed), fixedMsec(0), medianMsec(1), sigma(0.5), fastMsec(1), slowMsec(100), slowRatio(0.01),
+		stallPeriodSec(0), stallMsec(0), errorRate(0), errorCode(ErrorInfo::InjectedErrorCode), payloadBytes(64) {}
+
+	//-- Keys: DATTarget.method.<name>.<field>, absent fields keep current values.
+	bool load(const std::string& name);
+	//-- Same fields in quest, absent fields keep current values. reason is set when failed.
+	bool update(const FPReaderPtr args, std::string& reason);
+	//-- errorRate & slowRatio in [0, 1], sigma > 0 for lognormal, payloadBytes & stalls not negative.
+	bool validate(std::string& reason) const;
+
+	//-- Sampled latency, and the remained stall at sinceStartUsec.
+	int64_t sampleUsec(std::mt19937_64& random) const;
+	int64_t stallUsec(int64_t sinceStartUsec) const;
+	bool sampleError(std::mt19937_64& random) const;
+
+	std::string distributionName() const;
+	static bool parseDistribution(const std::string& name, Distribution& distribution);
+};
+
+#endif
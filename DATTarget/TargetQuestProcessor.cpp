@@ -0,0 +1,230 @@
+#include <time.h>
+#include <chrono>
+#include <iostream>
+#include "Setting.h"
+#include "TargetQuestProcessor.h"
+
+using namespace std;
+
+static int64_t monotonicUsec()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static std::mt19937_64& threadRandom()
+{
+	thread_local std::mt19937_64 random(std::random_device{}());
+	return random;
+}
+
+TargetQuestProcessor::TargetQuestProcessor(): _running(true), _startUsec(monotonicUsec())
+{
+	std::vector<std::string> methods = Setting::getStringList("DATTarget.methods", std::vector<std::string>{"echo"});
+	for (auto& name: methods)
+	{
+		std::unique_ptr<TargetMethod> method(new TargetMethod);
+		if (!method->profile.load(name))
+			continue;
+
+		_methods[name] = std::move(method);
+		registerMethod(name, &TargetQuestProcessor::serve);
+	}
+
+	registerMethod("targetStats", &TargetQuestProcessor::targetStats);
+	registerMethod("configureMethod", &TargetQuestProcessor::configureMethod);
+
+	_answerThread = std::thread(&TargetQuestProcessor::answerCycle, this);
+}
+
+TargetQuestProcessor::~TargetQuestProcessor()
+{
+	{
+		std::unique_lock<std::mutex> lck(_delayMutex);
+		_running = false;
+	}
+	_delayCond.notify_one();
+	_answerThread.join();
+}
+
+FPAnswerPtr TargetQuestProcessor::buildAnswer(const FPQuestPtr quest, const LatencyProfile& profile, int64_t delayUsec)
+{
+	if (profile.payloadBytes <= 0)
+	{
+		FPAWriter aw(1, quest);
+		aw.param("injectedUsec", delayUsec);
+		return aw.take();
+	}
+
+	std::string payload(profile.payloadBytes, 'x');
+
+	FPAWriter aw(2, quest);
+	aw.param("injectedUsec", delayUsec);
+	aw.paramBinary("payload", payload.data(), payload.size());
+	return aw.take();
+}
+
+FPAnswerPtr TargetQuestProcessor::serve(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	int64_t receivedUsec = monotonicUsec();
+
+	auto iter = _methods.find(quest->method());
+	if (iter == _methods.end())
+		return FPAWriter::errorAnswer(quest, ErrorInfo::TargetMethodNotExistCode, "Method is not configured.", "DATTarget");
+
+	TargetMethod* method = iter->second.get();
+	LatencyProfile profile;
+	{
+		std::unique_lock<std::mutex> lck(_mutex);
+		profile = method->profile;
+	}
+
+	std::mt19937_64& random = threadRandom();
+	int64_t delayUsec = profile.stallUsec(receivedUsec - _startUsec) + profile.sampleUsec(random);
+	bool failed = profile.sampleError(random);
+
+	if (failed)
+		method->errors++;
+	method->injected.record(delayUsec);
+
+	if (quest->isOneWay())
+		return nullptr;
+
+	FPAnswerPtr answer = failed ? FPAWriter::errorAnswer(quest, profile.errorCode, "Injected error.", "DATTarget")
+		: buildAnswer(quest, profile, delayUsec);
+
+	if (delayUsec == 0)
+	{
+		method->served.record(monotonicUsec() - receivedUsec);
+		return answer;
+	}
+
+	DelayedAnswer delayed;
+	delayed.dueUsec = receivedUsec + delayUsec;
+	delayed.receivedUsec = receivedUsec;
+	delayed.async = genAsyncAnswer(quest);
+	delayed.answer = answer;
+	delayed.method = method;
+
+	bool earliest;
+	{
+		std::unique_lock<std::mutex> lck(_delayMutex);
+		_delayedAnswers.push(delayed);
+		earliest = (_delayedAnswers.top().dueUsec == delayed.dueUsec);
+	}
+	if (earliest)
+		_delayCond.notify_one();
+
+	return nullptr;
+}
+
+//-- Worker threads never sleep for the injected latency, so the latency is independent of the server thread pool size.
+void TargetQuestProcessor::answerCycle()
+{
+	std::vector<DelayedAnswer> dueAnswers;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lck(_delayMutex);
+			while (_running)
+			{
+				if (_delayedAnswers.empty())
+				{
+					_delayCond.wait(lck);
+					continue;
+				}
+
+				int64_t waitUsec = _delayedAnswers.top().dueUsec - monotonicUsec();
+				if (waitUsec <= 0)
+					break;
+
+				_delayCond.wait_for(lck, std::chrono::microseconds(waitUsec));
+			}
+
+			if (!_running)
+				return;
+
+			int64_t now = monotonicUsec();
+			while (_delayedAnswers.size() && _delayedAnswers.top().dueUsec <= now)
+			{
+				dueAnswers.push_back(_delayedAnswers.top());
+				_delayedAnswers.pop();
+			}
+		}
+
+		for (auto& delayed: dueAnswers)
+		{
+			delayed.async->sendAnswer(delayed.answer);
+			delayed.method->served.record(monotonicUsec() - delayed.receivedUsec);
+		}
+		dueAnswers.clear();
+	}
+}
+
+FPAnswerPtr TargetQuestProcessor::targetStats(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	bool reset = args->getBool("reset", false);
+
+	std::vector<std::string> fields{"method", "latency", "errorRate", "payloadBytes", "errors"};
+	std::vector<std::string> injectedFields = LatencyHistogram::fields("injected.");
+	std::vector<std::string> servedFields = LatencyHistogram::fields("served.");
+	fields.insert(fields.end(), injectedFields.begin(), injectedFields.end());
+	fields.insert(fields.end(), servedFields.begin(), servedFields.end());
+
+	std::vector<std::vector<std::string>> rows;
+	for (auto& pp: _methods)
+	{
+		TargetMethod* method = pp.second.get();
+		LatencyProfile profile;
+		{
+			std::unique_lock<std::mutex> lck(_mutex);
+			profile = method->profile;
+		}
+
+		std::vector<std::string> row{pp.first, profile.distributionName(), std::to_string(profile.errorRate),
+			std::to_string(profile.payloadBytes), std::to_string(method->errors.load())};
+
+		if (reset)
+		{
+			LatencyHistogram injected, served;
+			method->injected.drainTo(injected);
+			method->served.drainTo(served);
+			method->errors = 0;
+
+			injected.appendRow(row);
+			served.appendRow(row);
+		}
+		else
+		{
+			method->injected.appendRow(row);
+			method->served.appendRow(row);
+		}
+
+		rows.push_back(row);
+	}
+
+	FPAWriter aw(3, quest);
+	aw.param("uptimeSec", (monotonicUsec() - _startUsec) / 1000000);
+	aw.param("fields", fields);
+	aw.param("rows", rows);
+	return aw.take();
+}
+
+FPAnswerPtr TargetQuestProcessor::configureMethod(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci)
+{
+	std::string name = args->wantString("method");
+
+	auto iter = _methods.find(name);
+	if (iter == _methods.end())
+		return FPAWriter::errorAnswer(quest, ErrorInfo::TargetMethodNotExistCode, "Method is not configured.", "DATTarget");
+
+	std::unique_lock<std::mutex> lck(_mutex);
+	LatencyProfile profile = iter->second->profile;
+	std::string reason;
+	if (!profile.update(args, reason))
+		return FPAWriter::errorAnswer(quest, ErrorInfo::InvalidTargetProfileCode, reason, "DATTarget");
+
+	iter->second->profile = profile;
+	return FPAWriter::emptyAnswer(quest);
+}
@@ -0,0 +1,71 @@
+#ifndef DAT_Target_Quest_Processor_h
+#define DAT_Target_Quest_Processor_h
+
+#include <map>
+#include <queue>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <condition_variable>
+#include "IQuestProcessor.h"
+#include "LatencyHistogram.h"
+#include "LatencyProfile.h"
+
+using namespace fpnn;
+
+struct TargetMethod
+{
+	LatencyProfile profile;				//-- guarded by TargetQuestProcessor::_mutex
+	std::atomic<uint64_t> errors;
+	LatencyHistogram injected;			//-- sampled latency & stall, the ground truth.
+	LatencyHistogram served;			//-- quest received to answer sent, in server side.
+
+	TargetMethod(): errors(0) {}
+};
+
+struct DelayedAnswer
+{
+	int64_t dueUsec;
+	int64_t receivedUsec;
+	IAsyncAnswerPtr async;
+	FPAnswerPtr answer;
+	TargetMethod* method;
+
+	bool operator> (const struct DelayedAnswer& r) const
+	{
+		return dueUsec > r.dueUsec;
+	}
+};
+
+class TargetQuestProcessor: public IQuestProcessor
+{
+	QuestProcessorClassPrivateFields(TargetQuestProcessor)
+
+	bool _running;
+	int64_t _startUsec;
+	std::mutex _mutex;
+	std::map<std::string, std::unique_ptr<TargetMethod>> _methods;		//-- fixed after constructor.
+
+	std::mutex _delayMutex;
+	std::condition_variable _delayCond;
+	std::priority_queue<DelayedAnswer, std::vector<DelayedAnswer>, std::greater<DelayedAnswer>> _delayedAnswers;
+	std::thread _answerThread;
+
+	FPAnswerPtr buildAnswer(const FPQuestPtr quest, const LatencyProfile& profile, int64_t delayUsec);
+	void answerCycle();
+
+public:
+	TargetQuestProcessor();
+	~TargetQuestProcessor();
+
+	//-- All configured methods.
+	FPAnswerPtr serve(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+
+	FPAnswerPtr targetStats(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+	FPAnswerPtr configureMethod(const FPReaderPtr args, const FPQuestPtr quest, const ConnectionInfo& ci);
+
+	QuestProcessorClassBasicPublicFuncs
+};
+
+#endif